@@ -0,0 +1,337 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: fpu.c
+    Description: FPU/SIMD register state management for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/fpu.h"
+#include "includes/io.h"
+#include "includes/isr.h"
+#include "kernel/system/includes/percpu.h"
+#include "kernel/sched/includes/sched.h"
+#include "tools/includes/log-info.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#define FPU_NM_VECTOR 7     // device not available
+
+typedef struct {
+    fpu_ctx_t *owner;       // whose state the registers hold, NULL for nobody's
+    fpu_ctx_t *current;     // the running task's
+    bool ts;                // CR0.TS as last set
+    bool in_kernel;         // between kernel_fpu_begin() and kernel_fpu_end()
+    bool in_irq;            // between fpu_irq_enter() and fpu_irq_exit()
+    bool irq_ts;            // TS when the interrupt came
+    uint8_t *irq_area;      // where fpu_irq_enter() parks live registers
+    uint64_t traps;         // #NM taken
+    uint64_t restores;
+    uint64_t saves;
+    uint64_t skipped;       // switches out with nothing to save
+    uint64_t kernel_uses;
+    uint64_t irq_parks;
+} fpu_cpu_t;
+
+static fpu_cpu_t fpu_cpus[SMP_MAX_CPUS];
+static fpu_mode_t fpu_mode = FPU_MODE_FXSAVE;
+static uint64_t fpu_xcr0;
+static size_t fpu_size = FPU_FXSAVE_SIZE;
+
+static const char *fpu_mode_names[] = { "FXSAVE", "XSAVE", "XSAVEOPT", "XSAVES" };
+
+static inline uint64_t fpu_read_cr0(void) {
+    uint64_t cr0;
+    __asm__ volatile("mov %%cr0, %0" : "=r"(cr0));
+    return cr0;
+}
+
+static inline void fpu_write_cr0(uint64_t cr0) {
+    __asm__ volatile("mov %0, %%cr0" : : "r"(cr0) : "memory");
+}
+
+static inline uint64_t fpu_read_cr4(void) {
+    uint64_t cr4;
+    __asm__ volatile("mov %%cr4, %0" : "=r"(cr4));
+    return cr4;
+}
+
+static inline void fpu_write_cr4(uint64_t cr4) {
+    __asm__ volatile("mov %0, %%cr4" : : "r"(cr4) : "memory");
+}
+
+static inline void fpu_xsetbv(uint32_t reg, uint64_t value) {
+    __asm__ volatile("xsetbv" : : "c"(reg), "a"((uint32_t)value), "d"((uint32_t)(value >> 32)));
+}
+
+// CR0 writes serialise, so only touch it when TS actually changes
+static inline void fpu_set_ts(fpu_cpu_t *fc, bool ts) {
+    if (fc->ts == ts)
+        return;
+    if (ts)
+        fpu_write_cr0(fpu_read_cr0() | CR0_TS);
+    else
+        __asm__ volatile("clts" : : : "memory");
+    fc->ts = ts;
+}
+
+// The first FPU or vector instruction since the switch in. Whoever the
+// registers belonged to was saved when it was switched out, so this only
+// loads the running task's state. In an interrupt handler they are the
+// handler's, and stop being anybody else's
+static void fpu_nm_trap(Registers_t *regs) {
+    (void)regs;
+    uint32_t id = smp_cpu_id();
+    fpu_cpu_t *fc = &fpu_cpus[id];
+    fpu_ctx_t *ctx = fc->current;
+
+    fpu_set_ts(fc, false);
+    fc->traps++;
+    if (fc->in_irq) {
+        fc->owner = NULL;
+        fpu_load_defaults();
+        return;
+    }
+    if (ctx == NULL || (fc->owner == ctx && ctx->last_cpu == id))
+        return;
+
+    fpu_area_restore(ctx->area, fpu_mode, fpu_xcr0);
+    ctx->restores++;
+    ctx->last_cpu = id;
+    fc->owner = ctx;
+    fc->restores++;
+}
+
+static void fpu_irq_area_alloc(fpu_cpu_t *fc) {
+    if (fc->irq_area != NULL)
+        return;
+
+    void *alloc = malloc(fpu_size + FPU_AREA_ALIGN - 1);
+    if (alloc == NULL) {
+        LOG_WARN("No memory to park FPU state in interrupts on CPU %u\n", smp_cpu_id());
+        SERIAL(Warn, fpu_irq_area_alloc, "No memory to park FPU state in interrupts on CPU %u\n", smp_cpu_id());
+        return;
+    }
+    fc->irq_area = (uint8_t *)(((uint64_t)alloc + FPU_AREA_ALIGN - 1) & ~(uint64_t)(FPU_AREA_ALIGN - 1));
+}
+
+void fpu_init_cpu(void) {
+    fpu_write_cr0((fpu_read_cr0() & ~(CR0_EM | CR0_TS)) | CR0_MP | CR0_NE);
+
+    uint64_t cr4 = fpu_read_cr4() | CR4_OSFXSR | CR4_OSXMMEXCPT;
+    if (fpu_mode != FPU_MODE_FXSAVE)
+        cr4 |= CR4_OSXSAVE;
+    fpu_write_cr4(cr4);
+
+    if (fpu_mode != FPU_MODE_FXSAVE)
+        fpu_xsetbv(0, fpu_xcr0);
+    if (fpu_mode == FPU_MODE_XSAVES)
+        __asm__ volatile("wrmsr" : : "c"(MSR_IA32_XSS), "a"(0), "d"(0));   // no supervisor state
+
+    fpu_load_defaults();
+    fpu_cpus[smp_cpu_id()].ts = false;
+
+    // the BSP's is allocated by fpu_init() once the size is known
+    if (fpu_cpus[0].irq_area != NULL)
+        fpu_irq_area_alloc(&fpu_cpus[smp_cpu_id()]);
+}
+
+void fpu_init(void) {
+    uint32_t eax, ebx, ecx, edx;
+
+    cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+    if (ecx & (1 << 26)) {
+        cpuid(0xD, 0, &eax, &ebx, &ecx, &edx);
+        uint64_t supported = ((uint64_t)edx << 32) | eax;
+
+        fpu_xcr0 = supported & (XFEATURE_X87 | XFEATURE_SSE | XFEATURE_AVX);
+        if ((supported & XFEATURE_AVX512) == XFEATURE_AVX512 && (fpu_xcr0 & XFEATURE_AVX))
+            fpu_xcr0 |= XFEATURE_AVX512;
+
+        cpuid(0xD, 1, &eax, &ebx, &ecx, &edx);
+        if (eax & (1 << 3))
+            fpu_mode = FPU_MODE_XSAVES;
+        else if (eax & (1 << 0))
+            fpu_mode = FPU_MODE_XSAVEOPT;
+        else
+            fpu_mode = FPU_MODE_XSAVE;
+    }
+    fpu_init_cpu();
+
+    // the sizes CPUID reports follow what XCR0 (and IA32_XSS) enable
+    if (fpu_mode == FPU_MODE_XSAVES) {
+        cpuid(0xD, 1, &eax, &ebx, &ecx, &edx);
+        fpu_size = ebx;
+    } else if (fpu_mode != FPU_MODE_FXSAVE) {
+        cpuid(0xD, 0, &eax, &ebx, &ecx, &edx);
+        fpu_size = ebx;
+    }
+
+    fpu_irq_area_alloc(&fpu_cpus[smp_cpu_id()]);
+    ISR_RegisterHandler(FPU_NM_VECTOR, fpu_nm_trap);
+
+    LOG_INFO("FPU state saved with %s, %lu byte areas, XCR0 0x%lx\n",
+             fpu_mode_names[fpu_mode], fpu_size, fpu_xcr0);
+    SERIAL(Info, fpu_init, "FPU state saved with %s, %lu byte areas, XCR0 0x%lx\n",
+           fpu_mode_names[fpu_mode], fpu_size, fpu_xcr0);
+}
+
+int8_t fpu_ctx_init(fpu_ctx_t *ctx) {
+    ctx->alloc = malloc(fpu_size + FPU_AREA_ALIGN - 1);
+    if (ctx->alloc == NULL)
+        return -1;
+
+    ctx->area = (uint8_t *)(((uint64_t)ctx->alloc + FPU_AREA_ALIGN - 1) & ~(uint64_t)(FPU_AREA_ALIGN - 1));
+    fpu_area_reset(ctx->area, fpu_size, fpu_mode, fpu_xcr0);
+    ctx->last_cpu = FPU_NO_CPU;     // also stops a stale owner pointer matching a reused address
+    ctx->saves = ctx->restores = 0;
+    return 0;
+}
+
+void fpu_ctx_free(fpu_ctx_t *ctx) {
+    free(ctx->alloc);
+    ctx->alloc = NULL;
+    ctx->area = NULL;
+}
+
+void fpu_adopt(fpu_ctx_t *ctx) {
+    uint64_t flags = irq_save();
+    uint32_t id = smp_cpu_id();
+    fpu_cpu_t *fc = &fpu_cpus[id];
+
+    fc->owner = fc->current = ctx;
+    ctx->last_cpu = id;
+    fpu_set_ts(fc, false);
+    irq_restore(flags);
+}
+
+// A task that still has TS set at switch out never touched the FPU, its area
+// is already up to date. If the next task's state is still loaded here
+// nothing ran FPU code in between and it can have the registers back as is
+void fpu_switch(fpu_ctx_t *prev, fpu_ctx_t *next) {
+    uint32_t id = smp_cpu_id();
+    fpu_cpu_t *fc = &fpu_cpus[id];
+
+    if (fc->owner == prev && !fc->ts) {
+        fpu_area_save(prev->area, fpu_mode, fpu_xcr0);
+        prev->saves++;
+        fc->saves++;
+    } else {
+        fc->skipped++;
+    }
+
+    fc->current = next;
+    fpu_set_ts(fc, !(fc->owner == next && next->last_cpu == id));
+}
+
+// Saves what the running task has in the registers and hands them over
+// clean. Preemption stays off until kernel_fpu_end(), nothing may sleep in
+// between
+void kernel_fpu_begin(void) {
+    preempt_disable();
+    uint64_t flags = irq_save();
+    uint32_t id = smp_cpu_id();
+    fpu_cpu_t *fc = &fpu_cpus[id];
+
+    if (fc->owner != NULL && fc->owner == fc->current && !fc->ts) {
+        fpu_area_save(fc->owner->area, fpu_mode, fpu_xcr0);
+        fc->owner->saves++;
+        fc->saves++;
+    }
+    fc->owner = NULL;
+    fc->in_kernel = true;
+    fc->kernel_uses++;
+    fpu_set_ts(fc, false);
+    fpu_load_defaults();
+    irq_restore(flags);
+}
+
+// the task gets its state back through #NM, only if it needs it
+void kernel_fpu_end(void) {
+    uint64_t flags = irq_save();
+    fpu_cpu_t *fc = &fpu_cpus[smp_cpu_id()];
+
+    fc->in_kernel = false;
+    fpu_set_ts(fc, true);
+    irq_restore(flags);
+    preempt_enable();
+}
+
+bool kernel_fpu_usable(void) {
+    return !fpu_cpus[smp_cpu_id()].in_kernel;
+}
+
+// Interrupt gates keep IF clear while a handler runs, so these never nest
+// and one area per CPU is enough. Live registers (TS clear) hold the
+// interrupted task's state or a kernel_fpu_begin() section's, both parked
+// here. Under TS nothing is done until the handler traps, see fpu_nm_trap()
+bool fpu_irq_enter(void) {
+    fpu_cpu_t *fc = &fpu_cpus[smp_cpu_id()];
+
+    fc->in_irq = true;
+    fc->irq_ts = fc->ts;
+    if (fc->ts || fc->irq_area == NULL)
+        return false;
+
+    fpu_irq_park(fc->irq_area, fpu_mode, fpu_xcr0);
+    fc->irq_parks++;
+    return true;
+}
+
+// TS goes back on if it was, so the task's next use reloads its area over
+// whatever the handler left
+void fpu_irq_exit(bool parked) {
+    fpu_cpu_t *fc = &fpu_cpus[smp_cpu_id()];
+
+    if (parked)
+        fpu_irq_unpark(fc->irq_area, fpu_mode, fpu_xcr0);
+    else if (fc->irq_ts)
+        fpu_set_ts(fc, true);
+    fc->in_irq = false;
+}
+
+size_t fpu_area_size(void) {
+    return fpu_size;
+}
+
+void fpu_print_stats(void) {
+    printf("%s, %lu byte areas, XCR0 0x%lx\n", fpu_mode_names[fpu_mode], fpu_size, fpu_xcr0);
+    printf("cpu  #NM traps   restores      saves    skipped  kernel uses  irq parks\n");
+    for (uint32_t id = 0; id < SMP_MAX_CPUS; id++) {
+        fpu_cpu_t *fc = &fpu_cpus[id];
+        if (fc->current == NULL && fc->traps == 0 && fc->kernel_uses == 0 && fc->irq_parks == 0)
+            continue;
+        printf("%3u  %9lu  %9lu  %9lu  %9lu  %11lu  %9lu\n", id, fc->traps, fc->restores, fc->saves,
+               fc->skipped, fc->kernel_uses, fc->irq_parks);
+    }
+}
@@ -43,6 +43,7 @@
 #include <stdint.h>
 #include "arch/x86_64/includes/io.h"
 #include "tools/includes/log-info.h"
+#include <string.h>
 
 
 
@@ -71,7 +72,7 @@ typedef enum{
     GDT_ACCESS_DATA_SEGMENT                 = 0x10,
     GDT_ACCESS_CODE_SEGMENT                 = 0x18,
 
-    GDT_ACCESS_DESCRIPTOR_TSS               = 0x00,
+    GDT_ACCESS_DESCRIPTOR_TSS               = 0x09,     // available 64-bit TSS
 
     GDT_ACCESS_RING0                        = 0x00,
     GDT_ACCESS_RING1                        = 0x20,
@@ -187,4 +188,24 @@ void GDT_Initialize() {
         halt();
         
     }
-}
\ No newline at end of file
+}
+
+void GDT_InitializeCPU(GDT_CPU_t *gdt, uint64_t kernel_stack) {
+    uint64_t base = (uint64_t)&gdt->TSS;
+    uint32_t limit = sizeof(TSS_t) - 1;
+
+    memset(gdt, 0, sizeof(*gdt));
+    memcpy(gdt->Entries, g_GDT, sizeof(g_GDT));
+
+    gdt->TSS.RSP[0] = kernel_stack;
+    gdt->TSS.IOMapBase = sizeof(TSS_t);     // no I/O permission bitmap
+
+    // a system descriptor takes two slots, the second holds base bits 32-63
+    GDTEntry_t tss = GDT_ENTRY(base, limit, GDT_ACCESS_PRESENT | GDT_ACCESS_DESCRIPTOR_TSS, 0);
+    memcpy(&gdt->Entries[GDT_TSS_SEGMENT / 8], &tss, sizeof(tss));
+    gdt->Entries[GDT_TSS_SEGMENT / 8 + 1] = base >> 32;
+
+    GDTDescriptor_t descriptor = { sizeof(gdt->Entries) - 1, (GDTEntry_t *)gdt->Entries };
+    GDT_Load(&descriptor, GDT_CODE_SEGMENT, GDT_DATA_SEGMENT);
+    __asm__ volatile("ltr %w0" :: "r"((uint16_t)GDT_TSS_SEGMENT));
+}
@@ -95,6 +95,10 @@ void IDT_DisableGate(int interrupt) {
     FLAG_UNSET(g_IDT[interrupt].Flags, IDT_FLAG_PRESENT);
 }
 
+void IDT_Reload(void) {
+    IDT_Load(&g_IDTDescriptor);
+}
+
 void IDT_Initialize() {
     IDT_Load(&g_IDTDescriptor);
         IDTDescriptor_t current;
@@ -0,0 +1,194 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: fpu.h
+    Description: FPU/SIMD register state management for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef FPU_H
+#define FPU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Every task has an XSAVE area sized from CPUID leaf 0xD for the components
+ * enabled in XCR0 (x87, SSE, AVX and AVX-512 where present), or a 512 byte
+ * FXSAVE area on CPUs without XSAVE.
+ *
+ * Restores are lazy. A context switch sets CR0.TS unless the incoming task's
+ * registers are still loaded on this CPU, and the task's first FPU or vector
+ * instruction traps to #NM, which restores its area. Saves happen at switch
+ * out, and only for a task that took that trap (or began with its state
+ * loaded) during its run, so switching between tasks that never touch the FPU
+ * costs nothing. The save uses XSAVES or XSAVEOPT where available, which skip
+ * components still in their init state or unchanged since the last restore.
+ *
+ * Kernel code that wants vector registers for itself brackets them with
+ * kernel_fpu_begin()/kernel_fpu_end(). The compiler uses them freely in
+ * klibc (the SSE2 string functions, float formatting), so the interrupt
+ * entry points bracket every handler with fpu_irq_enter()/fpu_irq_exit():
+ * registers live when the interrupt came are parked in a per-CPU area and
+ * put back on the way out, and under TS the handler's own first use traps
+ * and gets a clean FPU that belongs to no task.
+ */
+
+#define FPU_AREA_ALIGN      64
+#define FPU_FXSAVE_SIZE     512
+#define FPU_XSAVE_HDR       512         // offset of the XSAVE header
+#define FPU_XSAVE_HDR_SIZE  64
+#define FPU_NO_CPU          UINT32_MAX
+
+#define FPU_MXCSR_DEFAULT   0x1F80      // all exceptions masked, round to nearest
+#define FPU_FCW_DEFAULT     0x037F
+
+// XCR0 components
+#define XFEATURE_X87        (1ull << 0)
+#define XFEATURE_SSE        (1ull << 1)
+#define XFEATURE_AVX        (1ull << 2)
+#define XFEATURE_AVX512     (7ull << 5) // opmask, ZMM_Hi256, Hi16_ZMM, all or none
+#define XCOMP_BV_COMPACTED  (1ull << 63)
+
+#define CR0_MP              (1ull << 1)
+#define CR0_EM              (1ull << 2)
+#define CR0_TS              (1ull << 3)
+#define CR0_NE              (1ull << 5)
+#define CR4_OSFXSR          (1ull << 9)
+#define CR4_OSXMMEXCPT      (1ull << 10)
+#define CR4_OSXSAVE         (1ull << 18)
+
+#define MSR_IA32_XSS        0xDA0
+
+typedef enum {
+    FPU_MODE_FXSAVE,
+    FPU_MODE_XSAVE,
+    FPU_MODE_XSAVEOPT,              // skips components unchanged since the restore
+    FPU_MODE_XSAVES,                // that, compacted, and also skips init state
+} fpu_mode_t;
+
+typedef struct {
+    uint8_t *area;                  // FPU_AREA_ALIGN aligned
+    void *alloc;                    // what to free, area is inside it
+    uint32_t last_cpu;              // CPU whose registers still hold this state
+    uint64_t saves;
+    uint64_t restores;
+} fpu_ctx_t;
+
+// The save/restore instructions themselves. Inline and free of kernel state,
+// the host tests run them too (XSAVES and XRSTORS are ring 0 only)
+static inline void fpu_area_save(uint8_t *area, fpu_mode_t mode, uint64_t mask) {
+    uint32_t lo = (uint32_t)mask, hi = (uint32_t)(mask >> 32);
+
+    switch (mode) {
+    case FPU_MODE_XSAVES:
+        __asm__ volatile("xsaves64 (%0)" : : "r"(area), "a"(lo), "d"(hi) : "memory");
+        break;
+    case FPU_MODE_XSAVEOPT:
+        __asm__ volatile("xsaveopt64 (%0)" : : "r"(area), "a"(lo), "d"(hi) : "memory");
+        break;
+    case FPU_MODE_XSAVE:
+        __asm__ volatile("xsave64 (%0)" : : "r"(area), "a"(lo), "d"(hi) : "memory");
+        break;
+    default:
+        __asm__ volatile("fxsave64 (%0)" : : "r"(area) : "memory");
+        break;
+    }
+}
+
+static inline void fpu_area_restore(const uint8_t *area, fpu_mode_t mode, uint64_t mask) {
+    uint32_t lo = (uint32_t)mask, hi = (uint32_t)(mask >> 32);
+
+    switch (mode) {
+    case FPU_MODE_XSAVES:
+        __asm__ volatile("xrstors64 (%0)" : : "r"(area), "a"(lo), "d"(hi) : "memory");
+        break;
+    case FPU_MODE_XSAVEOPT:
+    case FPU_MODE_XSAVE:
+        __asm__ volatile("xrstor64 (%0)" : : "r"(area), "a"(lo), "d"(hi) : "memory");
+        break;
+    default:
+        __asm__ volatile("fxrstor64 (%0)" : : "r"(area) : "memory");
+        break;
+    }
+}
+
+static inline void fpu_load_defaults(void) {
+    uint32_t mxcsr = FPU_MXCSR_DEFAULT;
+    __asm__ volatile("fninit; ldmxcsr %0" : : "m"(mxcsr));
+}
+
+// What fpu_irq_enter()/fpu_irq_exit() do with live registers: save them and
+// give the handler the FNINIT state with the default MXCSR, then load them
+// back. Inline for the host tests
+static inline void fpu_irq_park(uint8_t *area, fpu_mode_t mode, uint64_t mask) {
+    fpu_area_save(area, mode, mask);
+    fpu_load_defaults();
+}
+
+static inline void fpu_irq_unpark(const uint8_t *area, fpu_mode_t mode, uint64_t mask) {
+    fpu_area_restore(area, mode, mask);
+}
+
+// An area that restores to the state after FNINIT with the default MXCSR.
+// An empty XSTATE_BV leaves every component in its init state, but MXCSR is
+// read from the legacy area whenever SSE or AVX is restored
+static inline void fpu_area_reset(uint8_t *area, size_t size, fpu_mode_t mode, uint64_t mask) {
+    for (size_t i = 0; i < size; i++)
+        area[i] = 0;
+    *(uint16_t *)(area + 0) = FPU_FCW_DEFAULT;
+    *(uint32_t *)(area + 24) = FPU_MXCSR_DEFAULT;
+    if (mode == FPU_MODE_XSAVES)
+        *(uint64_t *)(area + FPU_XSAVE_HDR + 8) = XCOMP_BV_COMPACTED | mask;
+}
+
+void fpu_init(void);                // BSP: detect, size the area, take #NM
+void fpu_init_cpu(void);            // enable the FPU and XCR0 on the calling CPU
+
+int8_t fpu_ctx_init(fpu_ctx_t *ctx);    // allocates, the caller serialises the heap
+void fpu_ctx_free(fpu_ctx_t *ctx);
+void fpu_adopt(fpu_ctx_t *ctx);     // the registers as they are belong to ctx
+void fpu_switch(fpu_ctx_t *prev, fpu_ctx_t *next);  // interrupts off
+
+void kernel_fpu_begin(void);
+void kernel_fpu_end(void);
+bool kernel_fpu_usable(void);       // false inside another begin/end pair
+
+bool fpu_irq_enter(void);           // interrupts off, true if registers were parked
+void fpu_irq_exit(bool parked);     // before the handler's EOI and sched_irq_exit()
+
+size_t fpu_area_size(void);
+void fpu_print_stats(void);
+
+#endif // FPU_H
@@ -38,8 +38,34 @@
 #ifndef GDT_H
 #define GDT_H
 
+#include <stdint.h>
+
 #define GDT_CODE_SEGMENT 0x08
 #define GDT_DATA_SEGMENT 0x10
+#define GDT_TSS_SEGMENT  0x28
+
+// 64-bit TSS, only the stack pointers are used in long mode
+typedef struct {
+    uint32_t Reserved0;
+    uint64_t RSP[3];        // stack loaded on an interrupt from ring 3 (RSP[0])
+    uint64_t Reserved1;
+    uint64_t IST[7];
+    uint64_t Reserved2;
+    uint16_t Reserved3;
+    uint16_t IOMapBase;
+} __attribute__((packed)) TSS_t;
+
+// one per CPU: the shared segments followed by a 16 byte TSS descriptor
+#define GDT_CPU_ENTRIES 7
+
+typedef struct {
+    uint64_t Entries[GDT_CPU_ENTRIES];
+    TSS_t TSS;
+} __attribute__((aligned(16))) GDT_CPU_t;
 
 void GDT_Initialize();
+
+// load a private copy of the GDT with a TSS on the calling CPU. Reloading the
+// segment registers clears the GS base, so set it again afterwards
+void GDT_InitializeCPU(GDT_CPU_t *gdt, uint64_t kernel_stack);
 #endif
@@ -59,6 +59,7 @@ typedef enum {
 } IDT_FLAGS_t;
 
 void IDT_Initialize();
+void IDT_Reload(void);      // APs share the BSP's IDT, this only loads it
 void IDT_DisableGate(int interrupt);
 void IDT_EnableGate(int interrupt);
 void IDT_SetGate(int interrupt, void *base, uint16_t segmentDescriptor, uint8_t flags);
@@ -42,6 +42,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 
 uint8_t inb(uint16_t port);
 void outb(uint16_t port, uint8_t val);
@@ -180,6 +181,22 @@ static inline void outsw(uint16_t port, const void *buf, unsigned long count) {
 
 void enable_interrupts();
 void disable_interrupts();
+bool are_interrupts_enabled(void);
+
+// disable interrupts and return the old RFLAGS, for irq_restore()
+static inline uint64_t irq_save(void) {
+    uint64_t flags;
+    __asm__ volatile("pushfq; pop %0; cli" : "=r"(flags) : : "memory");
+    return flags;
+}
+
+// re-enable interrupts only if irq_save() found them enabled
+static inline void irq_restore(uint64_t flags) {
+    if (flags & (1 << 9))
+        __asm__ volatile("sti" : : : "memory");
+}
+
 void halt_interrupts_enabled(void);
 void halt(void);
+void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx);
 #endif
@@ -88,6 +88,7 @@ typedef void (*ISRHandler_t)(Registers_t *regs);
 
 void ISR_Initialize();
 void ISR_RegisterHandler(int interrupt, ISRHandler_t handler);
+void ISR_UnregisterHandler(int interrupt);      // sleeps for a grace period
 
 void page_fault_handler(Registers_t *regs);
 void panic(Registers_t *regs);
@@ -51,8 +51,8 @@ void halt(void) {
         : "=r"(rip)
     );
 
-   printf("[ EMERGENCY ] HALTED CPU AT INSTRUCTION: %llx\n", rip);
-    serial_printf("[ EMERGENCY ] HALTED CPU AT INSTRUCTION: %llx\n", rip);
+   printf("[ EMERGENCY ] HALTED CPU AT INSTRUCTION: 0x%llx\n", rip);
+    serial_printf("[ EMERGENCY ] HALTED CPU AT INSTRUCTION: 0x%llx\n", rip);
     // just disable interrupts and jump-halt
     __asm__ volatile (
         "cli\n"      // disable interrupts
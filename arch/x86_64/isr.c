@@ -48,6 +48,7 @@
 #include <stddef.h>
 #include "tools/includes/log-info.h"
 #include "kernel/terminal/src/flanterm.h"
+#include "kernel/system/includes/rcu.h"
 
 extern struct flanterm_context *global_flanterm;
 
@@ -72,9 +73,12 @@ void ISR_Initialize() {
 
 // yeah no im not touching any of this shit, i cannot go through another 8 hours of debugging
 void ISR_Handler(Registers_t *regs) {
+    // handlers are RCU readers, even when they interrupt an idle CPU
+    bool from_idle = rcu_irq_enter();
+    ISRHandler_t handler = rcu_dereference(g_ISRHandlers[regs->interrupt]);
 
-    if (g_ISRHandlers[regs->interrupt] != NULL) {
-        g_ISRHandlers[regs->interrupt](regs);
+    if (handler != NULL) {
+        handler(regs);
     } else if (regs->interrupt >= 32) {
             printcol(COLOR_RED, "KERNEL PANIC!\n");
     serial_write("KERNEL PANIC!\n", 15);
@@ -85,10 +89,10 @@ void ISR_Handler(Registers_t *regs) {
         printf("Unhandled interrupt %d!\n", regs->interrupt);
         serial_printf("Unhandled interrupt %d!\n", regs->interrupt);
 
-        printf("  rax=%llx  rbx=%llx  rcx=%llx  rdx=%llx  rsi=%llx  rdi=%llx\n  r8=%llx  r9=%llx  r10=%llx  r11=%llx  r12=%llx  r13=%llx\n r14=%llx  r15=%llx\n  rsp=%llx  rbp=%llx  rip=%llx  rflags=%llx  cs=%llx  ss=%llx\n cr2=%llx  cr3=%llx\n  interrupt=%llx  errorcode=%llx\n",
+        printf("  rax=0x%llx  rbx=0x%llx  rcx=0x%llx  rdx=0x%llx  rsi=0x%llx  rdi=0x%llx\n  r8=0x%llx  r9=0x%llx  r10=0x%llx  r11=0x%llx  r12=0x%llx  r13=0x%llx\n r14=0x%llx  r15=0x%llx\n  rsp=0x%llx  rbp=0x%llx  rip=0x%llx  rflags=0x%llx  cs=0x%llx  ss=0x%llx\n cr2=0x%llx  cr3=0x%llx\n  interrupt=0x%llx  errorcode=0x%llx\n",
                regs->rax, regs->rbx, regs->rcx, regs->rdx, regs->rsi, regs->rdi, regs->r8, regs->r9, regs->r10, regs->r11, regs->r12, regs->r13, regs->r14, regs->r15, regs->rsp, regs->rbp, regs->rip, regs->rflags, regs->cs, regs->ss, cr2, cr3, regs->interrupt, regs->error);
         
-        serial_printf("  rax=%llx  rbx=%llx  rcx=%llx  rdx=%llx  rsi=%llx  rdi=%llx\n  r8=%llx  r9=%llx  r10=%llx  r11=%llx  r12=%llx  r13=%llx\n r14=%llx  r15=%llx\n  rsp=%llx  rbp=%llx  rip=%llx  rflags=%llx  cs=%llx  ss=%llx\n cr2=%llx  cr3=%llx\n  interrupt=%llx  errorcode=%llx\n",
+        serial_printf("  rax=0x%llx  rbx=0x%llx  rcx=0x%llx  rdx=0x%llx  rsi=0x%llx  rdi=0x%llx\n  r8=0x%llx  r9=0x%llx  r10=0x%llx  r11=0x%llx  r12=0x%llx  r13=0x%llx\n r14=0x%llx  r15=0x%llx\n  rsp=0x%llx  rbp=0x%llx  rip=0x%llx  rflags=0x%llx  cs=0x%llx  ss=0x%llx\n cr2=0x%llx  cr3=0x%llx\n  interrupt=0x%llx  errorcode=0x%llx\n",
             regs->rax, regs->rbx, regs->rcx, regs->rdx, regs->rsi, regs->rdi, regs->r8, regs->r9, regs->r10, regs->r11, regs->r12, regs->r13, regs->r14, regs->r15, regs->rsp, regs->rbp, regs->rip, regs->rflags, regs->cs, regs->ss, cr2, cr3, regs->interrupt, regs->error);
 
     } else {
@@ -100,14 +104,15 @@ void ISR_Handler(Registers_t *regs) {
         
         printf("Unhandled exception %d: %s\n", regs->interrupt, g_Exceptions[regs->interrupt]);
         serial_printf("Unhandled exception %d: %s\n", regs->interrupt, g_Exceptions[regs->interrupt]);
-            printf("  rax=%llx  rbx=%llx  rcx=%llx  rdx=%llx  rsi=%llx  rdi=%llx\n  r8=%llx  r9=%llx  r10=%llx  r11=%llx  r12=%llx  r13=%llx\n r14=%llx  r15=%llx\n  rsp=%llx  rbp=%llx  rip=%llx  rflags=%llx  cs=%llx  ss=%llx\n cr2=%llx  cr3=%llx\n  interrupt=%llx  errorcode=%llx\n",
+            printf("  rax=0x%llx  rbx=0x%llx  rcx=0x%llx  rdx=0x%llx  rsi=0x%llx  rdi=0x%llx\n  r8=0x%llx  r9=0x%llx  r10=0x%llx  r11=0x%llx  r12=0x%llx  r13=0x%llx\n r14=0x%llx  r15=0x%llx\n  rsp=0x%llx  rbp=0x%llx  rip=0x%llx  rflags=0x%llx  cs=0x%llx  ss=0x%llx\n cr2=0x%llx  cr3=0x%llx\n  interrupt=0x%llx  errorcode=0x%llx\n",
            regs->rax, regs->rbx, regs->rcx, regs->rdx, regs->rsi, regs->rdi, regs->r8, regs->r9, regs->r10, regs->r11, regs->r12, regs->r13, regs->r14, regs->r15, regs->rsp, regs->rbp, regs->rip, regs->rflags, regs->cs, regs->ss, cr2, cr3, regs->interrupt, regs->error);
     
-    serial_printf("  rax=%llx  rbx=%llx  rcx=%llx  rdx=%llx  rsi=%llx  rdi=%llx\n  r8=%llx  r9=%llx  r10=%llx  r11=%llx  r12=%llx  r13=%llx\n r14=%llx  r15=%llx\n  rsp=%llx  rbp=%llx  rip=%llx  rflags=%llx  cs=%llx  ss=%llx\n cr2=%llx  cr3=%llx\n  interrupt=%llx  errorcode=%llx\n",
+    serial_printf("  rax=0x%llx  rbx=0x%llx  rcx=0x%llx  rdx=0x%llx  rsi=0x%llx  rdi=0x%llx\n  r8=0x%llx  r9=0x%llx  r10=0x%llx  r11=0x%llx  r12=0x%llx  r13=0x%llx\n r14=0x%llx  r15=0x%llx\n  rsp=0x%llx  rbp=0x%llx  rip=0x%llx  rflags=0x%llx  cs=0x%llx  ss=0x%llx\n cr2=0x%llx  cr3=0x%llx\n  interrupt=0x%llx  errorcode=0x%llx\n",
         regs->rax, regs->rbx, regs->rcx, regs->rdx, regs->rsi, regs->rdi, regs->r8, regs->r9, regs->r10, regs->r11, regs->r12, regs->r13, regs->r14, regs->r15, regs->rsp, regs->rbp, regs->rip, regs->rflags, regs->cs, regs->ss, cr2, cr3, regs->interrupt, regs->error);
 
         halt();
     }
+    rcu_irq_exit(from_idle);
 }
 
 void page_fault_handler(Registers_t *regs) {
@@ -122,21 +127,21 @@ void page_fault_handler(Registers_t *regs) {
     printcol(COLOR_BOLD, "You are most likely trying to access an invalid or non-mapped memory address.\n");
    printcol(COLOR_BOLD, "Please consult the documentation or external resources for more information on proper memory handling.\n");
     
-    printf("Error code: %llx\n", regs->error);
-    printf("  Faulting address (CR2): %llx\n", cr2);
-    printf("  Page table base (CR3): %llx\n", cr3);
+    printf("Error code: 0x%llx\n", regs->error);
+    printf("  Faulting address (CR2): 0x%llx\n", cr2);
+    printf("  Page table base (CR3): 0x%llx\n", cr3);
 
     serial_printf("PAGE FAULT TRIGGERED!\n");
     serial_printf("You are most likely trying to access an invalid or non-mapped memory address.\n");
     serial_printf("Please consult the documentation or external resources for more information on proper memory handling.\n");
-    serial_printf("Error code: %llx\n", regs->error);
-    serial_printf("  Faulting address (CR2): %llx\n", cr2);
-    serial_printf("  Page table base (CR3): %llx\n", cr3);
+    serial_printf("Error code: 0x%llx\n", regs->error);
+    serial_printf("  Faulting address (CR2): 0x%llx\n", cr2);
+    serial_printf("  Page table base (CR3): 0x%llx\n", cr3);
 
-    printf("  rax=%llx  rbx=%llx  rcx=%llx  rdx=%llx  rsi=%llx  rdi=%llx\n  r8=%llx  r9=%llx  r10=%llx  r11=%llx  r12=%llx  r13=%llx\n r14=%llx  r15=%llx\n  rsp=%llx  rbp=%llx  rip=%llx  rflags=%llx  cs=%llx  ss=%llx\n cr2=%llx  cr3=%llx\n  interrupt=%llx  errorcode=%llx\n",
+    printf("  rax=0x%llx  rbx=0x%llx  rcx=0x%llx  rdx=0x%llx  rsi=0x%llx  rdi=0x%llx\n  r8=0x%llx  r9=0x%llx  r10=0x%llx  r11=0x%llx  r12=0x%llx  r13=0x%llx\n r14=0x%llx  r15=0x%llx\n  rsp=0x%llx  rbp=0x%llx  rip=0x%llx  rflags=0x%llx  cs=0x%llx  ss=0x%llx\n cr2=0x%llx  cr3=0x%llx\n  interrupt=0x%llx  errorcode=0x%llx\n",
            regs->rax, regs->rbx, regs->rcx, regs->rdx, regs->rsi, regs->rdi, regs->r8, regs->r9, regs->r10, regs->r11, regs->r12, regs->r13, regs->r14, regs->r15, regs->rsp, regs->rbp, regs->rip, regs->rflags, regs->cs, regs->ss, cr2, cr3, regs->interrupt, regs->error);
     
-    serial_printf("  rax=%llx  rbx=%llx  rcx=%llx  rdx=%llx  rsi=%llx  rdi=%llx\n  r8=%llx  r9=%llx  r10=%llx  r11=%llx  r12=%llx  r13=%llx\n r14=%llx  r15=%llx\n  rsp=%llx  rbp=%llx  rip=%llx  rflags=%llx  cs=%llx  ss=%llx\n cr2=%llx  cr3=%llx\n  interrupt=%llx  errorcode=%llx\n",
+    serial_printf("  rax=0x%llx  rbx=0x%llx  rcx=0x%llx  rdx=0x%llx  rsi=0x%llx  rdi=0x%llx\n  r8=0x%llx  r9=0x%llx  r10=0x%llx  r11=0x%llx  r12=0x%llx  r13=0x%llx\n r14=0x%llx  r15=0x%llx\n  rsp=0x%llx  rbp=0x%llx  rip=0x%llx  rflags=0x%llx  cs=0x%llx  ss=0x%llx\n cr2=0x%llx  cr3=0x%llx\n  interrupt=0x%llx  errorcode=0x%llx\n",
         regs->rax, regs->rbx, regs->rcx, regs->rdx, regs->rsi, regs->rdi, regs->r8, regs->r9, regs->r10, regs->r11, regs->r12, regs->r13, regs->r14, regs->r15, regs->rsp, regs->rbp, regs->rip, regs->rflags, regs->cs, regs->ss, cr2, cr3, regs->interrupt, regs->error);
 
     if (regs->error & 0x1) {
@@ -151,18 +156,24 @@ void page_fault_handler(Registers_t *regs) {
 }
 
 void ISR_RegisterHandler(int interrupt, ISRHandler_t handler) {
-    g_ISRHandlers[interrupt] = handler;
+    rcu_assign_pointer(g_ISRHandlers[interrupt], handler);
     IDT_EnableGate(interrupt);
 }
 
+// whatever the old handler uses may be freed once this returns
+void ISR_UnregisterHandler(int interrupt) {
+    rcu_assign_pointer(g_ISRHandlers[interrupt], NULL);
+    synchronize_rcu();
+}
+
 void panic(Registers_t *regs) {
         uint64_t cr2, cr3;
     asm("mov %%cr2, %0" : "=r"(cr2));
     asm("mov %%cr3, %0" : "=r"(cr3));
-    printf("  rax=%llx  rbx=%llx  rcx=%llx  rdx=%llx  rsi=%llx  rdi=%llx\n  r8=%llx  r9=%llx  r10=%llx  r11=%llx  r12=%llx  r13=%llx\n r14=%llx  r15=%llx\n  rsp=%llx  rbp=%llx  rip=%llx  rflags=%llx  cs=%llx  ss=%llx\n cr2=%llx  cr3=%llx\n  interrupt=%llx  errorcode=%llx\n",
+    printf("  rax=0x%llx  rbx=0x%llx  rcx=0x%llx  rdx=0x%llx  rsi=0x%llx  rdi=0x%llx\n  r8=0x%llx  r9=0x%llx  r10=0x%llx  r11=0x%llx  r12=0x%llx  r13=0x%llx\n r14=0x%llx  r15=0x%llx\n  rsp=0x%llx  rbp=0x%llx  rip=0x%llx  rflags=0x%llx  cs=0x%llx  ss=0x%llx\n cr2=0x%llx  cr3=0x%llx\n  interrupt=0x%llx  errorcode=0x%llx\n",
            regs->rax, regs->rbx, regs->rcx, regs->rdx, regs->rsi, regs->rdi, regs->r8, regs->r9, regs->r10, regs->r11, regs->r12, regs->r13, regs->r14, regs->r15, regs->rsp, regs->rbp, regs->rip, regs->rflags, regs->cs, regs->ss, cr2, cr3, regs->interrupt, regs->error);
     
-    serial_printf("  rax=%llx  rbx=%llx  rcx=%llx  rdx=%llx  rsi=%llx  rdi=%llx\n  r8=%llx  r9=%llx  r10=%llx  r11=%llx  r12=%llx  r13=%llx\n r14=%llx  r15=%llx\n  rsp=%llx  rbp=%llx  rip=%llx  rflags=%llx  cs=%llx  ss=%llx\n cr2=%llx  cr3=%llx\n  interrupt=%llx  errorcode=%llx\n",
+    serial_printf("  rax=0x%llx  rbx=0x%llx  rcx=0x%llx  rdx=0x%llx  rsi=0x%llx  rdi=0x%llx\n  r8=0x%llx  r9=0x%llx  r10=0x%llx  r11=0x%llx  r12=0x%llx  r13=0x%llx\n r14=0x%llx  r15=0x%llx\n  rsp=0x%llx  rbp=0x%llx  rip=0x%llx  rflags=0x%llx  cs=0x%llx  ss=0x%llx\n cr2=0x%llx  cr3=0x%llx\n  interrupt=0x%llx  errorcode=0x%llx\n",
         regs->rax, regs->rbx, regs->rcx, regs->rdx, regs->rsi, regs->rdi, regs->r8, regs->r9, regs->r10, regs->r11, regs->r12, regs->r13, regs->r14, regs->r15, regs->rsp, regs->rbp, regs->rip, regs->rflags, regs->cs, regs->ss, cr2, cr3, regs->interrupt, regs->error);
 
     halt();
@@ -0,0 +1,127 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: acpi.c
+    Description: ACPI table discovery for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/acpi.h"
+#include "boot/limine.h"
+#include "mm/includes/vmm.h"
+#include "tools/includes/log-info.h"
+#include <string.h>
+
+__attribute__((used, section(".limine_requests")))
+static volatile struct limine_rsdp_request rsdp_request = {
+    .id = LIMINE_RSDP_REQUEST_ID,
+    .revision = 0};
+
+static acpi_sdt_header_t *root_table = NULL;
+static bool root_is_xsdt = false;
+
+static bool acpi_checksum_ok(const void *table, size_t length) {
+    const uint8_t *bytes = table;
+    uint8_t sum = 0;
+
+    for (size_t i = 0; i < length; i++)
+        sum += bytes[i];
+    return sum == 0;
+}
+
+// older Limine revisions hand out HHDM pointers, newer ones physical addresses
+static void *acpi_map(uint64_t address) {
+    if (address >= hhdm_offset)
+        return (void *)address;
+    return phys_to_virt(address);
+}
+
+int8_t acpi_init(void) {
+    if (rsdp_request.response == NULL || rsdp_request.response->address == 0) {
+        LOG_WARN("No RSDP from the bootloader, ACPI tables unavailable\n");
+        SERIAL(Warn, acpi_init, "No RSDP from the bootloader, ACPI tables unavailable\n");
+        return -1;
+    }
+
+    acpi_rsdp_t *rsdp = acpi_map((uint64_t)rsdp_request.response->address);
+    if (memcmp(rsdp->signature, "RSD PTR ", 8) != 0 || !acpi_checksum_ok(rsdp, 20)) {
+        LOG_WARN("RSDP signature or checksum is invalid\n");
+        SERIAL(Warn, acpi_init, "RSDP signature or checksum is invalid\n");
+        return -1;
+    }
+
+    // prefer the XSDT, its entries are 64-bit
+    if (rsdp->revision >= 2 && rsdp->xsdt_address != 0) {
+        root_table = phys_to_virt(rsdp->xsdt_address);
+        root_is_xsdt = true;
+    } else {
+        root_table = phys_to_virt(rsdp->rsdt_address);
+        root_is_xsdt = false;
+    }
+
+    if (!acpi_checksum_ok(root_table, root_table->length)) {
+        LOG_WARN("%s checksum is invalid\n", root_is_xsdt ? "XSDT" : "RSDT");
+        SERIAL(Warn, acpi_init, "%s checksum is invalid\n", root_is_xsdt ? "XSDT" : "RSDT");
+        root_table = NULL;
+        return -1;
+    }
+
+    LOG_INFO("ACPI %s found, revision %u, OEM '%.6s'\n", root_is_xsdt ? "XSDT" : "RSDT",
+             rsdp->revision, rsdp->oem_id);
+    SERIAL(Info, acpi_init, "ACPI %s found, revision %u, OEM '%.6s'\n", root_is_xsdt ? "XSDT" : "RSDT",
+           rsdp->revision, rsdp->oem_id);
+    return 0;
+}
+
+acpi_sdt_header_t *acpi_find_table(const char *signature, uint32_t index) {
+    if (root_table == NULL)
+        return NULL;
+
+    size_t entry_size = root_is_xsdt ? 8 : 4;
+    size_t entries = (root_table->length - sizeof(acpi_sdt_header_t)) / entry_size;
+    const uint8_t *list = (const uint8_t *)(root_table + 1);
+
+    for (size_t i = 0; i < entries; i++) {
+        uint64_t phys = 0;
+        memcpy(&phys, list + i * entry_size, entry_size); // entries are unaligned in the RSDT
+
+        acpi_sdt_header_t *table = phys_to_virt(phys);
+        if (memcmp(table->signature, signature, 4) != 0)
+            continue;
+        if (!acpi_checksum_ok(table, table->length))
+            continue;
+        if (index-- == 0)
+            return table;
+    }
+    return NULL;
+}
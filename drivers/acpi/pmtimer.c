@@ -0,0 +1,90 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: pmtimer.c
+    Description: ACPI PM timer driver for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/acpi.h"
+#include "includes/pmtimer.h"
+#include "kernel/time/includes/clocksource.h"
+#include "arch/x86_64/includes/io.h"
+#include "tools/includes/log-info.h"
+#include <string.h>
+
+static uint16_t pmtimer_port;
+
+static clocksource_t pmtimer_clocksource = {
+    .name = "acpi_pm",
+    .rating = 200,
+    .freq_hz = PMTIMER_FREQ,
+    .read = pmtimer_read,
+};
+
+bool pmtimer_available(void) {
+    return pmtimer_port != 0;
+}
+
+uint64_t pmtimer_read(void) {
+    return inl(pmtimer_port) & pmtimer_clocksource.mask;
+}
+
+int8_t pmtimer_init(void) {
+    uint8_t *fadt = (uint8_t *)acpi_find_table("FACP", 0);
+    if (fadt == NULL)
+        return -1;
+
+    uint32_t length = ((acpi_sdt_header_t *)fadt)->length;
+    uint32_t port = 0, flags = 0;
+    memcpy(&port, fadt + ACPI_FADT_PM_TMR_BLK, sizeof(port));
+    memcpy(&flags, fadt + ACPI_FADT_FLAGS, sizeof(flags));
+
+    // the extended block wins when it is there and says I/O space
+    if (length >= ACPI_FADT_X_PM_TMR_BLK + sizeof(acpi_gas_t)) {
+        acpi_gas_t block;
+        memcpy(&block, fadt + ACPI_FADT_X_PM_TMR_BLK, sizeof(block));
+        if (block.address_space_id == ACPI_GAS_IO && block.address != 0)
+            port = (uint32_t)block.address;
+    }
+
+    if (port == 0 || port > 0xFFFF) {
+        LOG_WARN("FADT has no usable PM timer\n");
+        SERIAL(Warn, pmtimer_init, "FADT has no usable PM timer\n");
+        return -1;
+    }
+
+    pmtimer_port = (uint16_t)port;
+    pmtimer_clocksource.mask = (flags & ACPI_FADT_TMR_VAL_EXT) ? 0xFFFFFFFF : 0xFFFFFF;
+    return clocksource_register(&pmtimer_clocksource);
+}
@@ -45,6 +45,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "kernel/time/includes/time.h"
+#include "kernel/time/includes/timer.h"
 #include "includes/ehci.h"
 #include "tools/includes/log-info.h"
 #include "mm/includes/pmm.h"
@@ -68,10 +69,10 @@ int ehci_stop_controller(void) {
     uint32_t start = get_time_ms();
     while (!(ehci->USBSTS & EHCI_USBSTS_HCHALTED)) {
         if (get_time_ms() - start > 500) {
-            LOG_INFO("EHCI: stop timeout, STS=%08x CMD=%08x, EHCIBASE=%08x\n", ehci->USBSTS, ehci->USBCMD, ehci);
+            LOG_INFO("EHCI: stop timeout, STS=%08x CMD=%08x, EHCIBASE=%p\n", ehci->USBSTS, ehci->USBCMD, ehci);
             return -1;
         }
-        udelay(1000);
+        msleep(1);
     }
 
          LOG_INFO("EHCI: halted successfully, STS=%08x CMD=%08x\n", ehci->USBSTS, ehci->USBCMD);
@@ -91,7 +92,7 @@ int ehci_reset_controller(void) {
         }
     }
 
-    udelay(1000);
+    msleep(1);
 
     ehci->USBCMD = EHCI_RESET;
     LOG_INFO("EHCI: CMD after set reset=%08x\n", ehci->USBCMD);
@@ -99,17 +100,17 @@ int ehci_reset_controller(void) {
     uint32_t start = get_time_ms();
     while (ehci->USBCMD & EHCI_RESET) {
         if (get_time_ms() - start > 1000) {
-            LOG_INFO("EHCI: reset timeout, CMD=%08x STS=%08x, EHCIBASE=%08x\n",
+            LOG_INFO("EHCI: reset timeout, CMD=%08x STS=%08x, EHCIBASE=%p\n",
                   ehci->USBCMD, ehci->USBSTS, ehci);
             return -1;
         }
-        udelay(1000);
+        msleep(1);
     }
 
     LOG_INFO("EHCI: reset complete, CMD=%08x STS=%08x\n",
           ehci->USBCMD, ehci->USBSTS);
 
-    udelay(1000);
+    msleep(1);
     return 0;
 }
 
@@ -173,7 +174,7 @@ int ehci_init_simple(void) {
             LOG_INFO("Timeout waiting for EHCI HCHalted bit clear\n");
             break;
         }
-        udelay(100);
+        usleep_range(100, 2000);
     }
 
     uint32_t cmd = ehci->USBCMD;
@@ -203,11 +204,11 @@ int ehci_reset_port(int port_num) {
     
     if (*portsc & PORTSC_ENABLED) {
         *portsc &= ~PORTSC_ENABLED;
-        udelay(1000);
+        msleep(1);
     }
     
     *portsc |= PORTSC_RESET;
-    udelay(50000);
+    msleep(50);
     *portsc &= ~PORTSC_RESET;
     
     uint32_t start = get_time_ms();
@@ -220,11 +221,11 @@ int ehci_reset_port(int port_num) {
         }
         
         if (get_time_ms() - start > 500) return -4;
-        udelay(1000);
+        msleep(1);
     }
     
     *portsc |= (PORTSC_CONNECT_CHANGE | PORTSC_ENABLE_CHANGE);
-    udelay(10000);
+    msleep(10);
     
     return 0;
 }
@@ -233,7 +234,7 @@ void ehci_power_on_ports(int num_ports) {
     for (int i = 0; i < num_ports && i < 16; i++) {
         ehci->PORTSC[i] |= PORTSC_POWER;
     }
-    udelay(20000);
+    msleep(20);
 }
 
 int ehci_find_and_reset_device(int *port_num_out) {
@@ -322,7 +323,7 @@ int ehci_submit_bulk_simple(uint8_t devaddr, uint8_t ep_addr, void *data_vaddr,
             return -2;
         }
         
-        udelay(100);
+        usleep_range(100, 2000);
     }
     
     async_list_head->horiz_link = qh->horiz_link;
@@ -458,7 +459,7 @@ int usb_control_transfer(uint8_t devaddr, usb_ctrl_setup_t *setup,
             pfree(mem_phys);
             return -4;
         }
-        udelay(100);
+        usleep_range(100, 2000);
     }
 
     // invalidate cache so CPU sees updated token & buffer
@@ -519,7 +520,7 @@ int usb_set_address(uint8_t new_addr) {
     };
     int rc = usb_control_transfer(0, &setup, NULL, 0);
     if (rc == 0) {
-        udelay(2000);
+        msleep(2);
     }
     LOG_INFO("RCL: %u\n", rc);
     return rc;
@@ -566,7 +567,7 @@ int find_mass_storage_device(usb_device_t *out_dev) {
         pfree(desc_buf_phys);
         return -100-res;
     }
-    LOG_INFO("0x%x-%x-%x-%x", desc_buf);
+    LOG_INFO("Config descriptor at %p\n", desc_buf);
     LOG_INFO("2 \n");
     pid_rn=19;
     
@@ -608,7 +609,7 @@ int find_mass_storage_device(usb_device_t *out_dev) {
     uint8_t *end = (uint8_t *)desc_buf + total_len;
     int found_msd = 0;
 
-    LOG_INFO("Start 0x%x, end 0x%x", ptr, end);
+    LOG_INFO("Start %p, end %p", ptr, end);
     
     while (ptr < end) {
         uint8_t len = ptr[0];
@@ -676,11 +677,11 @@ int find_mass_storage_device(usb_device_t *out_dev) {
         return -7;
     }
     
-    udelay(100000);
+    msleep(100);
     
     // perform Bulk-Only Mass Storage Reset
     usb_msd_reset(out_dev->address, out_dev->iface_number);
-    udelay(100000);
+    msleep(100);
     
     return 0;
 }
@@ -909,7 +910,7 @@ void ehci_pci_init(uint8_t bus, uint8_t dev, uint8_t func) {
     uint64_t phys = bar0 & 0xFFFFFFF0;
     uint32_t size = pci_get_bar_size(bus, dev, func, 0x10);
 
-    LOG_INFO("EHCI MMIO phys=%p size=%u\n", phys, size);
+    LOG_INFO("EHCI MMIO phys=0x%lx size=%u\n", phys, size);
     for (uint64_t off = 0; off < size; off += 0x1000) {
         map_page(
             phys + off,
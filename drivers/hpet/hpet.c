@@ -0,0 +1,250 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: hpet.c
+    Description: HPET driver for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/hpet.h"
+#include "drivers/pic/includes/apic/apic.h"
+#include "drivers/pic/includes/apic/apic_irq.h"
+#include "drivers/pic/includes/apic/ioapic.h"
+#include "kernel/system/includes/percpu.h"
+#include "mm/includes/vmm.h"
+#include "kernel/time/includes/time.h"
+#include "tools/includes/log-info.h"
+
+#define APIC_IRQ_VECTOR_BASE 0x20   // APIC IRQ n arrives on vector 0x20 + n
+
+// a comparator written closer than this to the counter may already be behind it
+#define HPET_MIN_DELTA_NS 2000
+
+static volatile uint8_t *hpet_regs = NULL;
+static uint64_t hpet_caps;
+static uint64_t hpet_hz;
+static clock_scale_t hpet_to_ns;
+static clock_scale_t hpet_from_ns;
+static bool hpet_counter_64bit;
+
+// 32-bit counters wrap every ~5 minutes at 14.3 MHz, keep the high half here
+static uint64_t hpet_last_count;
+
+static inline uint64_t hpet_read(uint32_t reg) {
+    return *(volatile uint64_t *)(hpet_regs + reg);
+}
+
+static inline void hpet_write(uint32_t reg, uint64_t value) {
+    *(volatile uint64_t *)(hpet_regs + reg) = value;
+}
+
+bool hpet_available(void) {
+    return hpet_regs != NULL;
+}
+
+int8_t hpet_init(void) {
+    acpi_hpet_t *table = (acpi_hpet_t *)acpi_find_table("HPET", 0);
+    if (table == NULL) {
+        LOG_WARN("No ACPI HPET table, HPET unavailable\n");
+        SERIAL(Warn, hpet_init, "No ACPI HPET table, HPET unavailable\n");
+        return -1;
+    }
+    if (table->base_address.address_space_id != ACPI_GAS_MEMORY) {
+        LOG_WARN("HPET is not memory mapped, ignoring it\n");
+        SERIAL(Warn, hpet_init, "HPET is not memory mapped, ignoring it\n");
+        return -1;
+    }
+
+    // register block is 1 KiB, map it uncached like other MMIO
+    uint64_t base = table->base_address.address;
+    map_page(base & ~0xFFFull, base & ~0xFFFull, PTE_WRITABLE | PTE_CACHE_DISABLE | PTE_WRITE_THROUGH);
+    hpet_regs = (volatile uint8_t *)base;
+
+    hpet_caps = hpet_read(HPET_REG_CAPABILITIES);
+    uint64_t period = HPET_CAP_PERIOD_FS(hpet_caps);
+    if (period == 0 || period > 100000000) { // spec caps the period at 100 ns
+        LOG_WARN("HPET reports a bogus period of %lu fs\n", period);
+        SERIAL(Warn, hpet_init, "HPET reports a bogus period of %lu fs\n", period);
+        hpet_regs = NULL;
+        return -1;
+    }
+
+    hpet_hz = 1000000000000000ull / period;
+    hpet_to_ns = clock_scale_make(hpet_hz, 1000000000);
+    hpet_from_ns = clock_scale_make(1000000000, hpet_hz);
+    hpet_counter_64bit = (hpet_caps & HPET_CAP_COUNT_64BIT) != 0;
+
+    // comparators off until someone asks for them, then start the counter
+    hpet_write(HPET_REG_CONFIG, hpet_read(HPET_REG_CONFIG) & ~(HPET_CFG_ENABLE | HPET_CFG_LEGACY_ROUTE));
+    for (uint8_t i = 0; i < hpet_timer_count(); i++)
+        hpet_write(HPET_REG_TIMER_CONFIG(i), hpet_read(HPET_REG_TIMER_CONFIG(i)) & ~HPET_TN_INT_ENABLE);
+    hpet_write(HPET_REG_CONFIG, hpet_read(HPET_REG_CONFIG) | HPET_CFG_ENABLE);
+    hpet_last_count = hpet_read(HPET_REG_MAIN_COUNTER);
+
+    LOG_INFO("HPET at 0x%lx: %lu Hz, %u timers, %s counter\n", base, hpet_hz,
+             hpet_timer_count(), hpet_counter_64bit ? "64-bit" : "32-bit");
+    SERIAL(Info, hpet_init, "HPET at 0x%lx: %lu Hz, %u timers, %s counter\n", base, hpet_hz,
+           hpet_timer_count(), hpet_counter_64bit ? "64-bit" : "32-bit");
+    return 0;
+}
+
+uint64_t hpet_read_counter(void) {
+    if (hpet_counter_64bit)
+        return hpet_read(HPET_REG_MAIN_COUNTER);
+
+    // Must be called at least once per wrap, which anything using it does.
+    // The last count is taken before the counter is read, so the extension
+    // is right against that snapshot whatever other readers store meanwhile,
+    // and the shared value only ever moves forward
+    uint64_t last = __atomic_load_n(&hpet_last_count, __ATOMIC_ACQUIRE);
+    uint32_t low = (uint32_t)hpet_read(HPET_REG_MAIN_COUNTER);
+    uint64_t count = (last & ~0xFFFFFFFFull) | low;
+    if (low < (uint32_t)last)
+        count += 1ull << 32;
+
+    while (count > last &&
+           !__atomic_compare_exchange_n(&hpet_last_count, &last, count, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_ACQUIRE))
+        ;
+    return count;
+}
+
+uint64_t hpet_frequency(void) {
+    return hpet_hz;
+}
+
+uint64_t hpet_period_fs(void) {
+    return HPET_CAP_PERIOD_FS(hpet_caps);
+}
+
+uint64_t hpet_ns(void) {
+    return clock_scale_apply(hpet_to_ns, hpet_read_counter());
+}
+
+bool hpet_counter_is_64bit(void) {
+    return hpet_counter_64bit;
+}
+
+uint8_t hpet_timer_count(void) {
+    return hpet_regs ? HPET_CAP_NUM_TIMERS(hpet_caps) : 0;
+}
+
+int8_t hpet_delay_us(uint32_t micros) {
+    if (!hpet_available())
+        return -1;
+
+    uint64_t start = hpet_read_counter();
+    uint64_t ticks = clock_scale_apply(hpet_from_ns, (uint64_t)micros * 1000);
+
+    while (hpet_read_counter() - start < ticks)
+        __asm__ volatile("pause");
+    return 0;
+}
+
+uint64_t hpet_measure_tsc_hz(uint32_t ms) {
+    if (!hpet_available() || ms == 0)
+        return 0;
+
+    uint64_t ticks = clock_scale_apply(hpet_from_ns, (uint64_t)ms * 1000000);
+
+    // line both counters up on an HPET edge so the window is exact
+    uint64_t start = hpet_read_counter();
+    while (hpet_read_counter() == start);
+    start = hpet_read_counter();
+    uint64_t tsc_start = read_tsc_serialized();
+
+    uint64_t now;
+    while ((now = hpet_read_counter()) - start < ticks);
+    uint64_t tsc_end = read_tsc_serialized();
+
+    // scale by what actually elapsed, the loop overshoots by up to one read
+    return (tsc_end - tsc_start) * hpet_hz / (now - start);
+}
+
+int8_t hpet_timer_setup(uint8_t timer, uint8_t irq, IRQHandler_t handler) {
+    if (timer >= hpet_timer_count())
+        return -1;
+
+    uint64_t config = hpet_read(HPET_REG_TIMER_CONFIG(timer));
+    uint8_t vector = APIC_IRQ_VECTOR_BASE + irq;
+
+    config &= ~(HPET_TN_INT_ENABLE | HPET_TN_PERIODIC | HPET_TN_LEVEL |
+                HPET_TN_32BIT_MODE | HPET_TN_FSB_ENABLE | HPET_TN_ROUTE_MASK);
+
+    if (config & HPET_TN_FSB_CAP) {
+        // message delivery straight to the local APIC, no IOAPIC involved
+        uint64_t address = APIC_BASE | (LAPIC_GetID() << 12);
+        hpet_write(HPET_REG_TIMER_FSB_ROUTE(timer), (address << 32) | vector);
+        config |= HPET_TN_FSB_ENABLE;
+    } else {
+        // pick the highest pin it allows, those are the least likely to be shared
+        uint32_t pins = HPET_TN_ROUTE_CAP(config);
+        if (pins == 0)
+            return -1;
+        // the route field counts GSIs, edge triggered, active high, to this CPU
+        uint32_t pin = 31 - __builtin_clz(pins);
+        if (irq_route(pin, vector, smp_cpu_id(), IRQ_TRIGGER_EDGE, IRQ_POLARITY_HIGH) != 0)
+            return -1;
+        config |= (uint64_t)pin << HPET_TN_ROUTE_SHIFT;
+    }
+
+    APIC_IRQ_RegisterHandler(irq, handler);
+    hpet_write(HPET_REG_TIMER_CONFIG(timer), config);
+    return 0;
+}
+
+int8_t hpet_timer_oneshot(uint8_t timer, uint64_t delta_ns) {
+    if (timer >= hpet_timer_count())
+        return -1;
+
+    if (delta_ns < HPET_MIN_DELTA_NS)
+        delta_ns = HPET_MIN_DELTA_NS;
+
+    uint64_t config = hpet_read(HPET_REG_TIMER_CONFIG(timer));
+    bool wide = hpet_counter_64bit && (config & HPET_TN_64BIT_CAP);
+    uint64_t deadline = hpet_read_counter() + clock_scale_apply(hpet_from_ns, delta_ns);
+
+    // comparators only fire on an exact match, so check we did not write
+    // one the counter has already run past
+    hpet_write(HPET_REG_TIMER_COMPARATOR(timer), wide ? deadline : (uint32_t)deadline);
+    hpet_write(HPET_REG_TIMER_CONFIG(timer), config | HPET_TN_INT_ENABLE);
+
+    int64_t left = (int64_t)(deadline - hpet_read_counter());
+    return left > 0 ? 0 : -1;
+}
+
+void hpet_timer_cancel(uint8_t timer) {
+    if (timer >= hpet_timer_count())
+        return;
+    hpet_write(HPET_REG_TIMER_CONFIG(timer), hpet_read(HPET_REG_TIMER_CONFIG(timer)) & ~HPET_TN_INT_ENABLE);
+}
@@ -0,0 +1,119 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: hpet.h
+    Description: HPET driver for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef HPET_H
+#define HPET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "drivers/acpi/includes/acpi.h"
+#include "drivers/pic/includes/pic_irq.h"
+
+// ACPI "HPET" table
+typedef struct __attribute__((packed)) {
+    acpi_sdt_header_t header;
+    uint32_t event_timer_block_id;
+    acpi_gas_t base_address;
+    uint8_t hpet_number;
+    uint16_t minimum_tick;      // smallest periodic tick without lost interrupts
+    uint8_t page_protection;
+} acpi_hpet_t;
+
+// General registers
+#define HPET_REG_CAPABILITIES   0x000
+#define HPET_REG_CONFIG         0x010
+#define HPET_REG_INT_STATUS     0x020
+#define HPET_REG_MAIN_COUNTER   0x0F0
+
+// Per timer registers, 0x20 apart
+#define HPET_REG_TIMER_CONFIG(n)     (0x100 + 0x20 * (n))
+#define HPET_REG_TIMER_COMPARATOR(n) (0x108 + 0x20 * (n))
+#define HPET_REG_TIMER_FSB_ROUTE(n)  (0x110 + 0x20 * (n))
+
+// HPET_REG_CAPABILITIES
+#define HPET_CAP_COUNT_64BIT    (1ull << 13)
+#define HPET_CAP_LEGACY_ROUTE   (1ull << 15)
+#define HPET_CAP_NUM_TIMERS(c)  ((((c) >> 8) & 0x1F) + 1)
+#define HPET_CAP_PERIOD_FS(c)   ((c) >> 32)     // femtoseconds per tick
+
+// HPET_REG_CONFIG
+#define HPET_CFG_ENABLE         (1ull << 0)
+#define HPET_CFG_LEGACY_ROUTE   (1ull << 1)
+
+// HPET_REG_TIMER_CONFIG
+#define HPET_TN_LEVEL           (1ull << 1)
+#define HPET_TN_INT_ENABLE      (1ull << 2)
+#define HPET_TN_PERIODIC        (1ull << 3)
+#define HPET_TN_PERIODIC_CAP    (1ull << 4)
+#define HPET_TN_64BIT_CAP       (1ull << 5)
+#define HPET_TN_VAL_SET         (1ull << 6)
+#define HPET_TN_32BIT_MODE      (1ull << 8)
+#define HPET_TN_ROUTE_SHIFT     9
+#define HPET_TN_ROUTE_MASK      (0x1Full << HPET_TN_ROUTE_SHIFT)
+#define HPET_TN_FSB_ENABLE      (1ull << 14)
+#define HPET_TN_FSB_CAP         (1ull << 15)
+#define HPET_TN_ROUTE_CAP(c)    ((uint32_t)((c) >> 32))
+
+#define HPET_MAX_TIMERS 32
+
+int8_t hpet_init(void);
+bool hpet_available(void);
+
+uint64_t hpet_read_counter(void);   // free running, extended to 64 bits
+uint64_t hpet_frequency(void);      // ticks per second
+uint64_t hpet_period_fs(void);
+uint64_t hpet_ns(void);             // counter converted to ns
+uint8_t hpet_timer_count(void);
+bool hpet_counter_is_64bit(void);
+
+int8_t hpet_delay_us(uint32_t micros);
+
+// TSC ticks per second, measured over `ms` milliseconds of HPET time
+uint64_t hpet_measure_tsc_hz(uint32_t ms);
+
+// Comparators. hpet_timer_setup() routes timer `timer` to APIC IRQ `irq`
+// (through FSB/MSI delivery when the timer supports it, otherwise an IOAPIC
+// pin) and installs `handler`. hpet_timer_oneshot() then fires it once,
+// delta_ns from now; it returns -1 if the deadline had already passed by the
+// time the comparator was written, in which case no interrupt will come.
+int8_t hpet_timer_setup(uint8_t timer, uint8_t irq, IRQHandler_t handler);
+int8_t hpet_timer_oneshot(uint8_t timer, uint64_t delta_ns);
+void hpet_timer_cancel(uint8_t timer);
+
+#endif // HPET_H
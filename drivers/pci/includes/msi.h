@@ -0,0 +1,123 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: msi.h
+    Description: MSI and MSI-X interrupt delivery for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef MSI_H
+#define MSI_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Message signalled interrupts. The device writes the vector straight into
+ * one CPU's local APIC, so there is no IOAPIC pin to share and the handler
+ * runs on the CPU that was picked for it. Every CPU has its own pool of
+ * vectors MSI_VECTOR_FIRST-MSI_VECTOR_LAST, the same vector on two CPUs is
+ * two different interrupts.
+ *
+ * MSI gives a function one vector here. MSI-X has a table of them that can
+ * be pointed at different CPUs and masked one at a time, which is what a
+ * device with a queue per CPU wants: pci_msix_setup_queues() puts entry i
+ * on the i-th online CPU.
+ *
+ * Handlers run in interrupt context with the EOI still to come, they take
+ * the argument given when the vector was set up.
+ */
+
+#define MSI_VECTOR_FIRST    0x60    // above the APIC IRQ range (0x20-0x5F)
+#define MSI_VECTOR_LAST     0xEF
+#define MSI_VECTORS         (MSI_VECTOR_LAST - MSI_VECTOR_FIRST + 1)
+#define MSI_ANY_CPU         UINT32_MAX  // the CPU with the fewest vectors in use
+
+#define MSI_ADDRESS_BASE    0xFEE00000  // destination APIC ID in bits 12-19
+
+// message control, upper half of the capability's first dword
+#define MSI_CTRL_ENABLE         0x0001
+#define MSI_CTRL_MME_MASK       0x0070  // messages enabled, log2
+#define MSI_CTRL_64BIT          0x0080
+#define MSI_CTRL_MASKABLE       0x0100  // per-vector mask bits present
+
+#define MSIX_CTRL_TABLE_SIZE    0x07FF  // entries - 1
+#define MSIX_CTRL_FUNC_MASK     0x4000
+#define MSIX_CTRL_ENABLE        0x8000
+#define MSIX_BIR_MASK           0x7
+
+// MSI-X table entry, 16 bytes
+#define MSIX_ENTRY_SIZE         16
+#define MSIX_ENTRY_ADDR_LO      0
+#define MSIX_ENTRY_ADDR_HI      1
+#define MSIX_ENTRY_DATA         2
+#define MSIX_ENTRY_CTRL         3       // bit 0 masks the entry
+#define MSIX_ENTRY_MASKED       0x1
+
+typedef void (*msi_handler_t)(void *arg);
+
+typedef struct {
+    uint32_t cpu;
+    uint8_t vector;             // 0 while the entry has none
+} msix_route_t;
+
+typedef struct {
+    uint8_t bus, device, func;
+    uint8_t cap;                // config space offset of the capability
+    uint16_t entries;
+    volatile uint32_t *table;
+    msix_route_t *routes;
+} pci_msix_t;
+
+void msi_init(void);            // claims the vectors in the IDT
+
+// a free vector on cpu, -1 when its pool is empty
+int16_t msi_vector_alloc(uint32_t cpu, msi_handler_t handler, void *arg);
+void msi_vector_free(uint32_t cpu, uint8_t vector);    // sleeps for a grace period
+
+int8_t pci_msi_enable(uint8_t bus, uint8_t device, uint8_t func, uint32_t cpu, msi_handler_t handler, void *arg);
+void pci_msi_disable(uint8_t bus, uint8_t device, uint8_t func);
+int8_t pci_msi_mask(uint8_t bus, uint8_t device, uint8_t func, bool masked);   // -1 without mask bits
+
+// maps the table and enables MSI-X with every entry masked
+int8_t pci_msix_init(pci_msix_t *msix, uint8_t bus, uint8_t device, uint8_t func);
+int8_t pci_msix_set_vector(pci_msix_t *msix, uint16_t entry, uint32_t cpu, msi_handler_t handler, void *arg);
+void pci_msix_clear_vector(pci_msix_t *msix, uint16_t entry);
+void pci_msix_mask(pci_msix_t *msix, uint16_t entry);
+void pci_msix_unmask(pci_msix_t *msix, uint16_t entry);
+int8_t pci_msix_setup_queues(pci_msix_t *msix, uint16_t queues, msi_handler_t handler, void **args);
+void pci_msix_disable(pci_msix_t *msix);
+
+void msi_print_vectors(void);
+
+#endif // MSI_H
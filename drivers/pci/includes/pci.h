@@ -44,12 +44,32 @@
 #define PCI_CONFIG_ADDRESS 0xCF8
 #define PCI_CONFIG_DATA    0xCFC
 
+// type 0 header
+#define PCI_COMMAND        0x04    // command in the low half, status in the high half
+#define PCI_CAP_POINTER    0x34
+#define PCI_INTERRUPT_LINE 0x3C
+
+#define PCI_COMMAND_MEMORY        0x0002
+#define PCI_COMMAND_BUS_MASTER    0x0004
+#define PCI_COMMAND_INTX_DISABLE  0x0400
+#define PCI_STATUS_CAP_LIST       0x0010
+
+#define PCI_BAR_IO                0x1
+#define PCI_BAR_TYPE_MASK         0x6
+#define PCI_BAR_TYPE_64           0x4
+
+#define PCI_CAP_ID_MSI     0x05
+#define PCI_CAP_ID_MSIX    0x11
+
 // Read from PCI config space
 uint32_t pci_read(uint8_t bus, uint8_t device, uint8_t func, uint8_t offset);
 void pci_write(uint8_t bus, uint8_t device, uint8_t func, uint8_t offset, uint32_t data);
 void scan_pci_bus(uint8_t bus);
 uint32_t pci_get_bar_size(uint8_t bus, uint8_t device, uint8_t func, uint8_t offset);
 uint32_t pci_read_bar(uint8_t bus, uint8_t device, uint8_t func, uint8_t bar_num);
+uint64_t pci_bar_address(uint8_t bus, uint8_t device, uint8_t func, uint8_t bar_num);
+uint8_t pci_find_capability(uint8_t bus, uint8_t device, uint8_t func, uint8_t cap_id);
+void pci_set_command(uint8_t bus, uint8_t device, uint8_t func, uint16_t set, uint16_t clear);
 // Start PCI enumeration for USB and storage devices
 void start_pci_enumeration(void);
 
@@ -0,0 +1,379 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: msi.c
+    Description: MSI and MSI-X interrupt delivery for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/msi.h"
+#include "includes/pci.h"
+#include "arch/x86_64/includes/isr.h"
+#include "drivers/pic/includes/apic/apic.h"
+#include "kernel/system/includes/smp.h"
+#include "kernel/system/includes/spinlock.h"
+#include "kernel/system/includes/rcu.h"
+#include "kernel/sched/includes/sched.h"
+#include "arch/x86_64/includes/fpu.h"
+#include "mm/includes/vmm.h"
+#include "tools/includes/log-info.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#define MSI_POOL_WORDS  ((MSI_VECTORS + 63) / 64)
+
+typedef struct {
+    msi_handler_t handler;
+    void *arg;
+    uint64_t count;
+} msi_vector_t;
+
+// Looked up under RCU from the interrupt. A vector stays reserved in the
+// pool until a grace period after its handler is gone, so a message still
+// in flight from the old owner never reaches a new one
+static msi_vector_t *msi_table[SMP_MAX_CPUS][MSI_VECTORS];
+static uint64_t msi_reserved[SMP_MAX_CPUS][MSI_POOL_WORDS];
+static uint32_t msi_in_use[SMP_MAX_CPUS];
+static spinlock_t msi_lock = SPINLOCK_INIT;
+
+static void msi_irq_entry(Registers_t *regs) {
+    cpu_t *cpu = this_cpu();
+    uint32_t index = regs->interrupt - MSI_VECTOR_FIRST;
+    cpu->irqs++;
+    bool fpu_parked = fpu_irq_enter();
+
+    msi_vector_t *vector = rcu_dereference(msi_table[cpu->id][index]);
+    if (vector != NULL) {
+        vector->count++;
+        vector->handler(vector->arg);
+    } else {
+        SERIAL(Warn, msi_irq_entry, "Spurious MSI vector 0x%lx on CPU %u\n", regs->interrupt, cpu->id);
+    }
+    fpu_irq_exit(fpu_parked);
+
+    LAPIC_SendEOI();
+    sched_irq_exit();
+}
+
+void msi_init(void) {
+    for (uint32_t vector = MSI_VECTOR_FIRST; vector <= MSI_VECTOR_LAST; vector++)
+        ISR_RegisterHandler(vector, msi_irq_entry);
+}
+
+static uint32_t msi_pick_cpu(void) {
+    uint32_t best = smp_cpu_id();
+
+    for (uint32_t id = 0; id < SMP_MAX_CPUS; id++) {
+        cpu_t *cpu = smp_cpu(id);
+        if (cpu->online && msi_in_use[id] < msi_in_use[best])
+            best = id;
+    }
+    return best;
+}
+
+int16_t msi_vector_alloc(uint32_t cpu, msi_handler_t handler, void *arg) {
+    if (cpu == MSI_ANY_CPU)
+        cpu = msi_pick_cpu();
+    cpu_t *target = smp_cpu(cpu);
+    if (target == NULL || !target->online || handler == NULL)
+        return -1;
+
+    msi_vector_t *vector = malloc(sizeof(msi_vector_t));
+    if (vector == NULL)
+        return -1;
+    vector->handler = handler;
+    vector->arg = arg;
+    vector->count = 0;
+
+    uint64_t flags = spin_lock_irqsave(&msi_lock);
+    for (uint32_t index = 0; index < MSI_VECTORS; index++) {
+        uint64_t bit = 1UL << (index % 64);
+        if (msi_reserved[cpu][index / 64] & bit)
+            continue;
+
+        msi_reserved[cpu][index / 64] |= bit;
+        msi_in_use[cpu]++;
+        rcu_assign_pointer(msi_table[cpu][index], vector);
+        spin_unlock_irqrestore(&msi_lock, flags);
+        return MSI_VECTOR_FIRST + index;
+    }
+    spin_unlock_irqrestore(&msi_lock, flags);
+
+    free(vector);
+    LOG_WARN("CPU %u has no MSI vectors left\n", cpu);
+    SERIAL(Warn, msi_vector_alloc, "CPU %u has no MSI vectors left\n", cpu);
+    return -1;
+}
+
+void msi_vector_free(uint32_t cpu, uint8_t vector) {
+    if (cpu >= SMP_MAX_CPUS || vector < MSI_VECTOR_FIRST || vector > MSI_VECTOR_LAST)
+        return;
+    uint32_t index = vector - MSI_VECTOR_FIRST;
+
+    uint64_t flags = spin_lock_irqsave(&msi_lock);
+    msi_vector_t *old = msi_table[cpu][index];
+    rcu_assign_pointer(msi_table[cpu][index], NULL);
+    spin_unlock_irqrestore(&msi_lock, flags);
+    if (old == NULL)
+        return;
+
+    synchronize_rcu();
+    free(old);
+
+    flags = spin_lock_irqsave(&msi_lock);
+    msi_reserved[cpu][index / 64] &= ~(1UL << (index % 64));
+    msi_in_use[cpu]--;
+    spin_unlock_irqrestore(&msi_lock, flags);
+}
+
+// fixed delivery, edge triggered, physical destination
+static uint32_t msi_address(uint32_t cpu) {
+    return MSI_ADDRESS_BASE | (smp_cpu(cpu)->lapic_id << 12);
+}
+
+static uint32_t msi_cpu_for_address(uint32_t address) {
+    uint32_t lapic_id = (address >> 12) & 0xFF;
+
+    for (uint32_t id = 0; id < SMP_MAX_CPUS; id++) {
+        cpu_t *cpu = smp_cpu(id);
+        if (cpu->started && cpu->lapic_id == lapic_id)
+            return id;
+    }
+    return 0;
+}
+
+static void msi_write_control(uint8_t bus, uint8_t device, uint8_t func, uint8_t cap, uint16_t control) {
+    uint32_t header = pci_read(bus, device, func, cap);
+    pci_write(bus, device, func, cap, (header & 0xFFFF) | ((uint32_t)control << 16));
+}
+
+// the data register sits after the high address half when there is one
+static uint8_t msi_data_offset(uint8_t cap, uint16_t control) {
+    return cap + ((control & MSI_CTRL_64BIT) ? 0x0C : 0x08);
+}
+
+int8_t pci_msi_enable(uint8_t bus, uint8_t device, uint8_t func, uint32_t cpu, msi_handler_t handler, void *arg) {
+    uint8_t cap = pci_find_capability(bus, device, func, PCI_CAP_ID_MSI);
+    if (cap == 0)
+        return -1;
+
+    if (cpu == MSI_ANY_CPU)
+        cpu = msi_pick_cpu();
+    int16_t vector = msi_vector_alloc(cpu, handler, arg);
+    if (vector < 0)
+        return -1;
+
+    // off while it is reprogrammed, and asking for a single message
+    uint16_t control = pci_read(bus, device, func, cap) >> 16;
+    control &= ~(MSI_CTRL_ENABLE | MSI_CTRL_MME_MASK);
+    msi_write_control(bus, device, func, cap, control);
+
+    pci_write(bus, device, func, cap + 0x04, msi_address(cpu));
+    if (control & MSI_CTRL_64BIT)
+        pci_write(bus, device, func, cap + 0x08, 0);
+    pci_write(bus, device, func, msi_data_offset(cap, control), (uint32_t)vector);
+    if (control & MSI_CTRL_MASKABLE)
+        pci_write(bus, device, func, msi_data_offset(cap, control) + 4, 0);
+
+    pci_set_command(bus, device, func, PCI_COMMAND_BUS_MASTER | PCI_COMMAND_INTX_DISABLE, 0);
+    msi_write_control(bus, device, func, cap, control | MSI_CTRL_ENABLE);
+
+    LOG_INFO("MSI for %u:%u.%u on CPU %u, vector 0x%x\n", bus, device, func, cpu, vector);
+    SERIAL(Info, pci_msi_enable, "MSI for %u:%u.%u on CPU %u, vector 0x%x\n", bus, device, func, cpu, vector);
+    return 0;
+}
+
+void pci_msi_disable(uint8_t bus, uint8_t device, uint8_t func) {
+    uint8_t cap = pci_find_capability(bus, device, func, PCI_CAP_ID_MSI);
+    if (cap == 0)
+        return;
+
+    uint16_t control = pci_read(bus, device, func, cap) >> 16;
+    if (!(control & MSI_CTRL_ENABLE))
+        return;
+
+    uint32_t cpu = msi_cpu_for_address(pci_read(bus, device, func, cap + 0x04));
+    uint8_t vector = pci_read(bus, device, func, msi_data_offset(cap, control)) & 0xFF;
+
+    msi_write_control(bus, device, func, cap, control & ~MSI_CTRL_ENABLE);
+    pci_set_command(bus, device, func, 0, PCI_COMMAND_INTX_DISABLE);
+    msi_vector_free(cpu, vector);
+}
+
+int8_t pci_msi_mask(uint8_t bus, uint8_t device, uint8_t func, bool masked) {
+    uint8_t cap = pci_find_capability(bus, device, func, PCI_CAP_ID_MSI);
+    if (cap == 0)
+        return -1;
+
+    uint16_t control = pci_read(bus, device, func, cap) >> 16;
+    if (!(control & MSI_CTRL_MASKABLE))
+        return -1;
+
+    pci_write(bus, device, func, msi_data_offset(cap, control) + 4, masked ? 1 : 0);
+    return 0;
+}
+
+static volatile uint32_t *msix_entry(pci_msix_t *msix, uint16_t entry) {
+    return msix->table + entry * (MSIX_ENTRY_SIZE / sizeof(uint32_t));
+}
+
+static void msix_write_control(pci_msix_t *msix, uint16_t control) {
+    msi_write_control(msix->bus, msix->device, msix->func, msix->cap, control);
+}
+
+int8_t pci_msix_init(pci_msix_t *msix, uint8_t bus, uint8_t device, uint8_t func) {
+    uint8_t cap = pci_find_capability(bus, device, func, PCI_CAP_ID_MSIX);
+    if (cap == 0)
+        return -1;
+
+    uint16_t control = pci_read(bus, device, func, cap) >> 16;
+    uint32_t table_reg = pci_read(bus, device, func, cap + 0x04);
+    uint64_t bar = pci_bar_address(bus, device, func, table_reg & MSIX_BIR_MASK);
+    if (bar == 0)
+        return -1;
+
+    msix->bus = bus;
+    msix->device = device;
+    msix->func = func;
+    msix->cap = cap;
+    msix->entries = (control & MSIX_CTRL_TABLE_SIZE) + 1;
+    msix->routes = calloc(msix->entries, sizeof(msix_route_t));
+    if (msix->routes == NULL)
+        return -1;
+
+    uint64_t table = bar + (table_reg & ~(uint32_t)MSIX_BIR_MASK);
+    for (uint64_t page = table & ~0xFFFull; page < table + msix->entries * MSIX_ENTRY_SIZE; page += 0x1000)
+        map_page(page, page, PTE_WRITABLE | PTE_CACHE_DISABLE | PTE_WRITE_THROUGH);
+    msix->table = (volatile uint32_t *)table;
+
+    // the function mask holds everything back while the entries are masked one by one
+    control |= MSIX_CTRL_ENABLE | MSIX_CTRL_FUNC_MASK;
+    msix_write_control(msix, control);
+    for (uint16_t entry = 0; entry < msix->entries; entry++)
+        msix_entry(msix, entry)[MSIX_ENTRY_CTRL] = MSIX_ENTRY_MASKED;
+    pci_set_command(bus, device, func, PCI_COMMAND_BUS_MASTER | PCI_COMMAND_INTX_DISABLE, 0);
+    msix_write_control(msix, control & ~MSIX_CTRL_FUNC_MASK);
+
+    LOG_INFO("MSI-X for %u:%u.%u, %u entries\n", bus, device, func, msix->entries);
+    SERIAL(Info, pci_msix_init, "MSI-X for %u:%u.%u, %u entries\n", bus, device, func, msix->entries);
+    return 0;
+}
+
+void pci_msix_mask(pci_msix_t *msix, uint16_t entry) {
+    if (entry < msix->entries)
+        msix_entry(msix, entry)[MSIX_ENTRY_CTRL] |= MSIX_ENTRY_MASKED;
+}
+
+void pci_msix_unmask(pci_msix_t *msix, uint16_t entry) {
+    if (entry < msix->entries)
+        msix_entry(msix, entry)[MSIX_ENTRY_CTRL] &= ~MSIX_ENTRY_MASKED;
+}
+
+// the entry is masked while its message changes, a half written one never fires
+int8_t pci_msix_set_vector(pci_msix_t *msix, uint16_t entry, uint32_t cpu, msi_handler_t handler, void *arg) {
+    if (entry >= msix->entries)
+        return -1;
+    if (msix->routes[entry].vector != 0)
+        pci_msix_clear_vector(msix, entry);
+
+    if (cpu == MSI_ANY_CPU)
+        cpu = msi_pick_cpu();
+    int16_t vector = msi_vector_alloc(cpu, handler, arg);
+    if (vector < 0)
+        return -1;
+
+    volatile uint32_t *slot = msix_entry(msix, entry);
+    slot[MSIX_ENTRY_CTRL] |= MSIX_ENTRY_MASKED;
+    slot[MSIX_ENTRY_ADDR_LO] = msi_address(cpu);
+    slot[MSIX_ENTRY_ADDR_HI] = 0;
+    slot[MSIX_ENTRY_DATA] = (uint32_t)vector;
+    msix->routes[entry].cpu = cpu;
+    msix->routes[entry].vector = vector;
+    slot[MSIX_ENTRY_CTRL] &= ~MSIX_ENTRY_MASKED;
+    return 0;
+}
+
+void pci_msix_clear_vector(pci_msix_t *msix, uint16_t entry) {
+    if (entry >= msix->entries || msix->routes[entry].vector == 0)
+        return;
+
+    pci_msix_mask(msix, entry);
+    msi_vector_free(msix->routes[entry].cpu, msix->routes[entry].vector);
+    msix->routes[entry].vector = 0;
+}
+
+// entry i on the i-th online CPU, wrapping around, so each CPU completes its own queue
+int8_t pci_msix_setup_queues(pci_msix_t *msix, uint16_t queues, msi_handler_t handler, void **args) {
+    if (queues > msix->entries)
+        return -1;
+
+    uint32_t id = 0;
+    for (uint16_t queue = 0; queue < queues; queue++) {
+        while (!smp_cpu(id)->online)
+            id = (id + 1) % SMP_MAX_CPUS;
+        if (pci_msix_set_vector(msix, queue, id, handler, args != NULL ? args[queue] : NULL) != 0)
+            return -1;
+        id = (id + 1) % SMP_MAX_CPUS;
+    }
+    return 0;
+}
+
+void pci_msix_disable(pci_msix_t *msix) {
+    uint16_t control = pci_read(msix->bus, msix->device, msix->func, msix->cap) >> 16;
+
+    msix_write_control(msix, control | MSIX_CTRL_FUNC_MASK);
+    for (uint16_t entry = 0; entry < msix->entries; entry++)
+        pci_msix_clear_vector(msix, entry);
+    msix_write_control(msix, control & ~(MSIX_CTRL_ENABLE | MSIX_CTRL_FUNC_MASK));
+    pci_set_command(msix->bus, msix->device, msix->func, 0, PCI_COMMAND_INTX_DISABLE);
+
+    free(msix->routes);
+    msix->routes = NULL;
+    msix->entries = 0;
+}
+
+void msi_print_vectors(void) {
+    printf("cpu  vector  interrupts\n");
+    for (uint32_t id = 0; id < SMP_MAX_CPUS; id++) {
+        if (msi_in_use[id] == 0)
+            continue;
+
+        rcu_read_lock();
+        for (uint32_t index = 0; index < MSI_VECTORS; index++) {
+            msi_vector_t *vector = rcu_dereference(msi_table[id][index]);
+            if (vector != NULL)
+                printf("%-4u 0x%-5x %lu\n", id, MSI_VECTOR_FIRST + index, vector->count);
+        }
+        rcu_read_unlock();
+    }
+}
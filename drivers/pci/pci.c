@@ -114,13 +114,14 @@ void scan_pci_device(uint8_t bus, uint8_t device) {
                     type = "SATA AHCI";
                     uint32_t bar5 = pci_read(bus, device, func, 0x24);
                     uint32_t ahci_base = bar5 & 0xFFFFFFF0;
-                    LOG_INFO("AHCI MMIO base address: %x\n", ahci_base);
-                    SERIAL(Info, scan_pci_device, "AHCI MMIO base address: %x\n", ahci_base);
+                    LOG_INFO("AHCI MMIO base address: 0x%x\n", ahci_base);
+                    SERIAL(Info, scan_pci_device, "AHCI MMIO base address: 0x%x\n", ahci_base);
                     pid_rn = 7;
                     
                     // Map MMIO region with cache disabled for device memory
                     map_page(ahci_base, ahci_base, PTE_WRITABLE | PTE_CACHE_DISABLE | PTE_WRITE_THROUGH);
                     
+                    sata_irq_init(bus, device, func, ahci_base);
                     sata_search(ahci_base);
                 } else {
                     type = "SATA (non-AHCI)";
@@ -211,4 +212,42 @@ uint32_t pci_read_bar(uint8_t bus, uint8_t device, uint8_t func, uint8_t bar_num
     if (bar_num > 5) return 0; // PCI has 6 BARs (0-5)
     uint8_t offset = 0x10 + (bar_num * 4);
     return pci_read(bus, device, func, offset);
-}
\ No newline at end of file
+}
+
+// memory BAR as a full physical address, a 64-bit BAR takes the next one along for the high half
+uint64_t pci_bar_address(uint8_t bus, uint8_t device, uint8_t func, uint8_t bar_num) {
+    uint32_t bar = pci_read_bar(bus, device, func, bar_num);
+    if (bar & PCI_BAR_IO)
+        return 0;
+
+    uint64_t address = bar & ~0xFull;
+    if ((bar & PCI_BAR_TYPE_MASK) == PCI_BAR_TYPE_64 && bar_num < 5)
+        address |= (uint64_t)pci_read_bar(bus, device, func, bar_num + 1) << 32;
+    return address;
+}
+
+// config space offset of the capability, 0 if the function does not have it
+uint8_t pci_find_capability(uint8_t bus, uint8_t device, uint8_t func, uint8_t cap_id) {
+    uint16_t status = pci_read(bus, device, func, PCI_COMMAND) >> 16;
+    if (!(status & PCI_STATUS_CAP_LIST))
+        return 0;
+
+    uint8_t offset = pci_read(bus, device, func, PCI_CAP_POINTER) & 0xFC;
+    // the list lives in the 192 bytes after the header, a loop in it is a broken device
+    for (uint32_t hops = 0; offset >= 0x40 && hops < 48; hops++) {
+        uint32_t header = pci_read(bus, device, func, offset);
+        if ((header & 0xFF) == cap_id)
+            return offset;
+        offset = (header >> 8) & 0xFC;
+    }
+    return 0;
+}
+
+// bus mastering lets the device write MSI messages, INTx is turned off once those take over
+void pci_set_command(uint8_t bus, uint8_t device, uint8_t func, uint16_t set, uint16_t clear) {
+    uint32_t reg = pci_read(bus, device, func, PCI_COMMAND);
+    uint16_t command = ((uint16_t)reg | set) & ~clear;
+
+    // the status half is write-1-to-clear, writing it back as read would clear its error bits
+    pci_write(bus, device, func, PCI_COMMAND, command);
+}
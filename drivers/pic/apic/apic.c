@@ -122,4 +122,45 @@ void APIC_Initialize(void) {
     LOG_INFO("APIC initialized successfully\n");
     SERIAL(Info, APIC_Initialize, "APIC initialized successfully\n");
 
-}
\ No newline at end of file
+}
+
+// the IOAPIC and handlers are already set up by the BSP, an AP only has to
+// switch its own local APIC on and accept every priority
+void LAPIC_InitializeCPU(void) {
+    uint32_t eax, edx;
+
+    WriteCR4(ReadCR4() | CR4_APIC_BIT);
+    cpuGetMSR(IA32_APIC_BASE_MSR, &eax, &edx);
+    if (!(eax & IA32_APIC_BASE_MSR_ENABLE))
+        cpuSetMSR(IA32_APIC_BASE_MSR, eax | IA32_APIC_BASE_MSR_ENABLE, edx);
+
+    APIC_Write(APIC_TPR, 0);
+    APIC_Write(APIC_SVR, APIC_Read(APIC_SVR) | 0x100 | 0xFF);
+}
+
+// the write to the low half sends it, so the destination has to be set first
+// and neither half may be touched by an interrupt handler in between
+void LAPIC_SendIPI(uint32_t lapic_id, uint8_t vector) {
+    uint64_t flags = irq_save();
+
+    while (APIC_Read(APIC_ICR_LOW) & APIC_ICR_PENDING)
+        __asm__ volatile("pause");
+    APIC_Write(APIC_ICR_HIGH, lapic_id << 24);
+    APIC_Write(APIC_ICR_LOW, APIC_DELIVERY_MODE_FIXED | vector);
+    irq_restore(flags);
+}
+
+// select/window pair of any IOAPIC, the window is 16 bytes past the select
+uint32_t cpuReadIoApic(void *ioapicaddr, uint32_t reg) {
+    volatile uint32_t *ioapic = (volatile uint32_t *)ioapicaddr;
+
+    ioapic[IOAPIC_REG_SELECT / sizeof(uint32_t)] = reg;
+    return ioapic[IOAPIC_REG_WINDOW / sizeof(uint32_t)];
+}
+
+void cpuWriteIoApic(void *ioapicaddr, uint32_t reg, uint32_t value) {
+    volatile uint32_t *ioapic = (volatile uint32_t *)ioapicaddr;
+
+    ioapic[IOAPIC_REG_SELECT / sizeof(uint32_t)] = reg;
+    ioapic[IOAPIC_REG_WINDOW / sizeof(uint32_t)] = value;
+}
@@ -46,6 +46,10 @@
 #include <stdio.h>
 #include "tools/includes/log-info.h"
 #include "tools/includes/serial.h"
+#include "kernel/system/includes/percpu.h"
+#include "kernel/sched/includes/sched.h"
+#include "kernel/system/includes/rcu.h"
+#include "arch/x86_64/includes/fpu.h"
 
 #define APIC_REMAP_OFFSET        0x20  // remap base for APIC interrupts
 #define MAX_IRQS                 64    // set for simplicity (i can NOT debug for more than 30 minutes)
@@ -60,22 +64,31 @@ IRQHandler_t g_APICIRQHandler_ts[MAX_IRQS];
 // interrupt handler for APIC IRQs
 void APIC_IRQ_Handler(Registers_t* regs) {
     int irq = regs->interrupt - APIC_REMAP_OFFSET;
+    this_cpu()->irqs++;
 
     // read the IRR (Interrupt Request Register) and ISR (In-Service Register) from the APIC
     uint32_t apic_isr = APIC_Read(APIC_ISR);  
     uint32_t apic_irr = APIC_Read(APIC_IRR);  
 
-    // check if the IRQ has a registered handler
-    if (g_APICIRQHandler_ts[irq] != NULL) {
+    // handlers may use vector registers, through klibc if nothing else
+    bool fpu_parked = fpu_irq_enter();
+
+    // check if the IRQ has a registered handler, we are an RCU reader
+    IRQHandler_t handler = rcu_dereference(g_APICIRQHandler_ts[irq]);
+    if (handler != NULL) {
         // call the handler for the specific interrupt
-        g_APICIRQHandler_ts[irq](regs);
+        handler(regs);
     } else {
         LOG_WARN("APIC_IRQ_Handler: Unhandled APIC IRQ %d  ISR=%x  IRR=%x...\n", irq, apic_isr, apic_irr);
         SERIAL(Warn, APIC_IRQ_Handler, "Unhandled APIC IRQ %d  ISR=%x  IRR=%x...\n", irq, apic_isr, apic_irr);
     }
+    fpu_irq_exit(fpu_parked);
 
     // send EOI to the APIC
     LAPIC_SendEOI();
+
+    // after the EOI, the task switched to may not come back here for a while
+    sched_irq_exit();
 }
 
 void APIC_IRQ_Initialize() {
@@ -99,7 +112,16 @@ void APIC_IRQ_RegisterHandler(uint32_t irq, IRQHandler_t handler) {
         return;
     }
 
-    g_APICIRQHandler_ts[irq] = handler;
+    rcu_assign_pointer(g_APICIRQHandler_ts[irq], handler);
+}
+
+// whatever the old handler uses may be freed once this returns
+void APIC_IRQ_UnregisterHandler(uint32_t irq) {
+    if (irq >= MAX_IRQS)
+        return;
+
+    rcu_assign_pointer(g_APICIRQHandler_ts[irq], NULL);
+    synchronize_rcu();
 }
 
 // set up a specific LVT entry (e.g., LINT0 or Timer) to enable interrupts
@@ -0,0 +1,268 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: ioapic.c
+    Description: IOAPIC interrupt routing from the ACPI MADT for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "drivers/pic/includes/apic/ioapic.h"
+#include "drivers/pic/includes/apic/apic.h"
+#include "kernel/system/includes/smp.h"
+#include "kernel/system/includes/spinlock.h"
+#include "mm/includes/vmm.h"
+#include "tools/includes/log-info.h"
+#include <stdio.h>
+
+static ioapic_t ioapics[IOAPIC_MAX];
+static uint32_t ioapic_count;
+static uint32_t ioapic_cpus;
+static irq_isa_route_t isa_routes[IOAPIC_ISA_IRQS];
+
+// select and window are one register pair per IOAPIC, an interrupt handler
+// touching it between the two writes would redirect ours
+static spinlock_t ioapic_lock = SPINLOCK_INIT;
+
+static void ioapic_map(uint64_t address) {
+    map_page(address & ~0xFFFull, address & ~0xFFFull, PTE_WRITABLE | PTE_CACHE_DISABLE | PTE_WRITE_THROUGH);
+}
+
+static void ioapic_add(uint8_t id, uint64_t address, uint32_t gsi_base) {
+    if (ioapic_count == IOAPIC_MAX) {
+        LOG_WARN("Ignoring IOAPIC %u, only %u are supported\n", id, IOAPIC_MAX);
+        SERIAL(Warn, ioapic_add, "Ignoring IOAPIC %u, only %u are supported\n", id, IOAPIC_MAX);
+        return;
+    }
+
+    ioapic_map(address);
+    ioapic_t *io = &ioapics[ioapic_count++];
+    io->base = (volatile uint32_t *)address;
+    io->id = id;
+    io->gsi_base = gsi_base;
+    io->pins = ((cpuReadIoApic((void *)io->base, IOAPIC_REG_VERSION) >> 16) & 0xFF) + 1;
+
+    // nothing is routed until a driver asks for it
+    for (uint32_t pin = 0; pin < io->pins; pin++)
+        cpuWriteIoApic((void *)io->base, IOAPIC_REDIRECTION(pin), IOAPIC_REDIR_MASKED);
+
+    LOG_INFO("IOAPIC %u at 0x%lx, GSIs %u-%u\n", id, address, gsi_base, gsi_base + io->pins - 1);
+    SERIAL(Info, ioapic_add, "IOAPIC %u at 0x%lx, GSIs %u-%u\n", id, address, gsi_base, gsi_base + io->pins - 1);
+}
+
+static void ioapic_add_override(madt_override_t *iso) {
+    if (iso->bus != 0 || iso->source >= IOAPIC_ISA_IRQS)
+        return;
+
+    irq_isa_route_t *route = &isa_routes[iso->source];
+    route->gsi = iso->gsi;
+    // "conforms to the bus" is edge and active high for ISA
+    if ((iso->flags & MADT_TRIGGER_MASK) == MADT_TRIGGER_LEVEL)
+        route->trigger = IRQ_TRIGGER_LEVEL;
+    if ((iso->flags & MADT_POLARITY_MASK) == MADT_POLARITY_LOW)
+        route->polarity = IRQ_POLARITY_LOW;
+}
+
+int8_t ioapic_init(void) {
+    for (uint8_t irq = 0; irq < IOAPIC_ISA_IRQS; irq++)
+        isa_routes[irq] = (irq_isa_route_t){ irq, IRQ_TRIGGER_EDGE, IRQ_POLARITY_HIGH };
+
+    acpi_madt_t *madt = (acpi_madt_t *)acpi_find_table("APIC", 0);
+    if (madt == NULL) {
+        LOG_WARN("No ACPI MADT, assuming one IOAPIC at 0x%x\n", APIC_IO_BASE);
+        SERIAL(Warn, ioapic_init, "No ACPI MADT, assuming one IOAPIC at 0x%x\n", APIC_IO_BASE);
+        ioapic_add(0, APIC_IO_BASE, 0);
+        return -1;
+    }
+
+    uint64_t lapic_address = madt->lapic_address;
+    uint32_t overrides = 0;
+    uint8_t *entry = (uint8_t *)(madt + 1);
+    uint8_t *end = (uint8_t *)madt + madt->header.length;
+
+    while (entry + sizeof(madt_entry_t) <= end) {
+        madt_entry_t *header = (madt_entry_t *)entry;
+        if (header->length < sizeof(madt_entry_t) || entry + header->length > end)
+            break;
+
+        switch (header->type) {
+            case MADT_ENTRY_LAPIC:
+                if (((madt_lapic_t *)entry)->flags & (MADT_LAPIC_ENABLED | MADT_LAPIC_ONLINE_CAPABLE))
+                    ioapic_cpus++;
+                break;
+            case MADT_ENTRY_IOAPIC: {
+                madt_ioapic_t *io = (madt_ioapic_t *)entry;
+                ioapic_add(io->id, io->address, io->gsi_base);
+                break;
+            }
+            case MADT_ENTRY_OVERRIDE:
+                ioapic_add_override((madt_override_t *)entry);
+                overrides++;
+                break;
+            case MADT_ENTRY_LAPIC_ADDRESS:
+                lapic_address = ((madt_lapic_address_t *)entry)->address;
+                break;
+        }
+        entry += header->length;
+    }
+
+    if (ioapic_count == 0) {
+        LOG_WARN("MADT lists no IOAPIC, assuming one at 0x%x\n", APIC_IO_BASE);
+        SERIAL(Warn, ioapic_init, "MADT lists no IOAPIC, assuming one at 0x%x\n", APIC_IO_BASE);
+        ioapic_add(0, APIC_IO_BASE, 0);
+    }
+
+    // the inline APIC_ReadIO()/APIC_WriteIO() helpers talk to the one with the ISA IRQs
+    for (uint32_t i = 0; i < ioapic_count; i++) {
+        if (ioapics[i].gsi_base == 0)
+            apic_io_base = ioapics[i].base;
+    }
+
+    if (lapic_address != (uint64_t)(uintptr_t)apic_base) {
+        ioapic_map(lapic_address);
+        apic_base = (volatile uint32_t *)lapic_address;
+    }
+
+    LOG_INFO("MADT: %u CPUs, %u IOAPICs, %u interrupt source overrides\n", ioapic_cpus, ioapic_count, overrides);
+    SERIAL(Info, ioapic_init, "MADT: %u CPUs, %u IOAPICs, %u interrupt source overrides\n", ioapic_cpus, ioapic_count, overrides);
+    return 0;
+}
+
+static ioapic_t *ioapic_for_gsi(uint32_t gsi, uint32_t *pin) {
+    for (uint32_t i = 0; i < ioapic_count; i++) {
+        ioapic_t *io = &ioapics[i];
+        if (gsi >= io->gsi_base && gsi < io->gsi_base + io->pins) {
+            *pin = gsi - io->gsi_base;
+            return io;
+        }
+    }
+    return NULL;
+}
+
+// The entry stays masked while its halves are rewritten, so a half
+// updated one never delivers
+int8_t irq_route(uint32_t gsi, uint8_t vector, uint32_t cpu, irq_trigger_t trigger, irq_polarity_t polarity) {
+    uint32_t pin;
+    ioapic_t *io = ioapic_for_gsi(gsi, &pin);
+    cpu_t *target = smp_cpu(cpu);
+
+    if (io == NULL || target == NULL || !target->started || vector < 0x20) {
+        LOG_WARN("Cannot route GSI %u to vector 0x%x on CPU %u\n", gsi, vector, cpu);
+        SERIAL(Warn, irq_route, "Cannot route GSI %u to vector 0x%x on CPU %u\n", gsi, vector, cpu);
+        return -1;
+    }
+
+    uint32_t low = vector | APIC_DELIVERY_MODE_FIXED;
+    if (trigger == IRQ_TRIGGER_LEVEL)
+        low |= IOAPIC_REDIR_LEVEL;
+    if (polarity == IRQ_POLARITY_LOW)
+        low |= IOAPIC_REDIR_ACTIVE_LOW;
+
+    uint64_t flags = spin_lock_irqsave(&ioapic_lock);
+    cpuWriteIoApic((void *)io->base, IOAPIC_REDIRECTION(pin), IOAPIC_REDIR_MASKED);
+    cpuWriteIoApic((void *)io->base, IOAPIC_REDIRECTION(pin) + 1, target->lapic_id << 24);
+    cpuWriteIoApic((void *)io->base, IOAPIC_REDIRECTION(pin), low);
+    spin_unlock_irqrestore(&ioapic_lock, flags);
+    return 0;
+}
+
+uint32_t irq_isa_to_gsi(uint8_t isa_irq) {
+    return isa_irq < IOAPIC_ISA_IRQS ? isa_routes[isa_irq].gsi : isa_irq;
+}
+
+int8_t irq_route_isa(uint8_t isa_irq, uint8_t vector, uint32_t cpu) {
+    if (isa_irq >= IOAPIC_ISA_IRQS)
+        return -1;
+
+    irq_isa_route_t *route = &isa_routes[isa_irq];
+    return irq_route(route->gsi, vector, cpu, route->trigger, route->polarity);
+}
+
+static int8_t irq_set_masked(uint32_t gsi, bool masked) {
+    uint32_t pin;
+    ioapic_t *io = ioapic_for_gsi(gsi, &pin);
+    if (io == NULL)
+        return -1;
+
+    uint64_t flags = spin_lock_irqsave(&ioapic_lock);
+    uint32_t low = cpuReadIoApic((void *)io->base, IOAPIC_REDIRECTION(pin));
+    if (masked)
+        low |= IOAPIC_REDIR_MASKED;
+    else
+        low &= ~IOAPIC_REDIR_MASKED;
+    cpuWriteIoApic((void *)io->base, IOAPIC_REDIRECTION(pin), low);
+    spin_unlock_irqrestore(&ioapic_lock, flags);
+    return 0;
+}
+
+int8_t irq_mask(uint32_t gsi) {
+    return irq_set_masked(gsi, true);
+}
+
+int8_t irq_unmask(uint32_t gsi) {
+    return irq_set_masked(gsi, false);
+}
+
+uint32_t ioapic_cpu_count(void) {
+    return ioapic_cpus;
+}
+
+void ioapic_print_routes(void) {
+    for (uint32_t i = 0; i < ioapic_count; i++) {
+        ioapic_t *io = &ioapics[i];
+        printf("IOAPIC %u at %p, GSIs %u-%u\n", io->id, (void *)io->base, io->gsi_base, io->gsi_base + io->pins - 1);
+    }
+
+    for (uint8_t irq = 0; irq < IOAPIC_ISA_IRQS; irq++) {
+        irq_isa_route_t *route = &isa_routes[irq];
+        if (route->gsi != irq || route->trigger != IRQ_TRIGGER_EDGE || route->polarity != IRQ_POLARITY_HIGH)
+            printf("ISA IRQ %u -> GSI %u, %s, active %s\n", irq, route->gsi,
+                   route->trigger == IRQ_TRIGGER_LEVEL ? "level" : "edge",
+                   route->polarity == IRQ_POLARITY_LOW ? "low" : "high");
+    }
+
+    printf("gsi  vector  lapic  trigger  polarity\n");
+    for (uint32_t i = 0; i < ioapic_count; i++) {
+        ioapic_t *io = &ioapics[i];
+        for (uint32_t pin = 0; pin < io->pins; pin++) {
+            uint64_t flags = spin_lock_irqsave(&ioapic_lock);
+            uint32_t low = cpuReadIoApic((void *)io->base, IOAPIC_REDIRECTION(pin));
+            uint32_t high = cpuReadIoApic((void *)io->base, IOAPIC_REDIRECTION(pin) + 1);
+            spin_unlock_irqrestore(&ioapic_lock, flags);
+            if (low & IOAPIC_REDIR_MASKED)
+                continue;
+
+            printf("%-4u 0x%-5x %-6u %-8s %s\n", io->gsi_base + pin, low & IOAPIC_REDIR_VECTOR_MASK, high >> 24,
+                   (low & IOAPIC_REDIR_LEVEL) ? "level" : "edge", (low & IOAPIC_REDIR_ACTIVE_LOW) ? "low" : "high");
+        }
+    }
+}
@@ -0,0 +1,213 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: lapic_timer.c
+    Description: Local APIC timer driver for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "drivers/pic/includes/apic/apic.h"
+#include "drivers/pic/includes/apic/apic_irq.h"
+#include "drivers/pic/includes/apic/lapic_timer.h"
+#include "drivers/hpet/includes/hpet.h"
+#include "kernel/time/includes/time.h"
+#include "kernel/system/includes/percpu.h"
+#include "tools/includes/log-info.h"
+
+#define LAPIC_TIMER_CALIBRATION_US 10000
+
+static uint64_t lapic_timer_hz;
+static clock_scale_t lapic_from_ns;
+static clock_scale_t tsc_from_ns;
+static bool tsc_deadline;
+
+static lapic_timer_cpu_t lapic_timer_cpus[LAPIC_TIMER_MAX_CPUS];
+
+lapic_timer_cpu_t *lapic_timer_this_cpu(void) {
+    return &lapic_timer_cpus[smp_cpu_id()];
+}
+
+const char *lapic_timer_mode_name(lapic_timer_mode_t mode) {
+    switch (mode) {
+        case LAPIC_TIMER_TSC_DEADLINE: return "TSC-deadline";
+        case LAPIC_TIMER_ONESHOT:      return "one-shot";
+        case LAPIC_TIMER_PERIODIC:     return "periodic";
+        default:                       return "off";
+    }
+}
+
+bool lapic_timer_has_tsc_deadline(void) {
+    return tsc_deadline;
+}
+
+uint64_t lapic_timer_frequency(void) {
+    return lapic_timer_hz;
+}
+
+static void lapic_timer_irq(Registers_t *regs) {
+    lapic_timer_cpu_t *cpu = lapic_timer_this_cpu();
+
+    cpu->fired++;
+    if (cpu->mode != LAPIC_TIMER_PERIODIC)
+        cpu->mode = LAPIC_TIMER_OFF;
+    if (cpu->handler)
+        cpu->handler(regs);
+}
+
+// count-down ticks per second, from a free running count over a known delay
+static uint64_t lapic_timer_calibrate(void) {
+    APIC_Write(APIC_TIMER_DIVIDE, APIC_TIMER_DIVIDE_BY_16);
+    APIC_Write(APIC_LVT_TIMER, APIC_LVT_MASKED | APIC_TIMER_MODE_ONESHOT);
+    APIC_Write(APIC_TIMER_INITIAL_COUNT, 0xFFFFFFFF);
+
+    uint64_t start_ns = hpet_available() ? hpet_ns() : ktime_ns();
+    uint32_t start = APIC_Read(APIC_TIMER_CURRENT_COUNT);
+    udelay(LAPIC_TIMER_CALIBRATION_US);
+    uint32_t end = APIC_Read(APIC_TIMER_CURRENT_COUNT);
+    uint64_t elapsed_ns = (hpet_available() ? hpet_ns() : ktime_ns()) - start_ns;
+
+    APIC_Write(APIC_TIMER_INITIAL_COUNT, 0);
+    if (elapsed_ns == 0)
+        return 0;
+    return (uint64_t)(start - end) * 1000000000 / elapsed_ns;
+}
+
+int8_t lapic_timer_init(void) {
+    lapic_timer_cpu_t *cpu = lapic_timer_this_cpu();
+
+    if (lapic_timer_hz == 0) {
+        uint32_t eax, ebx, ecx, edx;
+        cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+        // the deadline is compared against the TSC, so it has to tick steadily
+        tsc_deadline = (ecx & (1u << 24)) && CPU_clock_speed != 0 && tsc_invariant;
+        tsc_from_ns = clock_scale_make(1000000000, CPU_clock_speed);
+
+        lapic_timer_hz = lapic_timer_calibrate();
+        if (lapic_timer_hz == 0) {
+            LOG_WARN("LAPIC timer did not count during calibration\n");
+            SERIAL(Warn, lapic_timer_init, "LAPIC timer did not count during calibration\n");
+            return -1;
+        }
+        lapic_from_ns = clock_scale_make(1000000000, lapic_timer_hz);
+        APIC_IRQ_RegisterHandler(LAPIC_TIMER_IRQ, lapic_timer_irq);
+
+        LOG_INFO("LAPIC timer: %lu kHz bus/16, one-shots use %s mode\n", lapic_timer_hz / 1000,
+                 lapic_timer_mode_name(tsc_deadline ? LAPIC_TIMER_TSC_DEADLINE : LAPIC_TIMER_ONESHOT));
+        SERIAL(Info, lapic_timer_init, "LAPIC timer: %lu kHz bus/16, one-shots use %s mode\n", lapic_timer_hz / 1000,
+               lapic_timer_mode_name(tsc_deadline ? LAPIC_TIMER_TSC_DEADLINE : LAPIC_TIMER_ONESHOT));
+    }
+
+    APIC_Write(APIC_TIMER_DIVIDE, APIC_TIMER_DIVIDE_BY_16);
+    lapic_timer_stop();
+    cpu->armed = cpu->fired = 0;
+    return 0;
+}
+
+void lapic_timer_set_handler(IRQHandler_t handler) {
+    lapic_timer_this_cpu()->handler = handler;
+}
+
+static void lapic_timer_countdown(lapic_timer_cpu_t *cpu, lapic_timer_mode_t mode, uint64_t delta_ns) {
+    uint64_t ticks = clock_scale_apply(lapic_from_ns, delta_ns);
+
+    // a zero count stops the timer instead of firing it, longer waits are
+    // cut short and the caller re-arms from its handler
+    if (ticks == 0)
+        ticks = 1;
+    if (ticks > 0xFFFFFFFF)
+        ticks = 0xFFFFFFFF;
+
+    APIC_Write(APIC_LVT_TIMER, LAPIC_TIMER_VECTOR |
+               (mode == LAPIC_TIMER_PERIODIC ? APIC_TIMER_MODE_PERIODIC : APIC_TIMER_MODE_ONESHOT));
+    cpu->mode = mode;
+    APIC_Write(APIC_TIMER_INITIAL_COUNT, (uint32_t)ticks);
+}
+
+int8_t lapic_timer_deadline_tsc(uint64_t tsc) {
+    lapic_timer_cpu_t *cpu = lapic_timer_this_cpu();
+
+    if (lapic_timer_hz == 0)
+        return -1;
+    cpu->armed++;
+
+    if (!tsc_deadline) {
+        uint64_t now = read_tsc_fast();
+        lapic_timer_countdown(cpu, LAPIC_TIMER_ONESHOT, tsc > now ? clock_scale_apply(tsc_to_ns, tsc - now) : 0);
+        return 0;
+    }
+
+    if (cpu->mode != LAPIC_TIMER_TSC_DEADLINE) {
+        APIC_Write(APIC_TIMER_INITIAL_COUNT, 0);
+        APIC_Write(APIC_LVT_TIMER, LAPIC_TIMER_VECTOR | APIC_TIMER_MODE_TSC_DEADLINE);
+        // the LVT write is MMIO and WRMSR does not wait for it, so order them
+        __asm__ volatile("mfence" ::: "memory");
+        cpu->mode = LAPIC_TIMER_TSC_DEADLINE;
+    }
+    // a deadline already in the past fires straight away
+    cpuSetMSR(IA32_TSC_DEADLINE_MSR, (uint32_t)tsc, (uint32_t)(tsc >> 32));
+    return 0;
+}
+
+int8_t lapic_timer_oneshot_ns(uint64_t delta_ns) {
+    if (lapic_timer_hz == 0)
+        return -1;
+
+    if (tsc_deadline)
+        return lapic_timer_deadline_tsc(read_tsc_fast() + clock_scale_apply(tsc_from_ns, delta_ns));
+
+    lapic_timer_cpu_t *cpu = lapic_timer_this_cpu();
+    cpu->armed++;
+    lapic_timer_countdown(cpu, LAPIC_TIMER_ONESHOT, delta_ns);
+    return 0;
+}
+
+int8_t lapic_timer_periodic_ns(uint64_t period_ns) {
+    if (lapic_timer_hz == 0 || period_ns == 0)
+        return -1;
+
+    lapic_timer_cpu_t *cpu = lapic_timer_this_cpu();
+    if (cpu->mode == LAPIC_TIMER_TSC_DEADLINE)
+        cpuSetMSR(IA32_TSC_DEADLINE_MSR, 0, 0);
+    lapic_timer_countdown(cpu, LAPIC_TIMER_PERIODIC, period_ns);
+    return 0;
+}
+
+void lapic_timer_stop(void) {
+    lapic_timer_cpu_t *cpu = lapic_timer_this_cpu();
+
+    if (cpu->mode == LAPIC_TIMER_TSC_DEADLINE)
+        cpuSetMSR(IA32_TSC_DEADLINE_MSR, 0, 0);
+    APIC_Write(APIC_LVT_TIMER, APIC_LVT_MASKED | LAPIC_TIMER_VECTOR);
+    APIC_Write(APIC_TIMER_INITIAL_COUNT, 0);
+    cpu->mode = LAPIC_TIMER_OFF;
+}
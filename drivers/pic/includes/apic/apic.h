@@ -52,6 +52,9 @@
 #define APIC_LVT_TIMER              0x320 // Local Vector Table Timer Register
 #define APIC_LVT_LINT0              0x350 // Local Vector Table LINT0 Register
 #define APIC_LVT_LINT1              0x360 // Local Vector Table LINT1 Register
+#define APIC_ICR_LOW                0x300 // Interrupt Command Register, writing it sends the IPI
+#define APIC_ICR_HIGH               0x310 // destination in bits 24-31
+#define APIC_ICR_PENDING            0x1000 // delivery status, previous IPI not accepted yet
 
 
 #define APIC_BASE                   0xFEE00000 // APIC Base Address (commonly defined, can vary)
@@ -112,6 +115,11 @@ static inline uint32_t APIC_Read(uint32_t reg) {
     return apic_base[reg / sizeof(uint32_t)];
 }
 
+// ID of the local APIC of the CPU we are running on
+static inline uint32_t LAPIC_GetID(void) {
+    return APIC_Read(APIC_ID) >> 24;
+}
+
 // read from IOAPIC register
 static inline uint32_t APIC_ReadIO(uint32_t reg) {
     // Write the register index
@@ -143,6 +151,8 @@ void cpuWriteIoApic(void *ioapicaddr, uint32_t reg, uint32_t value);
 // fn to configure the IMCR to switch from PIC to APIC mode
 void ConfigureIMCR();
 void APIC_Initialize();
+void LAPIC_InitializeCPU(void);     // local APIC of an AP, quietly
+void LAPIC_SendIPI(uint32_t lapic_id, uint8_t vector);  // fixed delivery to one CPU
 
 static inline void LAPIC_SendEOI() {
     APIC_Write(APIC_EOI, 0);
@@ -48,6 +48,7 @@ extern IRQHandler_t g_APICIRQHandler_ts[64];  // Max of 64 IRQs
 void APIC_IRQ_Handler(Registers_t* regs);       
 void APIC_IRQ_Initialize();                  
 void APIC_IRQ_RegisterHandler(uint32_t irq, IRQHandler_t handler); 
+void APIC_IRQ_UnregisterHandler(uint32_t irq);    // sleeps for a grace period
 void APIC_EnableIRQ(uint32_t irq);               
 void APIC_DisableIRQ(uint32_t irq);           
 void APIC_EnableIOIRQ(uint32_t irq, uint32_t interrupt_destination);
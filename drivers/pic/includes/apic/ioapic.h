@@ -0,0 +1,168 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: ioapic.h
+    Description: IOAPIC interrupt routing for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef IOAPIC_H
+#define IOAPIC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drivers/acpi/includes/acpi.h"
+
+/*
+ * Device interrupts come in on global system interrupts (GSIs), each IOAPIC
+ * owns a contiguous range of them starting at its gsi_base, one per pin.
+ * The ISA IRQs are GSIs 0-15 unless the MADT has an interrupt source
+ * override for them, which may also change their trigger mode and polarity;
+ * irq_route_isa() applies those, irq_route() takes a GSI as it is.
+ *
+ * Without a MADT the single IOAPIC at APIC_IO_BASE is assumed, with the ISA
+ * IRQs identity mapped.
+ */
+
+#define IOAPIC_MAX                  8
+#define IOAPIC_ISA_IRQS             16
+
+// IOAPIC registers, through the select/window pair
+#define IOAPIC_REG_ID               0x00
+#define IOAPIC_REG_VERSION          0x01    // bits 16-23: highest redirection entry
+#define IOAPIC_REDIRECTION(pin)     (0x10 + 2 * (pin))
+
+// low half of a redirection entry, the destination APIC ID is in bits 24-31 of the high half
+#define IOAPIC_REDIR_VECTOR_MASK    0x000000FF
+#define IOAPIC_REDIR_PENDING        0x00001000
+#define IOAPIC_REDIR_ACTIVE_LOW     0x00002000
+#define IOAPIC_REDIR_LEVEL          0x00008000
+#define IOAPIC_REDIR_MASKED         0x00010000
+
+typedef enum {
+    IRQ_TRIGGER_EDGE,
+    IRQ_TRIGGER_LEVEL,
+} irq_trigger_t;
+
+typedef enum {
+    IRQ_POLARITY_HIGH,
+    IRQ_POLARITY_LOW,
+} irq_polarity_t;
+
+// Multiple APIC Description Table, "APIC"
+typedef struct __attribute__((packed)) {
+    acpi_sdt_header_t header;
+    uint32_t lapic_address;
+    uint32_t flags;             // bit 0: there are also 8259 PICs
+    // followed by variable length entries, each starting with type and length
+} acpi_madt_t;
+
+#define MADT_ENTRY_LAPIC            0
+#define MADT_ENTRY_IOAPIC           1
+#define MADT_ENTRY_OVERRIDE         2
+#define MADT_ENTRY_LAPIC_ADDRESS    5
+
+#define MADT_LAPIC_ENABLED          0x1
+#define MADT_LAPIC_ONLINE_CAPABLE   0x2
+
+// MPS INTI flags of an override
+#define MADT_POLARITY_MASK          0x3
+#define MADT_POLARITY_HIGH          0x1
+#define MADT_POLARITY_LOW           0x3
+#define MADT_TRIGGER_MASK           0xC
+#define MADT_TRIGGER_EDGE           0x4
+#define MADT_TRIGGER_LEVEL          0xC
+
+typedef struct __attribute__((packed)) {
+    uint8_t type;
+    uint8_t length;
+} madt_entry_t;
+
+typedef struct __attribute__((packed)) {
+    madt_entry_t entry;
+    uint8_t processor_id;
+    uint8_t apic_id;
+    uint32_t flags;
+} madt_lapic_t;
+
+typedef struct __attribute__((packed)) {
+    madt_entry_t entry;
+    uint8_t id;
+    uint8_t reserved;
+    uint32_t address;
+    uint32_t gsi_base;
+} madt_ioapic_t;
+
+typedef struct __attribute__((packed)) {
+    madt_entry_t entry;
+    uint8_t bus;                // always 0, ISA
+    uint8_t source;             // ISA IRQ
+    uint32_t gsi;
+    uint16_t flags;
+} madt_override_t;
+
+typedef struct __attribute__((packed)) {
+    madt_entry_t entry;
+    uint16_t reserved;
+    uint64_t address;
+} madt_lapic_address_t;
+
+typedef struct {
+    volatile uint32_t *base;
+    uint8_t id;
+    uint32_t gsi_base;
+    uint32_t pins;
+} ioapic_t;
+
+// where an ISA IRQ really arrives
+typedef struct {
+    uint32_t gsi;
+    irq_trigger_t trigger;
+    irq_polarity_t polarity;
+} irq_isa_route_t;
+
+// Reads the MADT, maps every IOAPIC and masks all of their pins. -1 when
+// there is no MADT and the defaults are used
+int8_t ioapic_init(void);
+
+// Point gsi at vector on logical CPU cpu, and unmask it
+int8_t irq_route(uint32_t gsi, uint8_t vector, uint32_t cpu, irq_trigger_t trigger, irq_polarity_t polarity);
+int8_t irq_route_isa(uint8_t isa_irq, uint8_t vector, uint32_t cpu);
+int8_t irq_mask(uint32_t gsi);
+int8_t irq_unmask(uint32_t gsi);
+uint32_t irq_isa_to_gsi(uint8_t isa_irq);
+
+uint32_t ioapic_cpu_count(void);    // usable processors the MADT lists, 0 without one
+void ioapic_print_routes(void);
+
+#endif // IOAPIC_H
@@ -0,0 +1,101 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: lapic_timer.h
+    Description: Local APIC timer driver for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef LAPIC_TIMER_H
+#define LAPIC_TIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drivers/pic/includes/pic_irq.h"
+
+// Local APIC timer registers
+#define APIC_TIMER_INITIAL_COUNT    0x380
+#define APIC_TIMER_CURRENT_COUNT    0x390
+#define APIC_TIMER_DIVIDE           0x3E0
+
+// APIC_LVT_TIMER mode field, bits 17:18
+#define APIC_TIMER_MODE_ONESHOT     0x00000000
+#define APIC_TIMER_MODE_PERIODIC    0x00020000
+#define APIC_TIMER_MODE_TSC_DEADLINE 0x00040000
+#define APIC_LVT_MASKED             0x00010000
+
+#define APIC_TIMER_DIVIDE_BY_16     0x3
+
+#define IA32_TSC_DEADLINE_MSR       0x6E0
+
+// APIC IRQ of the timer, vector 0x20 + 48 keeps it clear of the IOAPIC pins
+#define LAPIC_TIMER_IRQ             48
+#define LAPIC_TIMER_VECTOR          (0x20 + LAPIC_TIMER_IRQ)
+
+#define LAPIC_TIMER_MAX_CPUS        64
+
+typedef enum {
+    LAPIC_TIMER_OFF          = 0,
+    LAPIC_TIMER_TSC_DEADLINE = 1,   // fires when the TSC reaches an absolute value
+    LAPIC_TIMER_ONESHOT      = 2,   // counts a calibrated number of bus ticks down once
+    LAPIC_TIMER_PERIODIC     = 3,   // same, reloading itself
+} lapic_timer_mode_t;
+
+typedef struct {
+    lapic_timer_mode_t mode;        // what the LVT is programmed for right now
+    uint64_t armed;                 // one-shots and deadlines programmed
+    uint64_t fired;                 // interrupts taken
+    IRQHandler_t handler;           // run on every expiry, may re-arm
+} lapic_timer_cpu_t;
+
+// Bring the timer up on the calling CPU. The first call calibrates the bus
+// frequency and decides between TSC-deadline and count-down one-shots; the
+// timer stays masked until something is armed
+int8_t lapic_timer_init(void);
+
+void lapic_timer_set_handler(IRQHandler_t handler);
+
+// Arm a single expiry delta_ns from now, or at an absolute TSC value. Either
+// uses TSC-deadline mode when the CPU has it, otherwise the count-down
+int8_t lapic_timer_oneshot_ns(uint64_t delta_ns);
+int8_t lapic_timer_deadline_tsc(uint64_t tsc);
+
+int8_t lapic_timer_periodic_ns(uint64_t period_ns);
+void lapic_timer_stop(void);
+
+bool lapic_timer_has_tsc_deadline(void);
+uint64_t lapic_timer_frequency(void);          // count-down ticks per second
+lapic_timer_cpu_t *lapic_timer_this_cpu(void);
+const char *lapic_timer_mode_name(lapic_timer_mode_t mode);
+
+#endif // LAPIC_TIMER_H
@@ -0,0 +1,68 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: rtc.h
+    Description: CMOS real time clock driver for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef RTC_H
+#define RTC_H
+
+#include <stdint.h>
+
+#define CMOS_ADDRESS_PORT 0x70
+#define CMOS_DATA_PORT    0x71
+
+#define RTC_SECONDS   0x00
+#define RTC_MINUTES   0x02
+#define RTC_HOURS     0x04
+#define RTC_DAY       0x07
+#define RTC_MONTH     0x08
+#define RTC_YEAR      0x09
+#define RTC_CENTURY   0x32     // not on every board, FADT says where if anywhere
+#define RTC_STATUS_A  0x0A
+#define RTC_STATUS_B  0x0B
+
+#define RTC_A_UPDATE_IN_PROGRESS 0x80
+#define RTC_B_24_HOUR            0x02
+#define RTC_B_BINARY             0x04
+#define RTC_HOUR_PM              0x80
+
+// seconds since 1970-01-01 00:00 UTC, assuming the CMOS clock keeps UTC
+uint64_t rtc_read_unix(void);
+
+// days since 1970-01-01 for a proleptic Gregorian date
+int64_t rtc_days_from_civil(int64_t year, uint32_t month, uint32_t day);
+
+#endif // RTC_H
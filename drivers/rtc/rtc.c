@@ -0,0 +1,108 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: rtc.c
+    Description: CMOS real time clock driver for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/rtc.h"
+#include "arch/x86_64/includes/io.h"
+#include <stdbool.h>
+
+static uint8_t cmos_read(uint8_t reg) {
+    outb(CMOS_ADDRESS_PORT, reg | 0x80);    // keep NMIs masked while selecting
+    return inb(CMOS_DATA_PORT);
+}
+
+typedef struct {
+    uint8_t second, minute, hour, day, month, year, century;
+} rtc_time_t;
+
+static void rtc_read_raw(rtc_time_t *t) {
+    while (cmos_read(RTC_STATUS_A) & RTC_A_UPDATE_IN_PROGRESS);
+    t->second = cmos_read(RTC_SECONDS);
+    t->minute = cmos_read(RTC_MINUTES);
+    t->hour = cmos_read(RTC_HOURS);
+    t->day = cmos_read(RTC_DAY);
+    t->month = cmos_read(RTC_MONTH);
+    t->year = cmos_read(RTC_YEAR);
+    t->century = cmos_read(RTC_CENTURY);
+}
+
+static inline uint8_t bcd_to_bin(uint8_t v) {
+    return (v & 0x0F) + (v >> 4) * 10;
+}
+
+// Howard Hinnant's days_from_civil, exact for any Gregorian date
+int64_t rtc_days_from_civil(int64_t year, uint32_t month, uint32_t day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    uint32_t yoe = (uint32_t)(year - era * 400);
+    uint32_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+uint64_t rtc_read_unix(void) {
+    rtc_time_t a, b;
+
+    // an update can land between the registers, read until two passes agree
+    rtc_read_raw(&b);
+    do {
+        a = b;
+        rtc_read_raw(&b);
+    } while (a.second != b.second || a.minute != b.minute || a.hour != b.hour ||
+             a.day != b.day || a.month != b.month || a.year != b.year);
+
+    uint8_t status = cmos_read(RTC_STATUS_B);
+    bool pm = b.hour & RTC_HOUR_PM;
+    b.hour &= ~RTC_HOUR_PM;
+
+    if (!(status & RTC_B_BINARY)) {
+        b.second = bcd_to_bin(b.second);
+        b.minute = bcd_to_bin(b.minute);
+        b.hour = bcd_to_bin(b.hour);
+        b.day = bcd_to_bin(b.day);
+        b.month = bcd_to_bin(b.month);
+        b.year = bcd_to_bin(b.year);
+        b.century = bcd_to_bin(b.century);
+    }
+    if (!(status & RTC_B_24_HOUR))
+        b.hour = (b.hour % 12) + (pm ? 12 : 0);
+
+    // no century register reads back 0 or junk, assume 20xx then
+    uint32_t century = (b.century >= 19 && b.century <= 30) ? b.century : 20;
+    int64_t days = rtc_days_from_civil(century * 100 + b.year, b.month, b.day);
+    return (uint64_t)(days * 86400 + b.hour * 3600 + b.minute * 60 + b.second);
+}
@@ -47,16 +47,30 @@
 #include "arch/x86_64/includes/idt.h"
 #include "arch/x86_64/includes/gdt.h"
 #include "arch/x86_64/includes/isr.h"
+#include "arch/x86_64/includes/fpu.h"
 #include "mm/includes/pmm.h"
 #include "mm/includes/vmm.h"
 #include "tools/includes/log-info.h"
 #include "drivers/pic/includes/apic/apic.h"
 #include "drivers/pic/includes/apic/apic_irq.h"
+#include "drivers/pic/includes/apic/lapic_timer.h"
+#include "drivers/pic/includes/apic/ioapic.h"
 #include "shell/includes/keyboard.h"
 #include "shell/includes/shell.h"
 #include "storage/includes/stinit.h"
 #include "drivers/hci/includes/ehci.h"
 #include "drivers/pci/includes/pci.h"
+#include "drivers/pci/includes/msi.h"
+#include "kernel/time/includes/time.h"
+#include "kernel/time/includes/timer.h"
+#include "drivers/acpi/includes/acpi.h"
+#include "drivers/acpi/includes/pmtimer.h"
+#include "kernel/time/includes/clocksource.h"
+#include "kernel/time/includes/vdso.h"
+#include "kernel/system/includes/smp.h"
+#include "kernel/sched/includes/sched.h"
+#include "kernel/system/includes/idle.h"
+#include "kernel/system/includes/rcu.h"
 #include <assert.h>
 
 extern void syscall_init(void);
@@ -75,8 +89,6 @@ tlsf_t kernel_tlsf;
 
 
 void init_heap() {
-capture_boot_tsc();
-
     kernel_tlsf = tlsf_create_with_pool(kernel_heap, KERNEL_HEAP_SIZE);
     LOG_INFO("Heap initialized at %p\n", kernel_heap);
     SERIAL(Info, init_heap, "Heap initialized at %p\n", kernel_heap);
@@ -84,7 +96,10 @@ capture_boot_tsc();
 }
 
 void kernel_main(void) {
+    capture_boot_tsc();
     struct limine_framebuffer *fb = fb_req.response->framebuffers[0];
+
+    serial_init();
     
     global_flanterm = flanterm_fb_init(
         NULL,                    // malloc function
@@ -124,18 +139,34 @@ void kernel_main(void) {
     printf("Copyright (c) 2026 Aspen Software Foundation\n");
     printf("-------------------------------------\n");
 
+    time_init();
     init_heap();
     GDT_Initialize();
+    smp_init_bsp();
     IDT_Initialize();
     vmm_init();
     pmm_init();
     ISR_Initialize();
+    fpu_init();
+    idle_init();
     APIC_IRQ_Initialize();
+    acpi_init();
+    ioapic_init();
+    msi_init();
+    pmtimer_init();
+    time_hpet_init();
+    lapic_timer_init();
+    timer_subsystem_init();
+    vdso_init();
+    clocksource_watchdog_start();
     keyboard_apic_init();
     storage_init();
     enable_interrupts();
     start_pci_enumeration();
     syscall_init();
+    sched_init();
+    rcu_init();
+    smp_init();
 
         void vmm_test_mapping(void) {
     uint64_t virt = 0x1000000000;  // random virtual address
@@ -195,5 +226,6 @@ vmm_test_unmap();
 
     shell_main();
 
-    while (1);
+    while (1)
+        cpu_idle();
 }
\ No newline at end of file
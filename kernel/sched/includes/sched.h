@@ -0,0 +1,142 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: sched.h
+    Description: Task scheduler for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "kernel/system/includes/spinlock.h"
+#include "arch/x86_64/includes/fpu.h"
+#include "runqueue.h"
+
+/*
+ * Kernel threads on per-CPU run queues. Each CPU runs its queue round robin,
+ * a task gets SCHED_SLICE_NS before the LAPIC timer preempts it in favour of
+ * the next one. A CPU whose queue runs dry steals from the longest queue
+ * before it goes idle, and a task woken from another CPU is put on an idle
+ * CPU when there is one, which is kicked with SCHED_IPI_VECTOR.
+ *
+ * A task that blocks sets its state with sched_prepare_block(), checks its
+ * condition once more, then calls schedule(). A sched_wake() landing in
+ * between turns the schedule() into a no-op, so no wakeup is lost.
+ */
+
+#define SCHED_SLICE_NS      10000000UL     // 10 ms
+#define SCHED_STACK_SIZE    0x4000
+#define SCHED_ANY_CPU       UINT32_MAX
+
+#define SCHED_IPI_IRQ       50
+#define SCHED_IPI_VECTOR    (0x20 + SCHED_IPI_IRQ)
+
+typedef enum {
+    TASK_RUNNING,           // on a CPU right now
+    TASK_RUNNABLE,          // waiting in a run queue
+    TASK_BLOCKED,
+    TASK_DEAD,              // exited, waiting to be joined
+} task_state_t;
+
+typedef void (*task_fn_t)(void *arg);
+
+typedef struct task {
+    uint64_t rsp;               // saved by context_switch, has to stay first
+    uint32_t tid;
+    volatile task_state_t state;
+    volatile bool on_cpu;       // its stack is in use, even if state says otherwise
+    uint32_t cpu;               // CPU it runs or last ran on
+    uint32_t pinned;            // only CPU it may run on, SCHED_ANY_CPU if none
+    spinlock_t lock;            // state and on_cpu
+    const char *name;
+
+    task_fn_t fn;
+    void *arg;
+    uint8_t *stack;             // NULL for the tasks CPUs booted on
+    fpu_ctx_t fpu;
+    int exit_code;
+    struct task *joiner;
+
+    struct task *rq_next;       // run queue links
+    struct task *rq_prev;
+
+    uint64_t runtime_ns;
+    uint64_t switches;          // times it was switched in
+    uint64_t woken_ns;          // when it last became runnable
+    uint64_t last_in_ns;
+} task_t;
+
+// context switch, sched_switch.c
+void context_switch(uint64_t *save_rsp, uint64_t next_rsp);
+uint64_t context_stack_init(void *stack_top, void (*entry)(void));
+
+void sched_init(void);              // BSP, turns kernel_main into a task
+void sched_init_cpu(void);          // AP, its boot context becomes its idle task
+__attribute__((noreturn)) void sched_idle_loop(void);
+bool sched_active(void);            // the current CPU is running a real task
+
+task_t *kthread_create(const char *name, task_fn_t fn, void *arg);
+task_t *kthread_create_on(const char *name, task_fn_t fn, void *arg, uint32_t cpu);
+__attribute__((noreturn)) void kthread_exit(int code);
+int kthread_join(task_t *task);     // waits for the exit, then frees the task
+
+// one %gs load, so it cannot race with being moved to another CPU
+static inline task_t *current_task(void) {
+    task_t *task;
+    __asm__ volatile("movq %%gs:32, %0" : "=r"(task));
+    return task;
+}
+
+void schedule(void);
+void sched_yield(void);
+void sched_prepare_block(void);
+void sched_cancel_block(void);
+bool sched_wake(task_t *task);      // true if it was blocked
+void sched_irq_exit(void);          // preemption point after every APIC IRQ
+bool sched_should_yield(void);      // others are waiting for this CPU
+
+// preempt_enable() with the preemption point
+static inline void preempt_enable(void) {
+    preempt_enable_no_resched();
+    if (this_cpu()->preempt_count == 0 && this_cpu()->need_resched)
+        schedule();
+}
+
+void sched_print_stats(void);
+void sched_bench(void);
+
+#endif // SCHED_H
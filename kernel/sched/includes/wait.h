@@ -0,0 +1,144 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: wait.h
+    Description: Wait queues and completions for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef WAIT_H
+#define WAIT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel/system/includes/spinlock.h"
+#include "sched.h"
+
+/*
+ * A wait queue is the list of tasks sleeping until something happens, so an
+ * interrupt handler or another task can wake exactly those instead of them
+ * polling. A waiter queues itself and marks itself blocked with
+ * prepare_to_wait(), checks its condition, and only then sleeps; a wake_up()
+ * in between leaves it runnable, so no wakeup is lost. wake_up() takes the
+ * waiters off the queue, each is woken once.
+ *
+ * Before the scheduler is running the waiter halts the CPU instead and
+ * rechecks after every interrupt, so only wakeups from this CPU's own
+ * interrupts are seen quickly then. A wakeup between queueing and halting
+ * keeps the CPU from halting, none is lost.
+ *
+ * Timeouts are relative, in nanoseconds; WAIT_FOREVER has none. Interrupts
+ * have to be on while waiting.
+ */
+
+#define WAIT_FOREVER    UINT64_MAX
+
+typedef struct wait_entry {
+    task_t *task;               // NULL when halting instead of blocking
+    struct wait_entry *next;
+    struct wait_entry *prev;
+    bool queued;
+} wait_entry_t;
+
+typedef struct {
+    spinlock_t lock;            // irqsave, wake_up() is called from interrupts
+    wait_entry_t *head;
+    wait_entry_t *tail;
+} wait_queue_t;
+
+#define WAIT_QUEUE_INIT { SPINLOCK_INIT, NULL, NULL }
+
+void wait_queue_init(wait_queue_t *wq);
+void wait_entry_init(wait_entry_t *entry);
+void prepare_to_wait(wait_queue_t *wq, wait_entry_t *entry);
+void finish_wait(wait_queue_t *wq, wait_entry_t *entry);
+uint32_t wake_up(wait_queue_t *wq);         // all waiters, returns how many
+uint32_t wake_up_one(wait_queue_t *wq);     // the longest waiting one
+
+// absolute deadline for a relative timeout, WAIT_FOREVER stays as it is
+uint64_t wait_deadline(uint64_t timeout_ns);
+
+// Sleep after prepare_to_wait() until woken or ktime_ns() reaches
+// deadline_ns. false once the deadline has passed. The task stays on its
+// CPU meanwhile, the timer can only be cancelled from there
+bool schedule_timeout(uint64_t deadline_ns);
+
+// Sleep until cond holds or timeout_ns passes, the result is the last value
+// of cond. cond is evaluated with the task already queued, so it has to be
+// cheap and must not sleep
+#define wait_event_timeout(wq, cond, timeout_ns) ({                         \
+    bool __wait_done = (cond);                                              \
+    if (!__wait_done) {                                                     \
+        uint64_t __wait_deadline = wait_deadline(timeout_ns);               \
+        wait_entry_t __wait_entry;                                          \
+        wait_entry_init(&__wait_entry);                                     \
+        for (;;) {                                                          \
+            prepare_to_wait((wq), &__wait_entry);                           \
+            if ((__wait_done = (cond)))                                     \
+                break;                                                      \
+            if (!schedule_timeout(__wait_deadline)) {                       \
+                __wait_done = (cond);                                       \
+                break;                                                      \
+            }                                                               \
+        }                                                                   \
+        finish_wait((wq), &__wait_entry);                                   \
+    }                                                                       \
+    __wait_done;                                                            \
+})
+
+#define wait_event(wq, cond) ((void)wait_event_timeout(wq, cond, WAIT_FOREVER))
+
+/*
+ * A completion counts complete() calls and lets one waiter through per call,
+ * complete_all() lets everyone through until reinit_completion(). It is the
+ * usual way for an interrupt handler to hand a finished request back to the
+ * task that issued it.
+ */
+
+typedef struct {
+    wait_queue_t wait;
+    uint32_t done;              // UINT32_MAX after complete_all()
+} completion_t;
+
+#define COMPLETION_INIT { WAIT_QUEUE_INIT, 0 }
+
+void init_completion(completion_t *c);
+void reinit_completion(completion_t *c);
+void complete(completion_t *c);
+void complete_all(completion_t *c);
+void wait_for_completion(completion_t *c);
+bool wait_for_completion_timeout(completion_t *c, uint64_t timeout_ns);   // false on timeout
+bool try_wait_for_completion(completion_t *c);                           // never sleeps
+bool completion_done(completion_t *c);                                   // nobody would sleep on it
+
+#endif // WAIT_H
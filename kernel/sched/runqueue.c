@@ -0,0 +1,90 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: runqueue.c
+    Description: Task scheduler run queues for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/runqueue.h"
+#include "includes/sched.h"
+#include <stddef.h>
+
+void runqueue_init(runqueue_t *rq) {
+    rq->head = rq->tail = NULL;
+    rq->nr_queued = 0;
+    rq->enqueued = rq->stolen = 0;
+}
+
+void runqueue_push(runqueue_t *rq, task_t *task) {
+    task->rq_next = NULL;
+    task->rq_prev = rq->tail;
+    if (rq->tail)
+        rq->tail->rq_next = task;
+    else
+        rq->head = task;
+    rq->tail = task;
+    rq->nr_queued++;
+    rq->enqueued++;
+}
+
+void runqueue_remove(runqueue_t *rq, task_t *task) {
+    if (task->rq_prev)
+        task->rq_prev->rq_next = task->rq_next;
+    else
+        rq->head = task->rq_next;
+    if (task->rq_next)
+        task->rq_next->rq_prev = task->rq_prev;
+    else
+        rq->tail = task->rq_prev;
+    task->rq_next = task->rq_prev = NULL;
+    rq->nr_queued--;
+}
+
+task_t *runqueue_pop(runqueue_t *rq) {
+    task_t *task = rq->head;
+    if (task)
+        runqueue_remove(rq, task);
+    return task;
+}
+
+task_t *runqueue_steal(runqueue_t *rq, uint32_t cpu) {
+    for (task_t *task = rq->tail; task; task = task->rq_prev) {
+        if (task->pinned == SCHED_ANY_CPU || task->pinned == cpu) {
+            runqueue_remove(rq, task);
+            rq->stolen++;
+            return task;
+        }
+    }
+    return NULL;
+}
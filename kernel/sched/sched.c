@@ -0,0 +1,763 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: sched.c
+    Description: Preemptive task scheduler for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/sched.h"
+#include "includes/runqueue.h"
+#include "kernel/system/includes/smp.h"
+#include "kernel/system/includes/idle.h"
+#include "kernel/system/includes/rcu.h"
+#include "kernel/time/includes/time.h"
+#include "kernel/time/includes/timer.h"
+#include "drivers/pic/includes/apic/apic.h"
+#include "drivers/pic/includes/apic/apic_irq.h"
+#include "arch/x86_64/includes/io.h"
+#include "tools/includes/log-info.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#define SCHED_BENCH_SWITCHES    20000
+#define SCHED_BENCH_WAKEUPS     1000
+#define SCHED_BENCH_SPIN_MS     200
+#define SCHED_BENCH_MAX_SPINNERS 16
+
+typedef struct {
+    uint64_t switches;
+    uint64_t preemptions;       // schedule() from an interrupt
+    uint64_t steals;            // tasks taken from other CPUs' queues
+    uint64_t ipis;              // idle CPUs kicked from here
+    uint64_t polled;            // idle CPUs woken by the need_resched store alone, no IPI
+    uint64_t wakeups;
+    uint64_t wake_lat_sum_ns;   // runnable until running
+    uint64_t wake_lat_max_ns;
+} sched_stats_t;
+
+typedef struct {
+    runqueue_t rq;
+    spinlock_t lock;            // rq
+    volatile bool online;
+    task_t *prev;               // switched away from, finished by whoever runs next
+    ktimer_t slice;
+    sched_stats_t stats;
+} sched_cpu_t;
+
+static sched_cpu_t sched_cpus[SMP_MAX_CPUS];
+static task_t sched_boot_tasks[SMP_MAX_CPUS];  // the contexts the CPUs booted on
+static uint32_t sched_next_tid = 1;
+
+static void sched_task_start(void);
+
+static inline bool sched_cpu_is_idle(uint32_t id) {
+    cpu_t *cpu = smp_cpu(id);
+    return cpu->current == cpu->idle && sched_cpus[id].rq.nr_queued == 0;
+}
+
+// The CPU is either busy, then its slice timer gets it to the queue, or idle
+// and possibly halted, then it needs an interrupt
+static void sched_kick(uint32_t id) {
+    cpu_t *cpu = smp_cpu(id);
+    uint32_t self = smp_cpu_id();
+
+    cpu->need_resched = true;
+    if (id == self)
+        return;
+
+    // pairs with the fence in idle_mwait(): either it is polling and our
+    // store ends its MWAIT, or it sees need_resched before sleeping
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (cpu->idle_polling) {
+        sched_cpus[self].stats.polled++;
+        return;
+    }
+    sched_cpus[self].stats.ipis++;
+    LAPIC_SendIPI(cpu->lapic_id, SCHED_IPI_VECTOR);
+}
+
+// Where a task that just became runnable goes: the CPU it is pinned to, the
+// CPU it last ran on if that is idle (the cache may still be warm), any idle
+// CPU, and failing all of those the least loaded one
+static uint32_t sched_select_cpu(task_t *task) {
+    if (task->pinned != SCHED_ANY_CPU)
+        return task->pinned;
+
+    uint32_t best = sched_cpus[task->cpu].online ? task->cpu : 0;
+    if (sched_cpu_is_idle(best))
+        return best;
+
+    uint32_t best_load = UINT32_MAX;
+    for (uint32_t id = 0; id < SMP_MAX_CPUS; id++) {
+        if (!sched_cpus[id].online)
+            continue;
+        if (sched_cpu_is_idle(id))
+            return id;
+        cpu_t *cpu = smp_cpu(id);
+        uint32_t load = sched_cpus[id].rq.nr_queued + (cpu->current != cpu->idle);
+        if (load < best_load || (load == best_load && id == task->cpu)) {
+            best = id;
+            best_load = load;
+        }
+    }
+    return best;
+}
+
+// interrupts off
+static void sched_enqueue(task_t *task) {
+    uint32_t id = sched_select_cpu(task);
+    sched_cpu_t *sc = &sched_cpus[id];
+    cpu_t *cpu = smp_cpu(id);
+
+    arch_spin_lock(&sc->lock);
+    runqueue_push(&sc->rq, task);
+    arch_spin_unlock(&sc->lock);
+
+    // pairs with the fence in sched_idle_loop(): either it sees the task or we
+    // see it went idle and kick it
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (cpu->current == cpu->idle)
+        sched_kick(id);
+}
+
+// longest queue other than ours, SCHED_ANY_CPU if there is nothing to take
+static uint32_t sched_busiest(uint32_t self) {
+    uint32_t busiest = SCHED_ANY_CPU;
+    uint32_t most = 0;
+
+    for (uint32_t id = 0; id < SMP_MAX_CPUS; id++) {
+        if (id == self || !sched_cpus[id].online)
+            continue;
+        uint32_t queued = __atomic_load_n(&sched_cpus[id].rq.nr_queued, __ATOMIC_RELAXED);
+        if (queued > most) {
+            busiest = id;
+            most = queued;
+        }
+    }
+    return busiest;
+}
+
+static task_t *sched_pick_next(uint32_t id, bool steal) {
+    sched_cpu_t *sc = &sched_cpus[id];
+
+    arch_spin_lock(&sc->lock);
+    task_t *next = runqueue_pop(&sc->rq);
+    arch_spin_unlock(&sc->lock);
+    if (next != NULL || !steal)
+        return next;
+
+    uint32_t victim = sched_busiest(id);
+    if (victim == SCHED_ANY_CPU)
+        return NULL;
+
+    sched_cpu_t *vc = &sched_cpus[victim];
+    arch_spin_lock(&vc->lock);
+    next = runqueue_steal(&vc->rq, id);
+    arch_spin_unlock(&vc->lock);
+    if (next != NULL)
+        sc->stats.steals++;
+    return next;
+}
+
+// Runs on the new stack right after every switch. Only now is the previous
+// task's stack free, so only now may another CPU pick it up or its joiner
+// free it
+static void sched_finish_switch(void) {
+    cpu_t *cpu = this_cpu();
+    task_t *prev = sched_cpus[cpu->id].prev;
+
+    arch_spin_lock(&prev->lock);
+    prev->on_cpu = false;
+    bool requeue = prev->state == TASK_RUNNABLE && prev != cpu->idle;
+    task_t *joiner = prev->state == TASK_DEAD ? prev->joiner : NULL;
+    arch_spin_unlock(&prev->lock);
+
+    if (requeue)
+        sched_enqueue(prev);
+    if (joiner != NULL)
+        sched_wake(joiner);
+}
+
+// Syscalls and interrupts from ring 3 land on the stack of the task that made
+// them, so one that sleeps in the kernel keeps its frame while others run.
+// A task is in user mode only with nothing of its own on that stack
+static void sched_set_kernel_stack(cpu_t *cpu, task_t *next) {
+    uint64_t top = cpu->boot_kernel_stack;
+
+    if (next->stack != NULL)
+        top = ((uint64_t)next->stack + SCHED_STACK_SIZE) & ~0xFull;
+    cpu->kernel_stack = top;
+    cpu->gdt.TSS.RSP[0] = top;
+}
+
+static void sched_switch(cpu_t *cpu, sched_cpu_t *sc, task_t *prev, task_t *next) {
+    uint64_t now = ktime_ns();
+
+    prev->runtime_ns += now - prev->last_in_ns;
+    next->last_in_ns = now;
+    next->state = TASK_RUNNING;
+    next->on_cpu = true;
+    next->cpu = cpu->id;
+    next->switches++;
+    if (next->woken_ns != 0) {
+        uint64_t lat = now > next->woken_ns ? now - next->woken_ns : 0;
+        sc->stats.wakeups++;
+        sc->stats.wake_lat_sum_ns += lat;
+        if (lat > sc->stats.wake_lat_max_ns)
+            sc->stats.wake_lat_max_ns = lat;
+        next->woken_ns = 0;
+    }
+    sc->stats.switches++;
+    sc->prev = prev;
+    cpu->current = next;
+
+    // an idle CPU keeps no timer of its own, so it can stay asleep
+    if (next != cpu->idle)
+        mod_timer(&sc->slice, now + SCHED_SLICE_NS);
+    else
+        timer_cancel(&sc->slice);
+
+    sched_set_kernel_stack(cpu, next);
+    fpu_switch(&prev->fpu, &next->fpu);
+    context_switch(&prev->rsp, next->rsp);
+    sched_finish_switch();
+}
+
+// A preempted task goes back on a queue whatever state it was in the middle
+// of setting, it rechecks its condition when it runs again. Otherwise one
+// preempted between sched_prepare_block() and its check could sleep through
+// a wakeup that already happened
+static void __schedule(bool preempt) {
+    uint64_t flags = irq_save();
+    cpu_t *cpu = this_cpu();
+    sched_cpu_t *sc = &sched_cpus[cpu->id];
+    task_t *prev = cpu->current;
+
+    // read-side sections keep preemption off, so none spans a switch
+    rcu_note_qs();
+    cpu->need_resched = false;
+    arch_spin_lock(&prev->lock);
+    if (prev->state == TASK_RUNNING || (preempt && prev->state == TASK_BLOCKED))
+        prev->state = TASK_RUNNABLE;
+    bool keep = prev->state == TASK_RUNNABLE && prev != cpu->idle;
+    arch_spin_unlock(&prev->lock);
+
+    // a task that can carry on only gives way to local work, stealing is for
+    // CPUs that would otherwise idle
+    task_t *next = sched_pick_next(cpu->id, !keep);
+    if (next == NULL)
+        next = keep ? prev : cpu->idle;
+
+    if (next == prev)
+        prev->state = TASK_RUNNING;
+    else
+        sched_switch(cpu, sc, prev, next);
+    irq_restore(flags);
+}
+
+void schedule(void) {
+    __schedule(false);
+}
+
+void sched_yield(void) {
+    if (sched_cpus[smp_cpu_id()].online)
+        __schedule(false);
+}
+
+void sched_irq_exit(void) {
+    cpu_t *cpu = this_cpu();
+
+    // the interrupted code was not in a read-side section, and the handler
+    // has finished with whatever it looked up
+    if (cpu->preempt_count == 0)
+        rcu_note_qs();
+
+    if (!cpu->need_resched || cpu->preempt_count != 0 || !sched_cpus[cpu->id].online)
+        return;
+    sched_cpus[cpu->id].stats.preemptions++;
+    __schedule(true);
+}
+
+bool sched_should_yield(void) {
+    cpu_t *cpu = this_cpu();
+    sched_cpu_t *sc = &sched_cpus[cpu->id];
+
+    return sc->online && cpu->current != cpu->idle && (cpu->need_resched || sc->rq.nr_queued != 0);
+}
+
+bool sched_active(void) {
+    task_t *self = current_task();
+
+    return self != NULL && sched_cpus[self->cpu].online && self != smp_cpu(self->cpu)->idle;
+}
+
+void sched_prepare_block(void) {
+    task_t *self = current_task();
+    uint64_t flags = irq_save();
+
+    arch_spin_lock(&self->lock);
+    self->state = TASK_BLOCKED;
+    arch_spin_unlock(&self->lock);
+    irq_restore(flags);
+}
+
+void sched_cancel_block(void) {
+    task_t *self = current_task();
+    uint64_t flags = irq_save();
+
+    arch_spin_lock(&self->lock);
+    self->state = TASK_RUNNING;
+    arch_spin_unlock(&self->lock);
+    irq_restore(flags);
+}
+
+// A task still on its CPU is left to sched_finish_switch(), its stack is in
+// use until then
+bool sched_wake(task_t *task) {
+    uint64_t flags = irq_save();
+
+    arch_spin_lock(&task->lock);
+    if (task->state != TASK_BLOCKED) {
+        arch_spin_unlock(&task->lock);
+        irq_restore(flags);
+        return false;
+    }
+    task->state = TASK_RUNNABLE;
+    task->woken_ns = ktime_ns();
+    bool enqueue = !task->on_cpu;
+    arch_spin_unlock(&task->lock);
+
+    if (enqueue)
+        sched_enqueue(task);
+    irq_restore(flags);
+    return true;
+}
+
+// The slice timer only asks for a switch, sched_irq_exit() does it. It keeps
+// running while the task does, a queue that was empty when the slice began
+// may not be by the end of it
+static void sched_slice_expired(void *arg) {
+    sched_cpu_t *sc = arg;
+    cpu_t *cpu = this_cpu();
+
+    if (cpu->current == cpu->idle)
+        return;
+    cpu->need_resched = true;
+    mod_timer(&sc->slice, ktime_ns() + SCHED_SLICE_NS);
+}
+
+// nothing to do, sched_irq_exit() picks up need_resched on the way out
+static void sched_ipi(Registers_t *regs) {
+    (void)regs;
+}
+
+static task_t *sched_task_alloc(const char *name, task_fn_t fn, void *arg, uint32_t cpu) {
+    task_t *task = malloc(sizeof(task_t));
+    uint8_t *stack = task != NULL ? malloc(SCHED_STACK_SIZE) : NULL;
+    if (stack != NULL) {
+        memset(task, 0, sizeof(*task));
+        if (fpu_ctx_init(&task->fpu) != 0) {
+            free(stack);
+            stack = NULL;
+        }
+    }
+    if (task != NULL && stack == NULL) {
+        free(task);
+        task = NULL;
+    }
+    if (task == NULL)
+        return NULL;
+
+    task->tid = __atomic_fetch_add(&sched_next_tid, 1, __ATOMIC_RELAXED);
+    task->state = TASK_RUNNABLE;
+    task->cpu = cpu == SCHED_ANY_CPU ? smp_cpu_id() : cpu;
+    task->pinned = cpu;
+    spin_lock_init(&task->lock);
+    task->name = name;
+    task->fn = fn;
+    task->arg = arg;
+    task->stack = stack;
+    task->rsp = context_stack_init(stack + SCHED_STACK_SIZE, sched_task_start);
+    return task;
+}
+
+static void sched_task_free(task_t *task) {
+    fpu_ctx_free(&task->fpu);
+    free(task->stack);
+    free(task);
+}
+
+// first thing a new task runs, context_switch() returns here
+static void sched_task_start(void) {
+    sched_finish_switch();
+    enable_interrupts();
+
+    task_t *self = current_task();
+    self->fn(self->arg);
+    kthread_exit(0);
+}
+
+task_t *kthread_create_on(const char *name, task_fn_t fn, void *arg, uint32_t cpu) {
+    if (fn == NULL || !sched_cpus[0].online)
+        return NULL;
+    if (cpu != SCHED_ANY_CPU && (cpu >= SMP_MAX_CPUS || !sched_cpus[cpu].online))
+        return NULL;
+
+    task_t *task = sched_task_alloc(name, fn, arg, cpu);
+    if (task == NULL)
+        return NULL;
+
+    uint64_t flags = irq_save();
+    task->woken_ns = ktime_ns();
+    sched_enqueue(task);
+    irq_restore(flags);
+    return task;
+}
+
+task_t *kthread_create(const char *name, task_fn_t fn, void *arg) {
+    return kthread_create_on(name, fn, arg, SCHED_ANY_CPU);
+}
+
+void kthread_exit(int code) {
+    task_t *self = current_task();
+
+    disable_interrupts();
+    arch_spin_lock(&self->lock);
+    self->exit_code = code;
+    self->state = TASK_DEAD;
+    arch_spin_unlock(&self->lock);
+    schedule();
+
+    for (;;)
+        __asm__ volatile("hlt");
+}
+
+int kthread_join(task_t *task) {
+    task_t *self = current_task();
+    uint64_t flags = irq_save();
+
+    for (;;) {
+        sched_prepare_block();
+        arch_spin_lock(&task->lock);
+        if (task->state == TASK_DEAD && !task->on_cpu) {
+            arch_spin_unlock(&task->lock);
+            sched_cancel_block();
+            break;
+        }
+        task->joiner = self;
+        arch_spin_unlock(&task->lock);
+        schedule();
+    }
+    irq_restore(flags);
+
+    int code = task->exit_code;
+    sched_task_free(task);
+    return code;
+}
+
+__attribute__((noreturn)) void sched_idle_loop(void) {
+    uint32_t id = smp_cpu_id();
+    sched_cpu_t *sc = &sched_cpus[id];
+
+    for (;;) {
+        if (!sc->online) {
+            cpu_idle();
+            continue;
+        }
+
+        // pairs with the fence in sched_enqueue()
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        // a kick that found us polling in MWAIT sent no IPI, need_resched is
+        // all there is to go on
+        uint64_t switches = sc->stats.switches;
+        if (this_cpu()->need_resched || sc->rq.nr_queued != 0 || sched_busiest(id) != SCHED_ANY_CPU)
+            schedule();
+
+        // came straight back, what is queued elsewhere is pinned there
+        if (sc->stats.switches == switches)
+            cpu_idle();
+    }
+}
+
+static void sched_idle_task(void *arg) {
+    (void)arg;
+    sched_idle_loop();
+}
+
+// kernel_main carries on as the BSP's first task. It stays on the BSP, the
+// shell and the drivers it calls into were written for one CPU
+void sched_init(void) {
+    cpu_t *cpu = this_cpu();
+    sched_cpu_t *sc = &sched_cpus[cpu->id];
+    task_t *boot = &sched_boot_tasks[cpu->id];
+
+    for (uint32_t id = 0; id < SMP_MAX_CPUS; id++) {
+        runqueue_init(&sched_cpus[id].rq);
+        spin_lock_init(&sched_cpus[id].lock);
+    }
+
+    boot->tid = 0;
+    boot->name = "kmain";
+    boot->state = TASK_RUNNING;
+    boot->on_cpu = true;
+    boot->cpu = boot->pinned = cpu->id;
+    boot->last_in_ns = ktime_ns();
+    spin_lock_init(&boot->lock);
+
+    task_t *idle = sched_task_alloc("idle", sched_idle_task, NULL, cpu->id);
+    if (idle == NULL || fpu_ctx_init(&boot->fpu) != 0) {
+        LOG_WARN("No memory for the idle task, staying single tasking\n");
+        SERIAL(Warn, sched_init, "No memory for the idle task, staying single tasking\n");
+        return;
+    }
+    fpu_adopt(&boot->fpu);
+    cpu->idle = idle;
+    cpu->current = boot;
+
+    timer_setup(&sc->slice, sched_slice_expired, sc);
+    APIC_IRQ_RegisterHandler(SCHED_IPI_IRQ, sched_ipi);
+    __atomic_store_n(&sc->online, true, __ATOMIC_RELEASE);
+    mod_timer(&sc->slice, ktime_ns() + SCHED_SLICE_NS);
+
+    LOG_INFO("Scheduler running, %lu ms slices\n", SCHED_SLICE_NS / 1000000);
+    SERIAL(Info, sched_init, "Scheduler running, %lu ms slices\n", SCHED_SLICE_NS / 1000000);
+}
+
+// the AP keeps running on the stack Limine gave it, as its idle task
+void sched_init_cpu(void) {
+    cpu_t *cpu = this_cpu();
+    sched_cpu_t *sc = &sched_cpus[cpu->id];
+    task_t *idle = &sched_boot_tasks[cpu->id];
+
+    if (!sched_cpus[0].online)
+        return;
+
+    if (fpu_ctx_init(&idle->fpu) != 0) {
+        LOG_WARN("No memory for the FPU state of CPU %u, it will not run tasks\n", cpu->id);
+        SERIAL(Warn, sched_init_cpu, "No memory for the FPU state of CPU %u, it will not run tasks\n", cpu->id);
+        return;
+    }
+    fpu_adopt(&idle->fpu);
+
+    idle->tid = __atomic_fetch_add(&sched_next_tid, 1, __ATOMIC_RELAXED);
+    idle->name = "idle";
+    idle->state = TASK_RUNNING;
+    idle->on_cpu = true;
+    idle->cpu = idle->pinned = cpu->id;
+    idle->last_in_ns = ktime_ns();
+    spin_lock_init(&idle->lock);
+    cpu->idle = cpu->current = idle;
+
+    timer_setup(&sc->slice, sched_slice_expired, sc);
+    __atomic_store_n(&sc->online, true, __ATOMIC_RELEASE);
+}
+
+void sched_print_stats(void) {
+    printf("cpu  current   queued  switches  preempts  steals  ipis  polled  wake latency avg/max(ns)\n");
+    for (uint32_t id = 0; id < SMP_MAX_CPUS; id++) {
+        sched_cpu_t *sc = &sched_cpus[id];
+        if (!sc->online)
+            continue;
+        task_t *current = smp_cpu(id)->current;
+        uint64_t woken = sc->stats.wakeups ? sc->stats.wakeups : 1;
+        printf("%3u  %-8s  %6u  %8lu  %8lu  %6lu  %4lu  %6lu  %lu/%lu\n", id, current->name, sc->rq.nr_queued,
+               sc->stats.switches, sc->stats.preemptions, sc->stats.steals, sc->stats.ipis, sc->stats.polled,
+               sc->stats.wake_lat_sum_ns / woken, sc->stats.wake_lat_max_ns);
+    }
+}
+
+typedef struct {
+    volatile bool go;
+    volatile uint64_t end_ns;
+    volatile uint32_t posted;   // wakeups sent
+    volatile uint32_t seen;     // wakeups the waiter got through
+    volatile uint64_t posted_ns;
+    uint64_t lat_sum_ns;
+    uint64_t lat_max_ns;
+    uint64_t deadline_ns;
+} sched_bench_t;
+
+typedef struct {
+    uint64_t deadline_ns;
+    volatile uint64_t spins;    // work done, the fair share is the mean
+} sched_spinner_t;
+
+static void sched_bench_yielder(void *arg) {
+    sched_bench_t *b = arg;
+
+    while (!b->go)
+        sched_yield();
+    for (uint32_t i = 0; i < SCHED_BENCH_SWITCHES / 2; i++)
+        sched_yield();
+
+    uint64_t now = ktime_ns();
+    if (now > b->end_ns)
+        b->end_ns = now;
+}
+
+static void sched_bench_waiter(void *arg) {
+    sched_bench_t *b = arg;
+
+    for (uint32_t i = 0; i < SCHED_BENCH_WAKEUPS; i++) {
+        while (__atomic_load_n(&b->posted, __ATOMIC_ACQUIRE) <= i) {
+            sched_prepare_block();
+            if (__atomic_load_n(&b->posted, __ATOMIC_ACQUIRE) <= i)
+                schedule();
+            else
+                sched_cancel_block();
+        }
+
+        uint64_t lat = ktime_ns() - b->posted_ns;
+        b->lat_sum_ns += lat;
+        if (lat > b->lat_max_ns)
+            b->lat_max_ns = lat;
+        __atomic_store_n(&b->seen, i + 1, __ATOMIC_RELEASE);
+    }
+}
+
+static void sched_bench_spinner(void *arg) {
+    sched_spinner_t *sp = arg;
+
+    while (ktime_ns() < sp->deadline_ns)
+        sp->spins++;
+}
+
+// waiting on a task that shares our CPU has to give it the CPU
+static void sched_bench_wait(bool same_cpu) {
+    if (same_cpu)
+        sched_yield();
+    else
+        __asm__ volatile("pause");
+}
+
+// sum of squares would overflow at full resolution
+static uint64_t sched_jain_permille(sched_spinner_t *sp, uint32_t n) {
+    uint64_t sum = 0, sum_sq = 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t x = sp[i].spins >> 10;
+        sum += x;
+        sum_sq += x * x;
+    }
+    if (sum_sq == 0)
+        return 0;
+    return (sum * sum / n) * 1000 / sum_sq;
+}
+
+// Context switch cost between two tasks yielding to each other, the latency
+// from sched_wake() on one CPU to the task running on another, and how evenly
+// CPU-bound tasks share the CPUs. The benchmarks run on CPU 1 where there is
+// one, away from the shell
+void sched_bench(void) {
+    if (!sched_active()) {
+        printf("The scheduler is not running\n");
+        return;
+    }
+
+    static sched_bench_t b;
+    uint32_t cpus = smp_cpu_count();
+    uint32_t far = cpus > 1 ? 1 : 0;
+    uint32_t here = smp_cpu_id();
+
+    memset(&b, 0, sizeof(b));
+    task_t *ya = kthread_create_on("yield", sched_bench_yielder, &b, far);
+    task_t *yb = kthread_create_on("yield", sched_bench_yielder, &b, far);
+    if (ya == NULL || yb == NULL) {
+        printf("Could not create the benchmark tasks\n");
+        b.go = true;
+        if (ya != NULL)
+            kthread_join(ya);
+        if (yb != NULL)
+            kthread_join(yb);
+        return;
+    }
+    uint64_t switches = sched_cpus[far].stats.switches;
+    uint64_t start = ktime_ns();
+    b.go = true;
+    kthread_join(ya);
+    kthread_join(yb);
+    switches = sched_cpus[far].stats.switches - switches;
+    printf("context switch: %lu ns (%lu switches on CPU %u)\n",
+           switches ? (b.end_ns - start) / switches : 0, switches, far);
+
+    memset(&b, 0, sizeof(b));
+    task_t *waiter = kthread_create_on("waiter", sched_bench_waiter, &b, far);
+    if (waiter == NULL) {
+        printf("Could not create the benchmark tasks\n");
+        return;
+    }
+    for (uint32_t i = 0; i < SCHED_BENCH_WAKEUPS; i++) {
+        // fully switched out, so the wakeup takes the whole path
+        while (waiter->state != TASK_BLOCKED || waiter->on_cpu)
+            sched_bench_wait(far == here);
+        b.posted_ns = ktime_ns();
+        __atomic_store_n(&b.posted, i + 1, __ATOMIC_RELEASE);
+        sched_wake(waiter);
+        while (__atomic_load_n(&b.seen, __ATOMIC_ACQUIRE) != i + 1)
+            sched_bench_wait(far == here);
+    }
+    kthread_join(waiter);
+    printf("wakeup to run:  avg %lu ns, max %lu ns (CPU %u to CPU %u, %u wakeups)\n",
+           b.lat_sum_ns / SCHED_BENCH_WAKEUPS, b.lat_max_ns, here, far, SCHED_BENCH_WAKEUPS);
+
+    static sched_spinner_t spinners[SCHED_BENCH_MAX_SPINNERS];
+    static task_t *tasks[SCHED_BENCH_MAX_SPINNERS];
+    uint32_t n = min(2 * cpus, SCHED_BENCH_MAX_SPINNERS);
+    uint64_t deadline = ktime_ns() + SCHED_BENCH_SPIN_MS * 1000000ull;
+    uint32_t started = 0;
+
+    for (; started < n; started++) {
+        spinners[started].deadline_ns = deadline;
+        spinners[started].spins = 0;
+        tasks[started] = kthread_create("spin", sched_bench_spinner, &spinners[started]);
+        if (tasks[started] == NULL)
+            break;
+    }
+    for (uint32_t i = 0; i < started; i++)
+        kthread_join(tasks[i]);
+    if (started == 0)
+        return;
+
+    uint64_t lo = UINT64_MAX, hi = 0, sum = 0;
+    for (uint32_t i = 0; i < started; i++) {
+        lo = min(lo, spinners[i].spins);
+        hi = max(hi, spinners[i].spins);
+        sum += spinners[i].spins;
+    }
+    uint64_t mean = sum / started ? sum / started : 1;
+    uint64_t jain = sched_jain_permille(spinners, started);
+    printf("fairness:       %u tasks on %u CPUs for %u ms, min/max %lu%%/%lu%% of the mean, Jain index %lu.%03lu\n",
+           started, cpus, SCHED_BENCH_SPIN_MS, lo * 100 / mean, hi * 100 / mean, jain / 1000, jain % 1000);
+}
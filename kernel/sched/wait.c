@@ -0,0 +1,286 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: wait.c
+    Description: Wait queues and completions for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/wait.h"
+#include "includes/sched.h"
+#include "kernel/time/includes/time.h"
+#include "kernel/time/includes/timer.h"
+#include "kernel/system/includes/idle.h"
+#include "arch/x86_64/includes/io.h"
+#include "kernel/system/includes/percpu.h"
+
+// Before the scheduler runs, a waiter halts instead of blocking and its
+// entry has no task to wake. A wake_up() that dequeues such an entry bumps
+// the count; the waiter compares it with the value from when it queued
+// itself, with interrupts off, and only then halts
+static uint32_t wait_halt_wakeups;
+static DEFINE_PER_CPU(uint32_t, wait_halt_seen);
+
+void wait_queue_init(wait_queue_t *wq) {
+    spin_lock_init(&wq->lock);
+    wq->head = NULL;
+    wq->tail = NULL;
+}
+
+void wait_entry_init(wait_entry_t *entry) {
+    entry->task = sched_active() ? current_task() : NULL;
+    entry->next = NULL;
+    entry->prev = NULL;
+    entry->queued = false;
+}
+
+// wq lock held for all of these
+static void wait_enqueue_locked(wait_queue_t *wq, wait_entry_t *entry) {
+    entry->next = NULL;
+    entry->prev = wq->tail;
+    if (wq->tail)
+        wq->tail->next = entry;
+    else
+        wq->head = entry;
+    wq->tail = entry;
+    entry->queued = true;
+}
+
+static void wait_dequeue_locked(wait_queue_t *wq, wait_entry_t *entry) {
+    if (entry->prev)
+        entry->prev->next = entry->next;
+    else
+        wq->head = entry->next;
+    if (entry->next)
+        entry->next->prev = entry->prev;
+    else
+        wq->tail = entry->prev;
+    entry->next = entry->prev = NULL;
+    entry->queued = false;
+}
+
+static void wait_prepare_locked(wait_queue_t *wq, wait_entry_t *entry) {
+    if (!entry->queued)
+        wait_enqueue_locked(wq, entry);
+    if (entry->task)
+        sched_prepare_block();
+    else
+        *this_cpu_ptr(wait_halt_seen) = __atomic_load_n(&wait_halt_wakeups, __ATOMIC_ACQUIRE);
+}
+
+static void wait_finish_locked(wait_queue_t *wq, wait_entry_t *entry) {
+    if (entry->task)
+        sched_cancel_block();
+    if (entry->queued)
+        wait_dequeue_locked(wq, entry);
+}
+
+// The woken entry is unlinked before its task runs, so it may already be off
+// the waiter's stack by the time the lock is dropped
+static uint32_t wake_up_locked(wait_queue_t *wq, uint32_t max) {
+    uint32_t woken = 0;
+
+    while (wq->head && woken < max) {
+        wait_entry_t *entry = wq->head;
+        task_t *task = entry->task;
+
+        wait_dequeue_locked(wq, entry);
+        if (task)
+            sched_wake(task);
+        else
+            __atomic_fetch_add(&wait_halt_wakeups, 1, __ATOMIC_RELEASE);
+        woken++;
+    }
+    return woken;
+}
+
+void prepare_to_wait(wait_queue_t *wq, wait_entry_t *entry) {
+    uint64_t flags = spin_lock_irqsave(&wq->lock);
+    wait_prepare_locked(wq, entry);
+    spin_unlock_irqrestore(&wq->lock, flags);
+}
+
+void finish_wait(wait_queue_t *wq, wait_entry_t *entry) {
+    uint64_t flags = spin_lock_irqsave(&wq->lock);
+    wait_finish_locked(wq, entry);
+    spin_unlock_irqrestore(&wq->lock, flags);
+}
+
+uint32_t wake_up(wait_queue_t *wq) {
+    uint64_t flags = spin_lock_irqsave(&wq->lock);
+    uint32_t woken = wake_up_locked(wq, UINT32_MAX);
+    spin_unlock_irqrestore(&wq->lock, flags);
+    return woken;
+}
+
+uint32_t wake_up_one(wait_queue_t *wq) {
+    uint64_t flags = spin_lock_irqsave(&wq->lock);
+    uint32_t woken = wake_up_locked(wq, 1);
+    spin_unlock_irqrestore(&wq->lock, flags);
+    return woken;
+}
+
+uint64_t wait_deadline(uint64_t timeout_ns) {
+    if (timeout_ns == WAIT_FOREVER)
+        return WAIT_FOREVER;
+    uint64_t now = ktime_ns();
+    return timeout_ns < WAIT_FOREVER - now ? now + timeout_ns : WAIT_FOREVER - 1;
+}
+
+static void wait_timeout_wake(void *arg) {
+    sched_wake(arg);
+}
+
+// only has to make the halted CPU take an interrupt
+static void wait_timeout_nop(void *arg) {
+    (void)arg;
+}
+
+bool schedule_timeout(uint64_t deadline_ns) {
+    if (deadline_ns != WAIT_FOREVER && ktime_ns() >= deadline_ns)
+        return false;
+
+    if (!sched_active()) {
+        ktimer_t timer;
+        if (deadline_ns != WAIT_FOREVER)
+            timer_add(&timer, deadline_ns, wait_timeout_nop, NULL);
+
+        // a wakeup from here on ends the halt, one before it shows in the count
+        uint64_t flags = irq_save();
+        if (!(flags & (1 << 9)))
+            __asm__ volatile("pause");
+        else if (__atomic_load_n(&wait_halt_wakeups, __ATOMIC_ACQUIRE) == *this_cpu_ptr(wait_halt_seen))
+            cpu_idle_irqoff();
+        irq_restore(flags);
+        if (deadline_ns != WAIT_FOREVER)
+            timer_cancel(&timer);
+        return deadline_ns == WAIT_FOREVER || ktime_ns() < deadline_ns;
+    }
+
+    if (deadline_ns == WAIT_FOREVER) {
+        schedule();
+        return true;
+    }
+
+    // Timers are per CPU and only cancelled from their own, so the task is
+    // pinned until its timer is gone. With interrupts off it cannot be moved
+    // between reading the CPU id and pinning it there
+    task_t *self = current_task();
+    uint64_t flags = irq_save();
+    uint32_t pinned = self->pinned;
+    self->pinned = smp_cpu_id();
+    irq_restore(flags);
+
+    ktimer_t timer;
+    timer_add(&timer, deadline_ns, wait_timeout_wake, self);
+    schedule();
+    timer_cancel(&timer);
+    self->pinned = pinned;
+
+    return ktime_ns() < deadline_ns;
+}
+
+void init_completion(completion_t *c) {
+    wait_queue_init(&c->wait);
+    c->done = 0;
+}
+
+void reinit_completion(completion_t *c) {
+    c->done = 0;
+}
+
+void complete(completion_t *c) {
+    uint64_t flags = spin_lock_irqsave(&c->wait.lock);
+    if (c->done != UINT32_MAX)
+        c->done++;
+    wake_up_locked(&c->wait, 1);
+    spin_unlock_irqrestore(&c->wait.lock, flags);
+}
+
+void complete_all(completion_t *c) {
+    uint64_t flags = spin_lock_irqsave(&c->wait.lock);
+    c->done = UINT32_MAX;
+    wake_up_locked(&c->wait, UINT32_MAX);
+    spin_unlock_irqrestore(&c->wait.lock, flags);
+}
+
+// wq lock held
+static bool completion_consume_locked(completion_t *c) {
+    if (c->done == 0)
+        return false;
+    if (c->done != UINT32_MAX)
+        c->done--;
+    return true;
+}
+
+// A waiter that was woken by complete() but timed out before it could look
+// still takes the count, complete() only wakes one waiter per call
+bool wait_for_completion_timeout(completion_t *c, uint64_t timeout_ns) {
+    uint64_t deadline = wait_deadline(timeout_ns);
+    wait_entry_t entry;
+    wait_entry_init(&entry);
+
+    uint64_t flags = spin_lock_irqsave(&c->wait.lock);
+    for (;;) {
+        if (completion_consume_locked(c)) {
+            wait_finish_locked(&c->wait, &entry);
+            spin_unlock_irqrestore(&c->wait.lock, flags);
+            return true;
+        }
+        if (deadline != WAIT_FOREVER && ktime_ns() >= deadline)
+            break;
+
+        wait_prepare_locked(&c->wait, &entry);
+        spin_unlock_irqrestore(&c->wait.lock, flags);
+        schedule_timeout(deadline);
+        flags = spin_lock_irqsave(&c->wait.lock);
+    }
+    wait_finish_locked(&c->wait, &entry);
+    spin_unlock_irqrestore(&c->wait.lock, flags);
+    return false;
+}
+
+void wait_for_completion(completion_t *c) {
+    wait_for_completion_timeout(c, WAIT_FOREVER);
+}
+
+bool try_wait_for_completion(completion_t *c) {
+    uint64_t flags = spin_lock_irqsave(&c->wait.lock);
+    bool done = completion_consume_locked(c);
+    spin_unlock_irqrestore(&c->wait.lock, flags);
+    return done;
+}
+
+bool completion_done(completion_t *c) {
+    return __atomic_load_n(&c->done, __ATOMIC_ACQUIRE) != 0;
+}
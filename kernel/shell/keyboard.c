@@ -49,18 +49,17 @@
 #include "drivers/pic/includes/apic/apic_irq.h"
 #include "drivers/pic/includes/pic.h"
 #include "drivers/pic/includes/apic/apic.h"
+#include "drivers/pic/includes/apic/ioapic.h"
 #include "arch/x86_64/includes/io.h"
 #include "tools/includes/log-info.h"
 #include "tools/includes/util.h"
+#include "kernel/sched/includes/wait.h"
 
 #define KEYBOARD_IRQ_VECTOR         1
 #define KEYBOARD_INTERRUPT_VECTOR   0x21
-// IOAPIC base address and redirection entry for IRQ1 (keyboard)
+// IOAPIC vector for IRQ1 (keyboard), the pin comes from the MADT
 
-#define IOAPIC_IRQ1_ENTRY     0x12  // Entry for IRQ1 in the Redirection Table
 #define IOAPIC_IRQ1_VECTOR    0x21  // IRQ1 uses vector 0x21 on x86 systems (keyboard)
-#define IOAPIC_DELIVERY_MODE  0x00000100  // Fixed delivery mode (normal interrupt)
-#define IOAPIC_DESTINATION    0x00000000  // Send to all CPUs (this is usually specific for SMP systems)
 
 uint8_t keyboard_read_response_safe() {
     // Wait until output buffer is full
@@ -191,6 +190,15 @@ uint8_t keyboard_identify() {
     return 2;
 }
 
+// getc() sleeps here until the key state changes
+static wait_queue_t keyboard_wait = WAIT_QUEUE_INIT;
+static volatile uint32_t keyboard_events;
+
+static void keyboard_notify(void) {
+    __atomic_fetch_add(&keyboard_events, 1, __ATOMIC_RELEASE);
+    wake_up(&keyboard_wait);
+}
+
 // Keyboard interrupt handler
 void keyboard_handler(Registers_t *regs) {
     static bool extended = false;
@@ -246,6 +254,7 @@ void keyboard_handler(Registers_t *regs) {
             keyboard.mods = BIT_SET(keyboard.mods, HIBIT(KEY_MOD_SCROLL_LOCK), KEY_IS_PRESS(scancode));
         }
         
+        keyboard_notify();
         (void)regs;
         return;
     }
@@ -284,6 +293,7 @@ void keyboard_handler(Registers_t *regs) {
         //terminal_printf("You released %c \n", KEY_CHAR(scancode|keyboard.mods));
     }
 
+    keyboard_notify();
     LAPIC_SendEOI();
     (volatile void)regs;
 }
@@ -303,45 +313,17 @@ void keyboard_apic_init() {
 
 // Function to configure IOAPIC for keyboard interrupt (IRQ1)
 void IOAPIC_ConfigureKeyboard() {
-    uint32_t entry_low, entry_high;
-
-    // Read current IRQ1 entry
-    entry_low = APIC_ReadIO(IOAPIC_IRQ1_ENTRY);       // Lower 32 bits
-    entry_high = APIC_ReadIO(IOAPIC_IRQ1_ENTRY + 1);  // Upper 32 bits
-
-    // Configure lower 32-bit redirection entry
-    entry_low &= ~0x000000FF;  // Reset APICINT
-    entry_low = IOAPIC_IRQ1_VECTOR;  // Set interrupt vector (0x21)
-    entry_low &= ~0x00000700;  // Reset trig flag
-    entry_low |= APIC_DELIVERY_MODE_FIXED;  // Fixed delivery mode
-    entry_low &= ~(1 << 15);  // Edge-triggered (bit 15 = 0 for edge)
-    entry_low &= ~(1 << 13);  // Active high polarity (bit 13 = 0 for high)
-    entry_low &= ~(1 << 16); // Enable interrupt (bit 16 = 0)
-
-    // Configure upper 32-bit redirection entry (destination field)
-    entry_high &= ~0xFF000000;  // Clear the destination field
-    entry_high |= (0 << 24);   // Route interrupt to CPU 0 (bit 24 = 1)
-
-    // Write the updated values back
-    APIC_WriteIO(IOAPIC_IRQ1_ENTRY, entry_low);       // Write lower 32 bits
-    APIC_WriteIO(IOAPIC_IRQ1_ENTRY + 1, entry_high);  // Write upper 32 bits
-
-    ;
+    // edge triggered and active high unless the MADT overrides IRQ1, on the boot CPU
+    if (irq_route_isa(KEYBOARD_IRQ_VECTOR, IOAPIC_IRQ1_VECTOR, 0) != 0)
+        return;
+
     LOG_INFO("IOAPIC Keyboard IRQ Initialized successfully.\n");
     SERIAL(Info, IOAPIC_ConfigureKeyboard, "IOAPIC Keyboard IRQ Initialized successfully.\n");
 }
 
 // Function to mask the keyboard interrupt (IRQ1)
 void IOAPIC_MaskIRQ1() {
-    uint32_t entry_low, entry_high;
-
-    entry_low = APIC_ReadIO(IOAPIC_IRQ1_ENTRY);  // Lower 32 bits
-    entry_high = APIC_ReadIO(IOAPIC_IRQ1_ENTRY + 1);  // Upper 32 bits
-
-    entry_low |= 0x00010000; 
-
-    APIC_WriteIO(IOAPIC_IRQ1_ENTRY, entry_low);  // Write lower 32 bits
-    APIC_WriteIO(IOAPIC_IRQ1_ENTRY + 1, entry_high);  // Write upper 32 bits
+    irq_mask(irq_isa_to_gsi(KEYBOARD_IRQ_VECTOR));
     printf("Masked IRQ1 (Keyboard)");
 }
 
@@ -351,6 +333,7 @@ char getc(void) {
     static bool key_was_pressed[128] = {false};
     
     while (1) {
+    uint32_t seen = __atomic_load_n(&keyboard_events, __ATOMIC_ACQUIRE);
     (void)(keyboard.keys[KEY_LSHIFT] || keyboard.keys[KEY_RSHIFT]);
     (void)(keyboard.mods & KEY_MOD_CAPS_LOCK);
 
@@ -373,5 +356,9 @@ char getc(void) {
                 key_was_pressed[key] = false;
             }
         }
+
+        // key state only changes from the keyboard interrupt, sleep until it
+        // has run since the scan started
+        wait_event(&keyboard_wait, __atomic_load_n(&keyboard_events, __ATOMIC_ACQUIRE) != seen);
     }
 }
\ No newline at end of file
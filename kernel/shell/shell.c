@@ -45,6 +45,18 @@
 #include <stdio.h>
 #include "mm/includes/pmm.h"
 #include "arch/x86_64/includes/isr.h"
+#include "kernel/time/includes/time.h"
+#include "kernel/time/includes/timer.h"
+#include "kernel/time/includes/clocksource.h"
+#include "kernel/system/includes/idle.h"
+#include "kernel/system/includes/smp.h"
+#include "kernel/sched/includes/sched.h"
+#include "arch/x86_64/includes/fpu.h"
+#include "kernel/system/includes/locks.h"
+#include "kernel/system/includes/rcu.h"
+#include "drivers/pic/includes/apic/ioapic.h"
+#include "drivers/pci/includes/msi.h"
+#include "kernel/storage/includes/sata.h"
 #include <stdlib.h>
 #include <limits.h>
 
@@ -58,6 +70,16 @@ typedef enum {
     SHCMD_PANIC,
     SHCMD_BIRDSAY,
     SHCMD_UPTIME,
+    SHCMD_TIMEBENCH,
+    SHCMD_TIMERS,
+    SHCMD_IDLE,
+    SHCMD_CLOCKSOURCE,
+    SHCMD_CPUS,
+    SHCMD_SCHED,
+    SHCMD_FPU,
+    SHCMD_LOCK,
+    SHCMD_RCU,
+    SHCMD_IRQ,
     SHCMD_UNKNOWN 
 } shell_command_t;
 
@@ -69,6 +91,16 @@ shell_command_t get_command(const char *buffer) {
     if (strcmp(buffer, "panic") == 0) return SHCMD_PANIC;
     if (strcmp(buffer, "birdsay") == 0) return SHCMD_BIRDSAY;
     if (strcmp(buffer, "uptime") == 0) return SHCMD_UPTIME;
+    if (strcmp(buffer, "timebench") == 0) return SHCMD_TIMEBENCH;
+    if (strcmp(buffer, "timers") == 0) return SHCMD_TIMERS;
+    if (strcmp(buffer, "idle") == 0) return SHCMD_IDLE;
+    if (strcmp(buffer, "clocksource") == 0) return SHCMD_CLOCKSOURCE;
+    if (strcmp(buffer, "cpus") == 0) return SHCMD_CPUS;
+    if (strcmp(buffer, "sched") == 0) return SHCMD_SCHED;
+    if (strcmp(buffer, "fpu") == 0) return SHCMD_FPU;
+    if (strcmp(buffer, "lock") == 0) return SHCMD_LOCK;
+    if (strcmp(buffer, "rcu") == 0) return SHCMD_RCU;
+    if (strcmp(buffer, "irq") == 0) return SHCMD_IRQ;
 
     return SHCMD_UNKNOWN;
 }
@@ -90,6 +122,16 @@ void cmd_help(void) {
     printf("  panic     - Calls a kernel panic\n");
     printf("  birdsay   - Cowsay, but with a bird\n");
     printf("  uptime    - Gets the uptime in seconds\n");
+    printf("  timebench - Delay accuracy of each clocksource\n");
+    printf("  timers    - Kernel timer wheel statistics per CPU\n");
+    printf("  idle      - Idle wakeups and residency ('idle reset' to restart)\n");
+    printf("  clocksource - Lists clocksources, 'clocksource <name>' switches\n");
+    printf("  cpus      - Online CPUs with their interrupt and syscall counts\n");
+    printf("  sched     - Run queues and switch counts per CPU ('sched bench' to measure)\n");
+    printf("  fpu       - FPU save mode and lazy switch counts per CPU\n");
+    printf("  lock      - Heap and page allocator lock contention ('lock bench' to compare lock types)\n");
+    printf("  rcu       - RCU grace period and callback statistics\n");
+    printf("  irq       - IOAPICs, ISA IRQ overrides, routed GSIs, MSI vectors and AHCI ports\n");
 }
 
 void cmd_clear(void) {
@@ -101,7 +143,7 @@ void cmd_clear(void) {
 
 void uptime(void){
 
-    printf("Uptime: %d second(s)\n", get_time_ms()/1000);
+    printf("Uptime: %lu second(s)\n", ktime_ns() / 1000000000);
 
 }
 
@@ -172,6 +214,48 @@ void execute(char* buffer) {
         case SHCMD_UPTIME:
             uptime();
             break;
+        case SHCMD_TIMEBENCH:
+            time_print_sources();
+            break;
+        case SHCMD_TIMERS:
+            timer_print_stats();
+            break;
+        case SHCMD_CLOCKSOURCE:
+            if (has_args && clocksource_select(clocksource_find(args)) != 0)
+                printf("No usable clocksource named %s\n", args);
+            clocksource_print();
+            break;
+        case SHCMD_CPUS:
+            smp_print_cpus();
+            break;
+        case SHCMD_SCHED:
+            if (has_args && strcmp(args, "bench") == 0)
+                sched_bench();
+            sched_print_stats();
+            break;
+        case SHCMD_FPU:
+            fpu_print_stats();
+            break;
+        case SHCMD_LOCK:
+            if (has_args && strcmp(args, "bench") == 0)
+                lock_bench();
+            else
+                lock_print_stats();
+            break;
+        case SHCMD_RCU:
+            rcu_print_stats();
+            break;
+        case SHCMD_IRQ:
+            ioapic_print_routes();
+            msi_print_vectors();
+            sata_print_stats();
+            break;
+        case SHCMD_IDLE:
+            if (has_args && strcmp(args, "reset") == 0)
+                idle_reset_stats();
+            else
+                idle_print_stats();
+            break;
         case SHCMD_BIRDSAY:
             if (has_args) {
                 printf("   \\\\\n");
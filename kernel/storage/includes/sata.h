@@ -42,6 +42,29 @@
 #include <stdint.h>
 #define SATA_WAIT_TIMEOUT 1000
 #define SATA_WAIT_TIMEOUT_PER_SECTOR 250
+#define SATA_WAIT_TICK_US 10            // the timeouts above count these
+#define SATA_SPIN_US 200                // polled before sleeping between polls
+// PxIS: task file, host bus fatal, host bus data and interface fatal errors.
+// Each stops the command list, PxCI would never clear
+#define SATA_PxIS_TFES   (1u << 30)
+#define SATA_PxIS_HBFS   (1u << 29)
+#define SATA_PxIS_HBDS   (1u << 28)
+#define SATA_PxIS_IFS    (1u << 27)
+#define SATA_PxIS_ERRORS (SATA_PxIS_TFES | SATA_PxIS_HBFS | SATA_PxIS_HBDS | SATA_PxIS_IFS)
+#define SATA_IRQ_POLL_NS 10000000UL     // registers rechecked this often even with interrupts
+
+// HBA registers
+#define AHCI_GHC            0x04
+#define AHCI_IS             0x08        // a bit per port with PxIS bits pending
+#define AHCI_PI             0x0C
+#define AHCI_GHC_IE         0x2
+#define AHCI_PORT_BASE      0x100
+#define AHCI_PORT_SIZE      0x80
+#define AHCI_MAX_PORTS      32
+
+// PxIE: register and set device bits FISes, PIO and DMA setup, descriptor
+// processed, the interface non-fatal error and the errors above
+#define SATA_PxIE_DEFAULT   (0x0000000Fu | (1u << 5) | (1u << 26) | SATA_PxIS_ERRORS)
 
 typedef struct {
     uint8_t cl[1024];   // Command List
@@ -109,5 +132,7 @@ int sata_ahci_identify_satapi(volatile uint32_t *port_base, void *buffer);
 // Needs an 8 byte buffer. Buffer will contain uint32_t size_lba (Big Endian) and size_sector (Big Endian)
 int sata_ahci_identify_satapi_properly(volatile uint32_t *port_base, void *buffer);
 void sata_search(uint32_t mmio_base);
+void sata_irq_init(uint8_t bus, uint8_t device, uint8_t func, uint32_t mmio_base);  // before sata_search()
+void sata_print_stats(void);
 void sata_init(void);
 #endif // DRIVERS_SATA_H
\ No newline at end of file
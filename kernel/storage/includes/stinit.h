@@ -53,4 +53,14 @@ extern uint32_t storage_device_count;
 
 void storage_init(void);
 
+// Entries are only ever appended, and the count is published after the entry
+// is complete, so readers need no lock and no grace period
+static inline uint32_t storage_get_count(void) {
+    return __atomic_load_n(&storage_device_count, __ATOMIC_ACQUIRE);
+}
+
+static inline storage_device_t *storage_get_device(uint32_t index) {
+    return index < storage_get_count() ? &storage_devices[index] : NULL;
+}
+
 #endif
@@ -49,10 +49,215 @@
 #include "mm/includes/vmm.h"
 #include "tools/includes/endian.h"
 #include "kernel/time/includes/time.h"
+#include "kernel/time/includes/timer.h"
 #include "includes/stinit.h" 
+#include "kernel/sched/includes/wait.h"
+#include "drivers/pci/includes/pci.h"
+#include "drivers/pci/includes/msi.h"
+#include "drivers/pic/includes/apic/apic_irq.h"
+#include "drivers/pic/includes/apic/ioapic.h"
 
 extern uint32_t pid_rn;
 
+// Only the first AHCI controller with a working interrupt uses it, any
+// others stay polled. Its ports complete independently
+typedef struct {
+    completion_t done;          // completed by the IRQ for every PxIS it clears
+    uint32_t is;                // PxIS bits the IRQ cleared since the command was issued
+    uint64_t irqs;
+    uint64_t errors;
+    uint64_t polled;            // commands found finished without their interrupt
+} sata_port_t;
+
+static volatile uint32_t *sata_hba;
+static bool sata_irq_enabled;
+static sata_port_t sata_ports[AHCI_MAX_PORTS];
+
+static sata_port_t *sata_port_of(volatile uint32_t *port_base) {
+    if (!sata_irq_enabled)
+        return NULL;
+
+    uintptr_t offset = (uintptr_t)port_base - (uintptr_t)sata_hba;
+    if ((uintptr_t)port_base < (uintptr_t)sata_hba || offset < AHCI_PORT_BASE)
+        return NULL;
+    uintptr_t port = (offset - AHCI_PORT_BASE) / AHCI_PORT_SIZE;
+    return port < AHCI_MAX_PORTS ? &sata_ports[port] : NULL;
+}
+
+// before a command is issued, so whatever the IRQ saw of the last one is gone
+static void sata_clear_interrupts(volatile uint32_t *port_base) {
+    port_base[0x10 / 4] = (uint32_t)-1;
+
+    sata_port_t *port = sata_port_of(port_base);
+    if (port != NULL) {
+        __atomic_store_n(&port->is, 0, __ATOMIC_RELEASE);
+        reinit_completion(&port->done);
+    }
+}
+
+// PxIS is acknowledged before the port's bit in IS, as the spec asks, or the
+// port would raise IS again straight away. Errors are reported from here,
+// the waiter only learns that the command failed
+static void sata_irq_service(void) {
+    uint32_t pending = sata_hba[AHCI_IS / 4];
+
+    for (uint32_t bits = pending; bits != 0; bits &= bits - 1) {
+        uint32_t p = __builtin_ctz(bits);
+        volatile uint32_t *port_base = sata_hba + (AHCI_PORT_BASE + p * AHCI_PORT_SIZE) / 4;
+        sata_port_t *port = &sata_ports[p];
+
+        uint32_t status = port_base[0x10 / 4];
+        port_base[0x10 / 4] = status;
+        __atomic_or_fetch(&port->is, status, __ATOMIC_RELEASE);
+        port->irqs++;
+
+        if (status & SATA_PxIS_ERRORS) {
+            port->errors++;
+            SERIAL(Warn, sata_irq_service, "Port %u error PxIS=0x%x PxTFD=0x%x PxSERR=0x%x\n",
+                   p, status, port_base[0x20 / 4], port_base[0x30 / 4]);
+        }
+        complete(&port->done);
+    }
+    sata_hba[AHCI_IS / 4] = pending;
+}
+
+static void sata_msi_handler(void *arg) {
+    (void)arg;
+    sata_irq_service();
+}
+
+static void sata_intx_handler(Registers_t *regs) {
+    (void)regs;
+    sata_irq_service();
+}
+
+// MSI goes straight to a CPU's LAPIC. Without it the interrupt line register
+// is taken as the GSI, which is what firmware without an ACPI _PRT to go by
+// reports; PCI INTx is level triggered and active low, whatever an ISA IRQ
+// of the same number would be. APIC IRQ n is delivered on vector 0x20 + n,
+// below the MSI vectors. Failing both the driver keeps polling
+void sata_irq_init(uint8_t bus, uint8_t device, uint8_t func, uint32_t mmio_base) {
+    // the IRQ serves one HBA's IS, a second would leave the first one's
+    // interrupts unacknowledged
+    if (sata_irq_enabled) {
+        LOG_INFO("AHCI at 0x%x polls for completions, interrupts serve the first controller\n", mmio_base);
+        SERIAL(Info, sata_irq_init, "AHCI at 0x%x polls for completions, interrupts serve the first controller\n", mmio_base);
+        return;
+    }
+
+    sata_hba = (volatile uint32_t *)(uintptr_t)mmio_base;
+    for (uint32_t p = 0; p < AHCI_MAX_PORTS; p++)
+        init_completion(&sata_ports[p].done);
+
+    const char *mode = "MSI";
+    if (pci_msi_enable(bus, device, func, MSI_ANY_CPU, sata_msi_handler, NULL) != 0) {
+        uint8_t line = pci_read(bus, device, func, PCI_INTERRUPT_LINE) & 0xFF;
+        if (line == 0 || line == 0xFF || 0x20 + line >= MSI_VECTOR_FIRST ||
+            irq_route(line, 0x20 + line, 0, IRQ_TRIGGER_LEVEL, IRQ_POLARITY_LOW) != 0) {
+            LOG_WARN("AHCI has no usable interrupt, polling for completions\n");
+            SERIAL(Warn, sata_irq_init, "AHCI has no usable interrupt, polling for completions\n");
+            return;
+        }
+        APIC_IRQ_RegisterHandler(line, sata_intx_handler);
+        mode = "INTx";
+    }
+
+    // every port reports completions and errors, IS is cleared before GHC.IE goes on
+    uint32_t implemented = sata_hba[AHCI_PI / 4];
+    for (uint32_t p = 0; p < AHCI_MAX_PORTS; p++) {
+        if (!(implemented & (1u << p)))
+            continue;
+        volatile uint32_t *port_base = sata_hba + (AHCI_PORT_BASE + p * AHCI_PORT_SIZE) / 4;
+        port_base[0x10 / 4] = (uint32_t)-1;
+        port_base[0x14 / 4] = SATA_PxIE_DEFAULT;
+    }
+    sata_hba[AHCI_IS / 4] = (uint32_t)-1;
+    sata_irq_enabled = true;
+    sata_hba[AHCI_GHC / 4] |= AHCI_GHC_IE;
+
+    LOG_INFO("AHCI completions are interrupt driven (%s)\n", mode);
+    SERIAL(Info, sata_irq_init, "AHCI completions are interrupt driven (%s)\n", mode);
+}
+
+void sata_print_stats(void) {
+    if (!sata_irq_enabled) {
+        printf("ahci: polled\n");
+        return;
+    }
+
+    printf("port  interrupts  errors  polled\n");
+    uint32_t implemented = sata_hba[AHCI_PI / 4];
+    for (uint32_t p = 0; p < AHCI_MAX_PORTS; p++) {
+        if (implemented & (1u << p))
+            printf("%-5u %-11lu %-7lu %lu\n", p, sata_ports[p].irqs, sata_ports[p].errors, sata_ports[p].polled);
+    }
+}
+
+// Without an interrupt, most commands are done within SATA_SPIN_US, which is
+// spun; after that the task sleeps between polls so the CPU is free for
+// something else
+static int8_t sata_poll_command(volatile uint32_t *port_base, uint32_t err_mask, uint64_t timeout_us, uint32_t *isr) {
+    uint64_t start = ktime_ns();
+    uint64_t spin_until = start + (uint64_t)SATA_SPIN_US * 1000;
+    uint64_t deadline = start + timeout_us * 1000;
+
+    for (;;) {
+        if (!(port_base[0x38 / 4] & 1))
+            return 0;
+        uint32_t status = port_base[0x10 / 4];
+        if (status & err_mask) {
+            if (isr)
+                *isr = status;
+            return 1;
+        }
+
+        uint64_t now = ktime_ns();
+        if (now >= deadline)
+            return -1;
+        if (now < spin_until)
+            udelay(SATA_WAIT_TICK_US);
+        else
+            usleep_range(100, 1000);
+    }
+}
+
+// Wait for command slot 0 to retire. The task sleeps on the port's
+// completion until the IRQ has seen something; the registers are rechecked
+// every SATA_IRQ_POLL_NS anyway, so a lost interrupt only costs latency.
+// 0 once PxCI clears, 1 if a PxIS bit in err_mask came up first (the PxIS
+// value goes to *isr), -1 on timeout
+static int8_t sata_wait_command(volatile uint32_t *port_base, uint32_t err_mask, uint64_t timeout_us, uint32_t *isr) {
+    sata_port_t *port = sata_port_of(port_base);
+    if (port == NULL)
+        return sata_poll_command(port_base, err_mask, timeout_us, isr);
+
+    uint64_t deadline = ktime_ns() + timeout_us * 1000;
+    bool woken = true;
+
+    for (;;) {
+        // the IRQ may have cleared PxIS already, what it saw is in port->is
+        uint32_t status = __atomic_load_n(&port->is, __ATOMIC_ACQUIRE) | port_base[0x10 / 4];
+        if (!(port_base[0x38 / 4] & 1)) {
+            if (!woken)
+                port->polled++;
+            return 0;
+        }
+        if (status & err_mask) {
+            if (isr)
+                *isr = status;
+            return 1;
+        }
+
+        uint64_t now = ktime_ns();
+        if (now >= deadline)
+            return -1;
+        uint64_t wait = deadline - now;
+        if (wait > SATA_IRQ_POLL_NS)
+            wait = SATA_IRQ_POLL_NS;
+        woken = wait_for_completion_timeout(&port->done, wait);
+    }
+}
+
 void sata_search(uint32_t mmio_base) {
     uint32_t pi = *(volatile uint32_t *)(mmio_base + 0x0C);
     for (int p = 0; p < 32; p++) {
@@ -200,7 +405,7 @@ int sata_ahci_read_sector(volatile uint32_t *port_base, uint64_t lba, uint16_t s
     fis->countl = sector_count & 0xFF;
     fis->counth = (sector_count >> 8) & 0xFF;
 
-    port_base[0x10 / 4] = (uint32_t)-1; // Clear interrupts
+    sata_clear_interrupts(port_base); // Clear interrupts
 
     // Stop both engines
     port_base[0x18 / 4] &= ~0x11;
@@ -220,34 +425,31 @@ int sata_ahci_read_sector(volatile uint32_t *port_base, uint64_t lba, uint16_t s
 
     // Wait for command completion
     timeout = SATA_WAIT_TIMEOUT + sector_count * SATA_WAIT_TIMEOUT_PER_SECTOR; // Adjust timeout based on sector count. 10,000us + 2**16 * 200us = 10ms + 64,000 * 0.2ms = 10ms + 12.8s = 12.81s max for 65535 sectors
-    bool error_detected = false;
     uint32_t error_status = 0;
+    int8_t status = sata_wait_command(port_base, SATA_PxIS_ERRORS, (uint64_t)timeout * SATA_WAIT_TICK_US, &error_status);
 
-    while ((port_base[0x38 / 4] & 1) && timeout--) {
-        uint32_t isr = port_base[0x10 / 4];
-        if (isr & ((1 << 30) | (1 << 31))) { // TFES or ERR
-            error_detected = true;
-            error_status = isr;
-            break;
+    if (status > 0) {
+        if (error_status & SATA_PxIS_TFES) {
+            LOG_FATAL("READ DMA error: Task File Error (TFES)\n");
+            SERIAL(Info, sata_ahci_read_sector, "READ DMA error: Task File Error (TFES)");
         }
-        udelay(10);
-    }
-
-    if (error_detected) {
-        if (error_status & (1 << 30)) {
-            LOG_FATAL("READ DMA error: Data Transfer Error (TFES)\n");
-            SERIAL(Info, sata_ahci_read_sector, "READ DMA error: Data Transfer Error (TFES)");
+        if (error_status & SATA_PxIS_HBFS) {
+            LOG_FATAL("READ DMA error: Host Bus Fatal Error (HBFS)\n");
+            SERIAL(Info, sata_ahci_read_sector, "READ DMA error: Host Bus Fatal Error (HBFS)");
+        }
+        if (error_status & SATA_PxIS_HBDS) {
+            LOG_FATAL("READ DMA error: Host Bus Data Error (HBDS)\n");
+            SERIAL(Info, sata_ahci_read_sector, "READ DMA error: Host Bus Data Error (HBDS)");
         }
-        if (error_status & (1 << 31)) {             
-            LOG_FATAL("READ DMA error: General Error (ERR)\n");
-            SERIAL(Info, sata_ahci_read_sector, "READ DMA error: General Error (ERR)");
+        if (error_status & SATA_PxIS_IFS) {
+            LOG_FATAL("READ DMA error: Interface Fatal Error (IFS)\n");
+            SERIAL(Info, sata_ahci_read_sector, "READ DMA error: Interface Fatal Error (IFS)");
         }
-        // Print other bits if needed
         free(port_mem);
         return 8;
     }
 
-    if (timeout == 0) {
+    if (status < 0) {
         LOG_FATAL("Timeout waiting for command completion\n");
         SERIAL(Info, sata_ahci_read_sector, "Timeout waiting for command completion");
         free(port_mem);
@@ -297,7 +499,7 @@ int sata_ahci_identify(volatile uint32_t *port_base, void *buffer) {
     fis->command = 0xEC;    // IDENTIFY DEVICE
 
     // Clear interrupts
-    port_base[0x10 / 4] = (uint32_t)-1;
+    sata_clear_interrupts(port_base);
 
     // Start port engine
     port_base[0x18 / 4] |= 0x11;
@@ -309,15 +511,11 @@ int sata_ahci_identify(volatile uint32_t *port_base, void *buffer) {
     phys_invalidate_cache(buffer, 512);
 
     // Wait for completion
-    uint32_t timeout = SATA_WAIT_TIMEOUT;
-    while ((port_base[0x38 / 4] & 1) && timeout--) {
-        if (port_base[0x10 / 4] & (1 << 30)) {
-            LOG_FATAL("SATAPI READ error\n");
-            SERIAL(Info, sata_ahci_identify, "SATAPI READ error during identification");
-            free(port_mem);
-            return 8;
-        }
-        udelay(10);
+    if (sata_wait_command(port_base, SATA_PxIS_ERRORS, (uint64_t)SATA_WAIT_TIMEOUT * SATA_WAIT_TICK_US, NULL) > 0) {
+        LOG_FATAL("SATAPI READ error\n");
+        SERIAL(Info, sata_ahci_identify, "SATAPI READ error during identification");
+        free(port_mem);
+        return 8;
     }
     SERIAL(Info, sata_ahci_identify, "Device identification completed");
     free(port_mem);
@@ -361,7 +559,7 @@ int sata_ahci_identify_satapi(volatile uint32_t *port_base, void *buffer) {
     fis->command = 0xA1;    // IDENTIFY PACKET DEVICE
 
     // Clear interrupts
-    port_base[0x10 / 4] = (uint32_t)-1;
+    sata_clear_interrupts(port_base);
 
     // Start port engine
     port_base[0x18 / 4] |= 0x11;
@@ -374,15 +572,11 @@ int sata_ahci_identify_satapi(volatile uint32_t *port_base, void *buffer) {
 
     // Wait for completion
     
-    uint32_t timeout = SATA_WAIT_TIMEOUT;
-    while ((port_base[0x38 / 4] & 1) && timeout--) {
-        if (port_base[0x10 / 4] & (1 << 30)) {
-            LOG_FATAL("SATAPI READ error\n");
-            SERIAL(Info, sata_ahci_identify_satapi, "SATAPI READ error during identification");
-            free(port_mem);
-            return 8;
-        }
-        udelay(10);
+    if (sata_wait_command(port_base, SATA_PxIS_ERRORS, (uint64_t)SATA_WAIT_TIMEOUT * SATA_WAIT_TICK_US, NULL) > 0) {
+        LOG_FATAL("SATAPI READ error\n");
+        SERIAL(Info, sata_ahci_identify_satapi, "SATAPI READ error during identification");
+        free(port_mem);
+        return 8;
     }
     SERIAL(Info, sata_ahci_identify_satapi, "SATAPI identification completed");
     free(port_mem);
@@ -447,7 +641,7 @@ int sata_ahci_identify_satapi_properly(volatile uint32_t *port_base, void *buffe
     fis->device = 0xA0;
 
     // Clear interrupts
-    port_base[0x10 / 4] = 0xFFFFFFFF;
+    sata_clear_interrupts(port_base);
     port_base[0x30 / 4] = 0xFFFFFFFF;
 
     // Start engines
@@ -458,9 +652,7 @@ int sata_ahci_identify_satapi_properly(volatile uint32_t *port_base, void *buffe
     port_base[0x38 / 4] = 1;
 
     // Wait
-    timeout = SATA_WAIT_TIMEOUT;
-    while ((port_base[0x38 / 4] & 1) && timeout--) udelay(10);
-    if (timeout == 0) goto fail;
+    if (sata_wait_command(port_base, SATA_PxIS_ERRORS, (uint64_t)SATA_WAIT_TIMEOUT * SATA_WAIT_TICK_US, NULL) != 0) goto fail;
 
     read10_capabillity_buffer_t *rbuf = buffer;
     rbuf->sector_size = be32toh(rbuf->sector_size);
@@ -562,7 +754,7 @@ int sata_ahci_read_sector_satapi(volatile uint32_t *port_base, uint32_t lba, uin
     fis->counth = 0;
 
     // Clear status registers
-    port_base[0x10 / 4] = 0xFFFFFFFF; // PxIS
+    sata_clear_interrupts(port_base); // PxIS
     port_base[0x30 / 4] = 0xFFFFFFFF; // PxSERR
 
     // Start FIS receive engine
@@ -574,21 +766,16 @@ int sata_ahci_read_sector_satapi(volatile uint32_t *port_base, uint32_t lba, uin
 
     // Wait for completion
     timeout = SATA_WAIT_TIMEOUT + sector_count * SATA_WAIT_TIMEOUT_PER_SECTOR;
-    while ((port_base[0x38 / 4] & 1) && timeout--) {
-        uint32_t isr = port_base[0x10 / 4];
-        if (isr & ((1 << 30) | (1 << 31))) { // Task file or host bus error
-            LOG_FATAL("AHCI Error at ISR=0x%x\n", isr);
-            SERIAL(Info, sata_ahci_read_sector_satapi, "AHCI Error during read");
-            goto fail;
-        }
-        udelay(10);
+    uint32_t error_status = 0;
+    int8_t status = sata_wait_command(port_base, SATA_PxIS_ERRORS, (uint64_t)timeout * SATA_WAIT_TICK_US, &error_status);
+    if (status > 0) { // Task file or host bus error
+        LOG_FATAL("AHCI Error at ISR=0x%x\n", error_status);
+        SERIAL(Info, sata_ahci_read_sector_satapi, "AHCI Error during read");
+        goto fail;
     }
-
-    if (timeout == 0)
+    if (status < 0)
         goto fail;
 
-    timeout = SATA_WAIT_TIMEOUT;
-    while (port_base[0x38 / 4] & 1 && timeout--) udelay(10); // wait slot clear
     SERIAL(Info, sata_ahci_read_sector_satapi, "SATAPI sector read completed");
     free(port_mem);
         return 0;
@@ -57,10 +57,10 @@ static void register_device(storage_device_t dev) {
         
         return;
     }
-    storage_devices[storage_device_count++] = dev;
+    storage_devices[storage_device_count] = dev;
+    __atomic_store_n(&storage_device_count, storage_device_count + 1, __ATOMIC_RELEASE);
     sata_init();
-    LOG_INFO("");
-    printf("Registered device type '%c', sector_size=%u\n", dev.type_identifier, (uint32_t)dev.sector_size);
+    LOG_INFO("Registered device type '%c', sector_size=%u\n", dev.type_identifier, (uint32_t)dev.sector_size);
 
     SERIAL(Info, register_device, "Registered device type '%c', sector_size=%u\n", dev.type_identifier, (uint32_t)dev.sector_size);
 
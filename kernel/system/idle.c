@@ -0,0 +1,270 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: idle.c
+    Description: CPU idle module of the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/idle.h"
+#include "arch/x86_64/includes/io.h"
+#include "drivers/pic/includes/apic/apic.h"
+#include "kernel/time/includes/time.h"
+#include "kernel/time/includes/timer.h"
+#include "includes/percpu.h"
+#include "includes/rcu.h"
+#include "kernel/sched/includes/sched.h"
+#include "tools/includes/log-info.h"
+#include <stdio.h>
+#include <string.h>
+
+#define CPUID1_ECX_MONITOR  (1u << 3)
+#define CPUID5_ECX_EMX      (1u << 0)   // sub-states are enumerated in EDX
+#define CPUID6_EAX_ARAT     (1u << 2)   // the LAPIC timer keeps running in deep C-states
+
+// CPUID leaf 5 says which MWAIT C-states exist but not what they cost, these
+// are the usual figures for recent Intel parts (ACPI _CST would have the real
+// ones). Exit latency and target residency, indexed by MWAIT C-state
+static const uint32_t idle_mwait_cost[8][2] = {
+    { 0, 0 },
+    { 2000, 2000 },
+    { 70000, 100000 },
+    { 85000, 200000 },
+    { 124000, 800000 },
+    { 200000, 800000 },
+    { 480000, 5000000 },
+    { 890000, 5000000 },
+};
+
+static idle_state_t idle_states[IDLE_MAX_STATES] = {
+    { "HLT", 0, 1000, 1000 },
+};
+static uint32_t idle_nr_states = 1;
+static bool idle_use_mwait;
+
+static idle_stats_t idle_stats[IDLE_MAX_CPUS];
+
+void idle_init(void) {
+    uint32_t eax, ebx, ecx, edx;
+
+    cpuid(0, 0, &eax, &ebx, &ecx, &edx);
+    uint32_t max_leaf = eax;
+    cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+    if (max_leaf < 5 || !(ecx & CPUID1_ECX_MONITOR)) {
+        LOG_INFO("No MONITOR/MWAIT, idling with HLT\n");
+        SERIAL(Info, idle_init, "No MONITOR/MWAIT, idling with HLT\n");
+        return;
+    }
+
+    bool arat = false;
+    if (max_leaf >= 6) {
+        cpuid(6, 0, &eax, &ebx, &ecx, &edx);
+        arat = eax & CPUID6_EAX_ARAT;
+    }
+    cpuid(5, 0, &eax, &ebx, &ecx, &edx);
+
+    // C1 is always there. Anything deeper needs the sub-state enumeration,
+    // and an ARAT LAPIC timer, or the wakeup for the next timer never comes
+    idle_nr_states = 0;
+    for (uint32_t c = 1; c < 8 && idle_nr_states < IDLE_MAX_STATES; c++) {
+        uint32_t substates = (edx >> (c * 4)) & 0xF;
+        if (c > 1 && (substates == 0 || !(ecx & CPUID5_ECX_EMX) || !arat))
+            continue;
+
+        idle_state_t *state = &idle_states[idle_nr_states++];
+        snprintf(state->name, sizeof(state->name), "C%u", c);
+        state->hint = (c - 1) << 4;
+        state->exit_latency_ns = idle_mwait_cost[c][0];
+        state->target_residency_ns = idle_mwait_cost[c][1];
+    }
+    idle_use_mwait = true;
+
+    LOG_INFO("MWAIT idle with %u C-state(s), deepest %s%s\n", idle_nr_states,
+             idle_states[idle_nr_states - 1].name, arat ? "" : " (LAPIC timer stops deeper)");
+    SERIAL(Info, idle_init, "MWAIT idle with %u C-state(s), deepest %s%s\n", idle_nr_states,
+           idle_states[idle_nr_states - 1].name, arat ? "" : " (LAPIC timer stops deeper)");
+}
+
+// mean of the recent idle periods less the longest, UINT64_MAX until there
+// is enough history to go on
+static uint64_t idle_typical_ns(idle_stats_t *stats) {
+    if (stats->history_len < IDLE_HISTORY)
+        return UINT64_MAX;
+
+    uint64_t sum = 0, longest = 0;
+    for (uint32_t i = 0; i < IDLE_HISTORY; i++) {
+        sum += stats->history[i];
+        if (stats->history[i] > longest)
+            longest = stats->history[i];
+    }
+    return (sum - longest) / (IDLE_HISTORY - 1);
+}
+
+static uint32_t idle_select(idle_stats_t *stats, uint64_t now) {
+    if (idle_nr_states == 1)
+        return 0;
+
+    uint64_t next = timer_next_event_ns();
+    uint64_t predicted = next > now ? next - now : 0;
+    uint64_t typical = idle_typical_ns(stats);
+    if (typical < predicted)
+        predicted = typical;
+
+    uint32_t state = 0;
+    for (uint32_t i = 1; i < idle_nr_states; i++) {
+        if (idle_states[i].target_residency_ns <= predicted)
+            state = i;
+    }
+    return state;
+}
+
+// The idle task tells sched_kick() it is polling, which then skips the IPI.
+// Either the kick's store lands after MONITOR and ends the MWAIT, or before
+// it and need_resched is seen here; the fences on both sides keep one of the
+// two from reading stale. sti only takes effect after the next instruction,
+// so an interrupt arriving before the MWAIT still ends it
+static void idle_mwait(cpu_t *cpu, uint32_t hint) {
+    bool polling = cpu->current != NULL && cpu->current == cpu->idle;
+
+    if (polling) {
+        cpu->idle_polling = true;
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+    __asm__ volatile("monitor" : : "a"(&cpu->need_resched), "c"(0), "d"(0));
+    if (!cpu->need_resched)
+        __asm__ volatile("sti; mwait; cli" : : "a"(hint), "c"(0) : "memory");
+    if (polling)
+        cpu->idle_polling = false;
+}
+
+void cpu_idle(void) {
+    // a task polling for something lets the ones queued behind it run first
+    if (sched_should_yield()) {
+        sched_yield();
+        return;
+    }
+
+    uint64_t flags = irq_save();
+
+    // nothing would ever wake us
+    if (!(flags & (1 << 9))) {
+        __asm__ volatile("pause");
+        return;
+    }
+
+    cpu_idle_irqoff();
+    irq_restore(flags);
+}
+
+void cpu_idle_irqoff(void) {
+    cpu_t *cpu = this_cpu();
+    idle_stats_t *stats = &idle_stats[cpu->id];
+    uint64_t start = ktime_ns();
+    uint32_t state = idle_select(stats, start);
+
+    // reporting the quiescent state may have woken the rcu task here
+    bool quiescent = rcu_idle_enter();
+    if (idle_use_mwait)
+        idle_mwait(cpu, idle_states[state].hint);
+    else if (!cpu->need_resched)
+        __asm__ volatile("sti; hlt; cli" : : : "memory");
+    if (quiescent)
+        rcu_idle_exit();
+
+    uint64_t slept = ktime_ns() - start;
+    stats->entries++;
+    stats->idle_ns += slept;
+    stats->states[state].usage++;
+    stats->states[state].time_ns += slept;
+    if (slept < idle_states[state].target_residency_ns)
+        stats->states[state].below++;
+    stats->history[stats->history_pos] = slept;
+    stats->history_pos = (stats->history_pos + 1) % IDLE_HISTORY;
+    if (stats->history_len < IDLE_HISTORY)
+        stats->history_len++;
+}
+
+void idle_reset_stats(void) {
+    idle_stats_t *stats = &idle_stats[smp_cpu_id()];
+
+    stats->entries = 0;
+    stats->idle_ns = 0;
+    memset(stats->states, 0, sizeof(stats->states));
+    stats->since_ns = ktime_ns();
+}
+
+// wakeups/s and residency are the figures to watch for idle power, every
+// wakeup takes the package out of its deepest sleep state
+void idle_print_stats(void) {
+    uint64_t now = ktime_ns();
+
+    printf("cpu  wakeups/s  idle%%  timer latency avg/max(ns)\n");
+    for (uint32_t id = 0; id < IDLE_MAX_CPUS; id++) {
+        idle_stats_t *stats = &idle_stats[id];
+        if (stats->entries == 0)
+            continue;
+
+        uint64_t span = now - stats->since_ns;
+        if (span == 0)
+            span = 1;
+        timer_nohz_stats_t *nohz = timer_nohz_stats(id);
+        uint64_t fired = nohz->interrupts ? nohz->interrupts : 1;
+
+        printf("%3u  %9lu  %4lu%%  %lu/%lu\n", id, stats->entries * 1000000000 / span,
+               stats->idle_ns * 100 / span, nohz->latency_sum_ns / fired, nohz->latency_max_ns);
+    }
+
+    printf("%s states:", idle_use_mwait ? "MWAIT" : "HLT");
+    for (uint32_t i = 0; i < idle_nr_states; i++)
+        printf(" %s (hint 0x%x, exit %u us, residency %u us)", idle_states[i].name, idle_states[i].hint,
+               idle_states[i].exit_latency_ns / 1000, idle_states[i].target_residency_ns / 1000);
+    printf("\n");
+
+    printf("cpu  state      usage  residency%%  too deep\n");
+    for (uint32_t id = 0; id < IDLE_MAX_CPUS; id++) {
+        idle_stats_t *stats = &idle_stats[id];
+        if (stats->entries == 0)
+            continue;
+
+        uint64_t span = now - stats->since_ns;
+        if (span == 0)
+            span = 1;
+        for (uint32_t i = 0; i < idle_nr_states; i++) {
+            idle_state_stats_t *st = &stats->states[i];
+            if (st->usage == 0)
+                continue;
+            printf("%3u  %-5s  %9lu  %9lu%%  %8lu\n", id, idle_states[i].name, st->usage,
+                   st->time_ns * 100 / span, st->below);
+        }
+    }
+}
@@ -39,8 +39,16 @@ global syscall_handler
 extern handle_syscall
 
 section .text
+; rax = number, rdi/rsi/rdx/r10/r8 = arguments, as on Linux. The user stack is
+; swapped for the calling task's kernel stack, which the scheduler puts in
+; cpu_t (see percpu.h) at every switch, so a handler that sleeps and lets
+; another task's syscall run on this CPU loses nothing
 syscall_handler:
     swapgs
+    mov [gs:16], rsp            ; cpu_t.user_stack
+    mov rsp, [gs:8]             ; cpu_t.kernel_stack
+    push qword [gs:16]
+
     push rcx        ; user RIP
     push r11        ; user RFLAGS
 
@@ -51,6 +59,14 @@ syscall_handler:
     push r14
     push r15
 
+    ; handle_syscall(num, a1, a2, a3, a4, a5)
+    mov r9, r8
+    mov r8, r10
+    mov rcx, rdx
+    mov rdx, rsi
+    mov rsi, rdi
+    mov rdi, rax
+
     sub rsp, 8
     call handle_syscall
     add rsp, 8
@@ -63,5 +79,6 @@ syscall_handler:
     pop rbx
     pop r11
     pop rcx
+    pop rsp
     swapgs
     sysretq
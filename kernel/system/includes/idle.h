@@ -0,0 +1,100 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: idle.h
+    Description: CPU idle module of the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef IDLE_H
+#define IDLE_H
+
+#include <stdint.h>
+
+#define IDLE_MAX_CPUS 64
+#define IDLE_MAX_STATES 8
+#define IDLE_HISTORY 8      // idle periods the governor averages over
+
+/*
+ * An idle CPU sleeps in MONITOR/MWAIT where the CPU has it, armed on the
+ * cache line holding its need_resched flag, so a CPU handing it work wakes it
+ * with that store instead of an IPI. The sleep state is picked per idle
+ * period: the deepest one whose target residency fits the predicted idle
+ * time, which is the shorter of the time to the next timer event and the
+ * recent idle periods on this CPU (less the longest, an outlier). Without
+ * MWAIT there is only HLT.
+ */
+
+typedef struct {
+    char name[8];
+    uint32_t hint;                  // MWAIT EAX, C-state and sub-state
+    uint32_t exit_latency_ns;
+    uint32_t target_residency_ns;   // shortest sleep that pays for entering it
+} idle_state_t;
+
+typedef struct {
+    uint64_t usage;
+    uint64_t time_ns;
+    uint64_t below;                 // woke before the target residency, too deep
+} idle_state_stats_t;
+
+typedef struct {
+    uint64_t entries;       // times the CPU went idle, each ends in a wakeup
+    uint64_t idle_ns;       // time spent halted
+    uint64_t since_ns;      // when counting started
+    idle_state_stats_t states[IDLE_MAX_STATES];
+
+    uint64_t history[IDLE_HISTORY];
+    uint32_t history_len;
+    uint32_t history_pos;
+} idle_stats_t;
+
+// finds the MWAIT states from CPUID leaf 5, BSP, the APs share the result
+void idle_init(void);
+
+// Sleep until the next interrupt. The timer subsystem keeps the event device
+// set for the next pending timer only, so with nothing pending this sleeps
+// until a device interrupt (or, for the idle task, a need_resched store).
+// Returns straight away with interrupts disabled. A task with others waiting
+// on its CPU yields to them instead of halting
+void cpu_idle(void);
+
+// The same, called with interrupts off that may be turned on: they come on
+// only for the halt itself, so an interrupt after the caller last checked
+// its condition ends the halt instead of being missed. Returns with them off
+void cpu_idle_irqoff(void);
+
+void idle_reset_stats(void);
+void idle_print_stats(void);
+
+#endif // IDLE_H
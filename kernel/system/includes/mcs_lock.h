@@ -0,0 +1,154 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: mcs_lock.h
+    Description: MCS queued spinlocks for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef MCS_LOCK_H
+#define MCS_LOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "spinlock.h"
+
+/*
+ * MCS lock: waiters queue up behind the tail, and each one spins on a flag in
+ * its own node until the one ahead hands over by setting it. A handover
+ * touches only the next waiter's line, so the cost does not grow with the
+ * number of CPUs waiting, which it does for the ticket lock. Like the ticket
+ * lock it is FIFO. The price is one atomic exchange more on release when
+ * there is no waiter, and a node the caller keeps (usually on its stack)
+ * from lock to unlock:
+ *
+ *     mcs_node_t node;
+ *     mcs_lock(&lock, &node);
+ *     ...
+ *     mcs_unlock(&lock, &node);
+ */
+
+typedef struct mcs_node {
+    struct mcs_node *volatile next;
+    volatile uint32_t locked;           // set by the previous holder on handover
+} mcs_node_t;
+
+typedef struct {
+    mcs_node_t *volatile tail;          // last in line, NULL when free
+    LOCK_STATS_FIELD
+} mcs_lock_t;
+
+#define MCS_LOCK_INIT { .tail = NULL }
+
+static inline void mcs_lock_init(mcs_lock_t *lock) {
+    *lock = (mcs_lock_t)MCS_LOCK_INIT;
+}
+
+static inline bool mcs_is_locked(mcs_lock_t *lock) {
+    return __atomic_load_n(&lock->tail, __ATOMIC_RELAXED) != NULL;
+}
+
+static inline void arch_mcs_lock(mcs_lock_t *lock, mcs_node_t *node) {
+    node->next = NULL;
+    node->locked = 0;
+
+    mcs_node_t *prev = __atomic_exchange_n(&lock->tail, node, __ATOMIC_ACQ_REL);
+    uint64_t wait_start = 0;
+    if (prev != NULL) {
+        wait_start = LOCK_STATS_WAIT_START();
+        __atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+        while (!__atomic_load_n(&node->locked, __ATOMIC_ACQUIRE))
+            __asm__ volatile("pause");
+    }
+    LOCK_STATS(lock, wait_start);
+}
+
+static inline bool arch_mcs_trylock(mcs_lock_t *lock, mcs_node_t *node) {
+    mcs_node_t *expected = NULL;
+
+    node->next = NULL;
+    node->locked = 0;
+    if (!__atomic_compare_exchange_n(&lock->tail, &expected, node, false,
+                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        return false;
+    LOCK_STATS(lock, 0);
+    return true;
+}
+
+// With nobody behind us the tail goes back to NULL. A waiter that already
+// swapped itself in but has not linked itself to our node yet is waited for
+static inline void arch_mcs_unlock(mcs_lock_t *lock, mcs_node_t *node) {
+    mcs_node_t *next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+
+    if (next == NULL) {
+        mcs_node_t *expected = node;
+        if (__atomic_compare_exchange_n(&lock->tail, &expected, NULL, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            return;
+        while ((next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE)) == NULL)
+            __asm__ volatile("pause");
+    }
+    __atomic_store_n(&next->locked, 1, __ATOMIC_RELEASE);
+}
+
+static inline void mcs_lock(mcs_lock_t *lock, mcs_node_t *node) {
+    preempt_disable();
+    arch_mcs_lock(lock, node);
+}
+
+static inline bool mcs_trylock(mcs_lock_t *lock, mcs_node_t *node) {
+    preempt_disable();
+    if (arch_mcs_trylock(lock, node))
+        return true;
+    preempt_enable_no_resched();
+    return false;
+}
+
+static inline void mcs_unlock(mcs_lock_t *lock, mcs_node_t *node) {
+    arch_mcs_unlock(lock, node);
+    preempt_enable_no_resched();
+}
+
+static inline uint64_t mcs_lock_irqsave(mcs_lock_t *lock, mcs_node_t *node) {
+    uint64_t flags = irq_save();
+    mcs_lock(lock, node);
+    return flags;
+}
+
+static inline void mcs_unlock_irqrestore(mcs_lock_t *lock, mcs_node_t *node, uint64_t flags) {
+    mcs_unlock(lock, node);
+    irq_restore(flags);
+}
+
+#endif // MCS_LOCK_H
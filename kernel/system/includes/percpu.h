@@ -0,0 +1,123 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: percpu.h
+    Description: Per-CPU data for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef PERCPU_H
+#define PERCPU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "arch/x86_64/includes/gdt.h"
+
+/*
+ * Every CPU has a cpu_t, and IA32_GS_BASE points at it while the CPU runs
+ * kernel code (user code gets its own GS base, swapgs trades the two on
+ * syscall entry). this_cpu() and smp_cpu_id() are a single %gs load.
+ *
+ * CPU ids are dense, the BSP is 0 and APs follow in the order Limine lists
+ * them, so they index per-CPU arrays directly. Anything else per-CPU is an
+ * array declared with DEFINE_PER_CPU.
+ */
+
+#define SMP_MAX_CPUS 64
+
+#define MSR_IA32_GS_BASE        0xC0000101
+#define MSR_IA32_KERNEL_GS_BASE 0xC0000102
+
+#define CPU_KERNEL_STACK_SIZE   0x4000
+
+typedef struct cpu {
+    struct cpu *self;           // %gs:0, turns the GS base back into a pointer
+    uint64_t kernel_stack;      // %gs:8, syscall stack of the running task, also in TSS.RSP0
+    uint64_t user_stack;        // %gs:16, scratch for the syscall entry
+    uint32_t id;                // %gs:24
+    uint32_t lapic_id;
+    void *current;              // running task, NULL until there is a scheduler
+    void *idle;                 // task that runs when the run queue is empty
+    uint32_t preempt_count;     // > 0 while the current task must not be switched out
+    volatile bool need_resched; // switch at the next preemption point
+    volatile bool idle_polling; // in MWAIT on need_resched's line, storing to it is the wakeup
+
+    volatile bool started;      // AP reached C code
+    volatile bool online;       // AP finished bring-up and is idling
+
+    uint64_t irqs;              // interrupts taken through the APIC
+    uint64_t syscalls;
+    uint64_t boot_kernel_stack; // kernel_stack while a task without its own stack runs
+
+    GDT_CPU_t gdt;
+} cpu_t;
+
+// the syscall entry in syscalls-asm.s hard codes these
+_Static_assert(offsetof(cpu_t, kernel_stack) == 8, "syscall entry uses %gs:8");
+_Static_assert(offsetof(cpu_t, user_stack) == 16, "syscall entry uses %gs:16");
+_Static_assert(offsetof(cpu_t, id) == 24, "smp_cpu_id uses %gs:24");
+_Static_assert(offsetof(cpu_t, current) == 32, "current_task uses %gs:32");
+_Static_assert(offsetof(cpu_t, preempt_count) == 48, "preempt_disable uses %gs:48");
+
+#define DEFINE_PER_CPU(type, name)  __typeof__(type) name[SMP_MAX_CPUS]
+#define DECLARE_PER_CPU(type, name) extern __typeof__(type) name[SMP_MAX_CPUS]
+#define per_cpu(name, cpu)          (name[(cpu)])
+#define this_cpu_ptr(name)          (&name[smp_cpu_id()])
+
+static inline cpu_t *this_cpu(void) {
+    cpu_t *cpu;
+    __asm__ volatile("movq %%gs:0, %0" : "=r"(cpu));
+    return cpu;
+}
+
+static inline uint32_t smp_cpu_id(void) {
+    uint32_t id;
+    __asm__ volatile("movl %%gs:24, %0" : "=r"(id));
+    return id;
+}
+
+// A single instruction each, a task preempted between loading this_cpu() and
+// the increment could be moved and bump another CPU's count
+static inline void preempt_disable(void) {
+    __asm__ volatile("incl %%gs:48" ::: "memory");
+}
+
+static inline void preempt_enable_no_resched(void) {
+    __asm__ volatile("decl %%gs:48" ::: "memory");
+}
+
+// GDT/TSS, kernel stack and GS base for the calling CPU
+void percpu_setup(cpu_t *cpu, uint32_t id, uint32_t lapic_id);
+
+#endif // PERCPU_H
@@ -0,0 +1,184 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: rcu.h
+    Description: Read-copy-update for the read-mostly tables of the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef RCU_H
+#define RCU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "percpu.h"
+
+/*
+ * Read-copy-update, for tables that are read on every interrupt or I/O and
+ * changed a handful of times per boot. A reader brackets its lookup with
+ * rcu_read_lock()/rcu_read_unlock(), which only disable preemption, and
+ * loads the shared pointer with rcu_dereference(). A writer publishes a new
+ * version with rcu_assign_pointer() and may free the old one once a grace
+ * period has passed, either by waiting in synchronize_rcu() or by handing
+ * it to call_rcu(). Writers still serialise among themselves with a lock of
+ * their own.
+ *
+ * A grace period ends when every CPU has passed a quiescent state, a point
+ * where it cannot be inside a read-side section: a context switch, an
+ * interrupt taken with preemption enabled, or idle. An idle CPU counts as
+ * quiescent for as long as it stays idle, so grace periods do not wake it;
+ * interrupt handlers are readers too, rcu_irq_enter() marks it busy while
+ * one runs. The "rcu" task drives grace periods and runs the callbacks, a
+ * CPU that takes too long to pass one gets an IPI.
+ *
+ * Interrupt handlers and code that runs with interrupts off are read-side
+ * sections already and need no rcu_read_lock().
+ */
+
+typedef struct rcu_head {
+    struct rcu_head *next;
+    uint64_t gp;                        // grace period that has to end first
+    void (*fn)(struct rcu_head *head);
+} rcu_head_t;
+
+typedef void (*rcu_callback_t)(rcu_head_t *head);
+
+// the preemption count is all a reader costs, a pending reschedule is
+// picked up at the next preemption point, as with spin_unlock()
+static inline void rcu_read_lock(void) {
+    preempt_disable();
+}
+
+static inline void rcu_read_unlock(void) {
+    preempt_enable_no_resched();
+}
+
+// x86 orders loads with loads and stores with stores, so both are plain
+// moves that the compiler may not reorder around
+#define rcu_dereference(p)          __atomic_load_n(&(p), __ATOMIC_ACQUIRE)
+#define rcu_assign_pointer(p, v)    __atomic_store_n(&(p), (v), __ATOMIC_RELEASE)
+
+void rcu_init(void);                // after sched_init(), starts the rcu task
+void call_rcu(rcu_head_t *head, rcu_callback_t fn);     // fn runs in the rcu task
+void synchronize_rcu(void);         // sleeps, not from callbacks or read-side sections
+
+// quiescent states, for the scheduler, the idle loop and the interrupt entry
+void rcu_note_qs(void);
+bool rcu_idle_enter(void);          // false if this is no quiescent state
+void rcu_idle_exit(void);
+bool rcu_irq_enter(void);           // true if the CPU was idle, pass it back
+void rcu_irq_exit(bool from_idle);
+
+void rcu_print_stats(void);
+
+/*
+ * Singly headed list that readers walk under rcu_read_lock() while a writer
+ * adds and removes nodes. A removed node keeps its next pointer, so a reader
+ * standing on it carries on into the list; it may be freed or reused only
+ * after a grace period.
+ */
+
+typedef struct rcu_list_node {
+    struct rcu_list_node *next;
+    struct rcu_list_node **pprev;       // the pointer to this node, NULL once removed
+} rcu_list_node_t;
+
+typedef struct {
+    rcu_list_node_t *first;
+} rcu_list_t;
+
+#define RCU_LIST_INIT { .first = NULL }
+
+#define rcu_list_entry(ptr, type, member) \
+    ((type *)((char *)(ptr) - offsetof(type, member)))
+
+static inline bool rcu_list_empty(rcu_list_t *list) {
+    return __atomic_load_n(&list->first, __ATOMIC_RELAXED) == NULL;
+}
+
+static inline bool rcu_list_unhashed(rcu_list_node_t *node) {
+    return node->pprev == NULL;
+}
+
+// the node is filled in before it becomes reachable
+static inline void rcu_list_add_head(rcu_list_t *list, rcu_list_node_t *node) {
+    rcu_list_node_t *first = list->first;
+
+    node->next = first;
+    node->pprev = &list->first;
+    rcu_assign_pointer(list->first, node);
+    if (first != NULL)
+        first->pprev = &node->next;
+}
+
+static inline void rcu_list_add_behind(rcu_list_node_t *prev, rcu_list_node_t *node) {
+    node->next = prev->next;
+    node->pprev = &prev->next;
+    rcu_assign_pointer(prev->next, node);
+    if (node->next != NULL)
+        node->next->pprev = &node->next;
+}
+
+static inline void rcu_list_del(rcu_list_node_t *node) {
+    rcu_list_node_t *next = node->next;
+
+    __atomic_store_n(node->pprev, next, __ATOMIC_RELAXED);
+    if (next != NULL)
+        next->pprev = node->pprev;
+    node->pprev = NULL;
+}
+
+static inline void rcu_list_replace(rcu_list_node_t *old, rcu_list_node_t *node) {
+    node->next = old->next;
+    node->pprev = old->pprev;
+    rcu_assign_pointer(*node->pprev, node);
+    if (node->next != NULL)
+        node->next->pprev = &node->next;
+    old->pprev = NULL;
+}
+
+#define rcu_list_for_each(pos, list) \
+    for ((pos) = rcu_dereference((list)->first); (pos) != NULL; (pos) = rcu_dereference((pos)->next))
+
+#define __rcu_list_entry_or_null(ptr, type, member) ({                      \
+    rcu_list_node_t *__node = (ptr);                                        \
+    __node != NULL ? rcu_list_entry(__node, type, member) : NULL;           \
+})
+
+#define rcu_list_for_each_entry(pos, list, member)                                              \
+    for ((pos) = __rcu_list_entry_or_null(rcu_dereference((list)->first), __typeof__(*(pos)), member); \
+         (pos) != NULL;                                                                         \
+         (pos) = __rcu_list_entry_or_null(rcu_dereference((pos)->member.next), __typeof__(*(pos)), member))
+
+#endif // RCU_H
@@ -0,0 +1,171 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: rwlock.h
+    Description: Reader-writer spinlocks for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef RWLOCK_H
+#define RWLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "spinlock.h"
+
+/*
+ * Reader-writer spinlock in one word: the low bits count readers, the top
+ * bit is the writer holding it and the bit below a writer waiting for it.
+ * A waiting writer keeps new readers out, so a steady stream of readers
+ * cannot starve it; the readers already inside finish first. Release clears
+ * the waiting bit too, a writer still waiting sets it again.
+ *
+ * Worth it only where reads far outnumber writes and read sections are not
+ * tiny, every reader still writes the shared word twice.
+ */
+
+#define RWLOCK_WRITER       0x80000000u
+#define RWLOCK_WRITER_WAIT  0x40000000u
+#define RWLOCK_READERS      0x3FFFFFFFu
+
+typedef struct {
+    volatile uint32_t cnt;
+    LOCK_STATS_FIELD
+} rwlock_t;
+
+#define RWLOCK_INIT { .cnt = 0 }
+
+static inline void rwlock_init(rwlock_t *lock) {
+    *lock = (rwlock_t)RWLOCK_INIT;
+}
+
+static inline bool arch_read_trylock(rwlock_t *lock) {
+    uint32_t cnt = __atomic_load_n(&lock->cnt, __ATOMIC_RELAXED);
+
+    return !(cnt & (RWLOCK_WRITER | RWLOCK_WRITER_WAIT)) &&
+           __atomic_compare_exchange_n(&lock->cnt, &cnt, cnt + 1, false,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+// only writers are counted in the stats, readers would all be writing them
+// at once
+static inline void arch_read_lock(rwlock_t *lock) {
+    while (!arch_read_trylock(lock)) {
+        while (__atomic_load_n(&lock->cnt, __ATOMIC_RELAXED) & (RWLOCK_WRITER | RWLOCK_WRITER_WAIT))
+            __asm__ volatile("pause");
+    }
+}
+
+static inline void arch_read_unlock(rwlock_t *lock) {
+    __atomic_fetch_sub(&lock->cnt, 1, __ATOMIC_RELEASE);
+}
+
+static inline bool arch_write_trylock(rwlock_t *lock) {
+    uint32_t cnt = __atomic_load_n(&lock->cnt, __ATOMIC_RELAXED);
+
+    if ((cnt & ~RWLOCK_WRITER_WAIT) != 0)
+        return false;
+    if (!__atomic_compare_exchange_n(&lock->cnt, &cnt, RWLOCK_WRITER, false,
+                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        return false;
+    LOCK_STATS(lock, 0);
+    return true;
+}
+
+static inline void arch_write_lock(rwlock_t *lock) {
+    uint64_t wait_start = 0;
+
+    for (;;) {
+        uint32_t cnt = __atomic_load_n(&lock->cnt, __ATOMIC_RELAXED);
+        if ((cnt & ~RWLOCK_WRITER_WAIT) == 0) {
+            if (__atomic_compare_exchange_n(&lock->cnt, &cnt, RWLOCK_WRITER, false,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+                break;
+            continue;
+        }
+        if (wait_start == 0)
+            wait_start = LOCK_STATS_WAIT_START();
+        if (!(cnt & RWLOCK_WRITER_WAIT))
+            __atomic_fetch_or(&lock->cnt, RWLOCK_WRITER_WAIT, __ATOMIC_RELAXED);
+        __asm__ volatile("pause");
+    }
+    LOCK_STATS(lock, wait_start);
+}
+
+static inline void arch_write_unlock(rwlock_t *lock) {
+    __atomic_store_n(&lock->cnt, 0, __ATOMIC_RELEASE);
+}
+
+static inline void read_lock(rwlock_t *lock) {
+    preempt_disable();
+    arch_read_lock(lock);
+}
+
+static inline void read_unlock(rwlock_t *lock) {
+    arch_read_unlock(lock);
+    preempt_enable_no_resched();
+}
+
+static inline void write_lock(rwlock_t *lock) {
+    preempt_disable();
+    arch_write_lock(lock);
+}
+
+static inline void write_unlock(rwlock_t *lock) {
+    arch_write_unlock(lock);
+    preempt_enable_no_resched();
+}
+
+static inline uint64_t read_lock_irqsave(rwlock_t *lock) {
+    uint64_t flags = irq_save();
+    read_lock(lock);
+    return flags;
+}
+
+static inline void read_unlock_irqrestore(rwlock_t *lock, uint64_t flags) {
+    read_unlock(lock);
+    irq_restore(flags);
+}
+
+static inline uint64_t write_lock_irqsave(rwlock_t *lock) {
+    uint64_t flags = irq_save();
+    write_lock(lock);
+    return flags;
+}
+
+static inline void write_unlock_irqrestore(rwlock_t *lock, uint64_t flags) {
+    write_unlock(lock);
+    irq_restore(flags);
+}
+
+#endif // RWLOCK_H
@@ -0,0 +1,118 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: seqlock.h
+    Description: Sequence counters and seqlocks for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "spinlock.h"
+
+/*
+ * Sequence counter. The writer makes the count odd, updates the data and
+ * makes it even again; a reader copies the data out between two reads of
+ * the count and tries again if it was odd or changed. Readers never write
+ * the shared line, which suits data read on every clock read and updated
+ * a few times a second.
+ *
+ * A seqcount needs its writers serialised by something else, a seqlock_t
+ * pairs it with a spinlock for that. Readers must not be able to interrupt
+ * a writer on the same CPU, or they spin forever on the odd count, so data
+ * also read from interrupt handlers is written with interrupts off.
+ */
+
+typedef struct {
+    volatile uint32_t sequence;
+} seqcount_t;
+
+#define SEQCOUNT_INIT { .sequence = 0 }
+
+static inline uint32_t read_seqcount_begin(const seqcount_t *s) {
+    uint32_t seq;
+
+    while ((seq = __atomic_load_n(&s->sequence, __ATOMIC_ACQUIRE)) & 1)
+        __asm__ volatile("pause");
+    return seq;
+}
+
+// true if what was read since read_seqcount_begin() may be torn
+static inline bool read_seqcount_retry(const seqcount_t *s, uint32_t seq) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&s->sequence, __ATOMIC_RELAXED) != seq;
+}
+
+static inline void write_seqcount_begin(seqcount_t *s) {
+    __atomic_store_n(&s->sequence, s->sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void write_seqcount_end(seqcount_t *s) {
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&s->sequence, s->sequence + 1, __ATOMIC_RELAXED);
+}
+
+typedef struct {
+    seqcount_t seq;
+    spinlock_t lock;
+} seqlock_t;
+
+#define SEQLOCK_INIT { .seq = SEQCOUNT_INIT, .lock = SPINLOCK_INIT }
+
+static inline uint32_t read_seqbegin(const seqlock_t *sl) {
+    return read_seqcount_begin(&sl->seq);
+}
+
+static inline bool read_seqretry(const seqlock_t *sl, uint32_t seq) {
+    return read_seqcount_retry(&sl->seq, seq);
+}
+
+// the arch_ spinlock level, callable before this CPU's cpu_t is set up
+static inline uint64_t write_seqlock_irqsave(seqlock_t *sl) {
+    uint64_t flags = irq_save();
+    arch_spin_lock(&sl->lock);
+    write_seqcount_begin(&sl->seq);
+    return flags;
+}
+
+static inline void write_sequnlock_irqrestore(seqlock_t *sl, uint64_t flags) {
+    write_seqcount_end(&sl->seq);
+    arch_spin_unlock(&sl->lock);
+    irq_restore(flags);
+}
+
+#endif // SEQLOCK_H
@@ -0,0 +1,187 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: spinlock.h
+    Description: Spinlocks for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef SPINLOCK_H
+#define SPINLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "arch/x86_64/includes/io.h"
+#include "percpu.h"
+
+/*
+ * Ticket lock. Taking it draws the next ticket and waits for the owner field
+ * to reach it, so waiters get the lock in the order they came and none
+ * starves. A waiter further back in line polls less often, every poll is a
+ * read of the line the holder is about to write.
+ *
+ * Holding one disables preemption, so a task is never switched out with a
+ * lock other CPUs are spinning on. Locks also taken from interrupt handlers
+ * need the irqsave variants. The arch_ functions are the bare lock, for code
+ * that runs before this CPU's cpu_t is set up or that already runs with
+ * interrupts off.
+ *
+ * All waiters spin on the one word, which bounces between their caches on
+ * every handover. A lock contended by many CPUs at once wants an MCS lock
+ * instead (mcs_lock.h), reader-writer locks are in rwlock.h.
+ *
+ * Built with -DSPINLOCK_STATS every lock also counts its acquisitions, how
+ * many of them had to wait, and the TSC cycles spent waiting.
+ */
+
+typedef struct {
+    uint64_t acquired;
+    uint64_t contended;
+    uint64_t wait_cycles;
+} lock_stats_t;
+
+#ifdef SPINLOCK_STATS
+#define LOCK_STATS_FIELD    lock_stats_t stats;
+// called with the lock held, which is what keeps the counters consistent
+static inline void lock_stats_record(lock_stats_t *stats, uint64_t wait_start) {
+    stats->acquired++;
+    if (wait_start != 0) {
+        stats->contended++;
+        stats->wait_cycles += __builtin_ia32_rdtsc() - wait_start;
+    }
+}
+#define LOCK_STATS_WAIT_START() __builtin_ia32_rdtsc()
+#define LOCK_STATS(lock, wait_start) lock_stats_record(&(lock)->stats, wait_start)
+#else
+#define LOCK_STATS_FIELD
+#define LOCK_STATS_WAIT_START() 0
+#define LOCK_STATS(lock, wait_start) ((void)(wait_start))
+#endif
+
+typedef struct {
+    union {
+        volatile uint32_t val;
+        struct {
+            volatile uint16_t owner;    // ticket being served
+            volatile uint16_t next;     // next ticket to hand out
+        };
+    };
+    LOCK_STATS_FIELD
+} spinlock_t;
+
+#define SPINLOCK_INIT { .val = 0 }
+
+static inline void spin_lock_init(spinlock_t *lock) {
+    *lock = (spinlock_t)SPINLOCK_INIT;
+}
+
+static inline bool spin_is_locked(spinlock_t *lock) {
+    uint32_t val = __atomic_load_n(&lock->val, __ATOMIC_RELAXED);
+    return (uint16_t)val != (uint16_t)(val >> 16);
+}
+
+static inline void arch_spin_lock(spinlock_t *lock) {
+    uint16_t ticket = __atomic_fetch_add(&lock->next, 1, __ATOMIC_ACQUIRE);
+    uint16_t owner = __atomic_load_n(&lock->owner, __ATOMIC_ACQUIRE);
+    uint64_t wait_start = 0;
+
+    if (owner != ticket) {
+        wait_start = LOCK_STATS_WAIT_START();
+        do {
+            for (uint16_t i = (uint16_t)(ticket - owner); i != 0; i--)
+                __asm__ volatile("pause");
+            owner = __atomic_load_n(&lock->owner, __ATOMIC_ACQUIRE);
+        } while (owner != ticket);
+    }
+    LOCK_STATS(lock, wait_start);
+}
+
+// only when nobody holds or waits for it: owner == next, and we take a ticket
+static inline bool arch_spin_trylock(spinlock_t *lock) {
+    uint32_t val = __atomic_load_n(&lock->val, __ATOMIC_RELAXED);
+
+    if ((uint16_t)val != (uint16_t)(val >> 16))
+        return false;
+    if (!__atomic_compare_exchange_n(&lock->val, &val, val + 0x10000, false,
+                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        return false;
+    LOCK_STATS(lock, 0);
+    return true;
+}
+
+// only the holder writes owner, a plain increment published with release
+static inline void arch_spin_unlock(spinlock_t *lock) {
+    __atomic_store_n(&lock->owner, (uint16_t)(lock->owner + 1), __ATOMIC_RELEASE);
+}
+
+static inline void spin_lock(spinlock_t *lock) {
+    preempt_disable();
+    arch_spin_lock(lock);
+}
+
+static inline bool spin_trylock(spinlock_t *lock) {
+    preempt_disable();
+    if (arch_spin_trylock(lock))
+        return true;
+    preempt_enable_no_resched();
+    return false;
+}
+
+static inline void spin_unlock(spinlock_t *lock) {
+    arch_spin_unlock(lock);
+    preempt_enable_no_resched();
+}
+
+// for code that knows interrupts are on and leaves them on afterwards
+static inline void spin_lock_irq(spinlock_t *lock) {
+    __asm__ volatile("cli" : : : "memory");
+    spin_lock(lock);
+}
+
+static inline void spin_unlock_irq(spinlock_t *lock) {
+    spin_unlock(lock);
+    __asm__ volatile("sti" : : : "memory");
+}
+
+static inline uint64_t spin_lock_irqsave(spinlock_t *lock) {
+    uint64_t flags = irq_save();
+    spin_lock(lock);
+    return flags;
+}
+
+static inline void spin_unlock_irqrestore(spinlock_t *lock, uint64_t flags) {
+    spin_unlock(lock);
+    irq_restore(flags);
+}
+
+#endif // SPINLOCK_H
@@ -47,9 +47,27 @@
 #define SYS_open   2 // does nothing for now
 #define SYS_close  3 // does nothing for now
 #define SYS_exit   60 // implemented
+#define SYS_gettimeofday  96  // implemented, user/lib reads the vDSO page first
+#define SYS_clock_gettime 228 // implemented, user/lib reads the vDSO page first
 
 #define SYS_MAX    1028
 
+#include <stdint.h>
+
+#define CLOCK_REALTIME  0
+#define CLOCK_MONOTONIC 1
+
+// same layout as the Linux x86_64 structs
+typedef struct {
+    int64_t tv_sec;
+    int64_t tv_nsec;
+} sys_timespec_t;
+
+typedef struct {
+    int64_t tv_sec;
+    int64_t tv_usec;
+} sys_timeval_t;
+
 
 
 #endif
\ No newline at end of file
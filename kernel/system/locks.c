@@ -0,0 +1,227 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: locks.c
+    Description: Shared kernel locks and lock benchmarks for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/locks.h"
+#include "includes/spinlock.h"
+#include "includes/mcs_lock.h"
+#include "includes/rwlock.h"
+#include "includes/smp.h"
+#include "kernel/sched/includes/sched.h"
+#include "kernel/time/includes/time.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define LOCK_BENCH_MS       100
+#define LOCK_BENCH_START_MS 20      // lets every worker get created and settle first
+#define LOCK_BENCH_KINDS    4
+
+static spinlock_t heap_spinlock = SPINLOCK_INIT;
+static spinlock_t pmm_spinlock = SPINLOCK_INIT;
+
+uint64_t heap_lock(void) {
+    uint64_t flags = irq_save();
+    arch_spin_lock(&heap_spinlock);
+    return flags;
+}
+
+void heap_unlock(uint64_t flags) {
+    arch_spin_unlock(&heap_spinlock);
+    irq_restore(flags);
+}
+
+uint64_t pmm_lock(void) {
+    uint64_t flags = irq_save();
+    arch_spin_lock(&pmm_spinlock);
+    return flags;
+}
+
+void pmm_unlock(uint64_t flags) {
+    arch_spin_unlock(&pmm_spinlock);
+    irq_restore(flags);
+}
+
+#ifdef SPINLOCK_STATS
+static void lock_print_one(const char *name, lock_stats_t *stats) {
+    uint64_t contended = stats->contended ? stats->contended : 1;
+    printf("%-6s  %10lu  %10lu  %10lu\n", name, stats->acquired, stats->contended,
+           stats->wait_cycles / contended);
+}
+#endif
+
+void lock_print_stats(void) {
+#ifdef SPINLOCK_STATS
+    printf("lock      acquired   contended  avg wait(cycles)\n");
+    lock_print_one("heap", &heap_spinlock.stats);
+    lock_print_one("pmm", &pmm_spinlock.stats);
+#else
+    printf("Lock statistics need a kernel built with -DSPINLOCK_STATS\n");
+#endif
+}
+
+typedef enum {
+    LOCK_BENCH_TICKET,
+    LOCK_BENCH_MCS,
+    LOCK_BENCH_WRITE,       // rwlock, writers only
+    LOCK_BENCH_READ,        // rwlock, readers only
+} lock_bench_kind_t;
+
+static const char *lock_bench_names[LOCK_BENCH_KINDS] = { "ticket", "mcs", "rw write", "rw read" };
+
+typedef struct {
+    lock_bench_kind_t kind;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    spinlock_t ticket;
+    mcs_lock_t mcs;
+    rwlock_t rw;
+    volatile uint64_t shared[8] __attribute__((aligned(64)));  // what the critical section touches
+} lock_bench_t;
+
+typedef struct {
+    lock_bench_t *b;
+    uint64_t ops;
+} lock_bench_worker_t;
+
+static void lock_bench_worker(void *arg) {
+    lock_bench_worker_t *w = arg;
+    lock_bench_t *b = w->b;
+    uint64_t ops = 0;
+
+    while (ktime_ns() < b->start_ns)
+        __asm__ volatile("pause");
+
+    // the clock is read once per batch, it costs about as much as the lock
+    while (ktime_ns() < b->end_ns) {
+        for (uint32_t i = 0; i < 64; i++) {
+            mcs_node_t node;
+            switch (b->kind) {
+                case LOCK_BENCH_TICKET:
+                    spin_lock(&b->ticket);
+                    b->shared[0]++;
+                    spin_unlock(&b->ticket);
+                    break;
+                case LOCK_BENCH_MCS:
+                    mcs_lock(&b->mcs, &node);
+                    b->shared[0]++;
+                    mcs_unlock(&b->mcs, &node);
+                    break;
+                case LOCK_BENCH_WRITE:
+                    write_lock(&b->rw);
+                    b->shared[0]++;
+                    write_unlock(&b->rw);
+                    break;
+                case LOCK_BENCH_READ:
+                    read_lock(&b->rw);
+                    (void)b->shared[0];
+                    read_unlock(&b->rw);
+                    break;
+            }
+        }
+        ops += 64;
+    }
+    w->ops = ops;
+}
+
+// One worker pinned to each of the first `cpus` CPUs, all hammering the same
+// lock around a one line critical section. Returns the total acquisitions,
+// the fewest and most any worker got go to *lo and *hi
+static uint64_t lock_bench_run(lock_bench_t *b, lock_bench_kind_t kind, uint32_t cpus,
+                               uint64_t *lo, uint64_t *hi) {
+    static lock_bench_worker_t workers[SMP_MAX_CPUS];
+    static task_t *tasks[SMP_MAX_CPUS];
+
+    memset(b, 0, sizeof(*b));
+    b->kind = kind;
+    b->start_ns = ktime_ns() + LOCK_BENCH_START_MS * 1000000UL;
+    b->end_ns = b->start_ns + LOCK_BENCH_MS * 1000000UL;
+
+    uint32_t started = 0;
+    for (; started < cpus; started++) {
+        workers[started].b = b;
+        workers[started].ops = 0;
+        tasks[started] = kthread_create_on("lockbench", lock_bench_worker, &workers[started], started);
+        if (tasks[started] == NULL)
+            break;
+    }
+
+    uint64_t total = 0;
+    *lo = UINT64_MAX;
+    *hi = 0;
+    for (uint32_t i = 0; i < started; i++) {
+        kthread_join(tasks[i]);
+        total += workers[i].ops;
+        *lo = min(*lo, workers[i].ops);
+        *hi = max(*hi, workers[i].ops);
+    }
+    return started == cpus ? total : 0;
+}
+
+// Throughput of each lock with 1, 2, 4, ... CPUs contending, and how evenly
+// the acquisitions were shared. The ticket lock falls off as CPUs are added,
+// every handover invalidates the line in all the waiters' caches
+void lock_bench(void) {
+    if (!sched_active()) {
+        printf("The scheduler is not running\n");
+        return;
+    }
+
+    static lock_bench_t b;
+    uint32_t cpus = smp_cpu_count();
+
+    printf("lock      cpus   Mops/s  ns/op  min/max share\n");
+    for (uint32_t kind = 0; kind < LOCK_BENCH_KINDS; kind++) {
+        for (uint32_t n = 1;; n *= 2) {
+            if (n > cpus)
+                n = cpus;
+
+            uint64_t lo, hi;
+            uint64_t total = lock_bench_run(&b, kind, n, &lo, &hi);
+            if (total == 0) {
+                printf("Could not create the benchmark tasks\n");
+                return;
+            }
+            uint64_t mean = total / n ? total / n : 1;
+            printf("%-8s  %4u  %7lu  %5lu  %lu%%/%lu%%\n", lock_bench_names[kind], n,
+                   total / (LOCK_BENCH_MS * 1000), LOCK_BENCH_MS * 1000000UL / mean,
+                   lo * 100 / mean, hi * 100 / mean);
+            if (n == cpus)
+                break;
+        }
+    }
+}
@@ -0,0 +1,298 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: rcu.c
+    Description: Read-copy-update grace periods and callbacks for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/rcu.h"
+#include "includes/smp.h"
+#include "includes/spinlock.h"
+#include "kernel/sched/includes/sched.h"
+#include "kernel/sched/includes/wait.h"
+#include "kernel/time/includes/time.h"
+#include "drivers/pic/includes/apic/apic.h"
+#include "tools/includes/log-info.h"
+#include <stdio.h>
+
+#define RCU_POLL_NS     1000000UL   // how often idle CPUs are rechecked while a grace period waits
+#define RCU_KICK_NS     2000000UL   // CPUs still holding it up after this get an IPI
+
+_Static_assert(SMP_MAX_CPUS <= 64, "rcu_gp_mask has a bit per CPU");
+
+// dynticks is odd while the CPU runs code that may read, even while it is
+// idle. Only its own CPU changes it; a grace period that finds it even, or
+// changed since the period started, knows the CPU passed a quiescent state
+typedef struct {
+    uint64_t dynticks;
+    uint64_t snap;              // dynticks when the current grace period started
+} __attribute__((aligned(64))) rcu_cpu_t;
+
+typedef struct {
+    uint64_t gps;
+    uint64_t gp_ns_total;
+    uint64_t gp_ns_max;
+    uint64_t kicks;             // IPIs sent to CPUs holding up a grace period
+    uint64_t queued;
+    uint64_t invoked;
+} rcu_stats_t;
+
+static rcu_cpu_t rcu_cpus[SMP_MAX_CPUS] = { [0 ... SMP_MAX_CPUS - 1] = { .dynticks = 1 } };
+
+static uint64_t rcu_gp_mask;    // CPUs the current grace period still waits for
+static uint64_t rcu_started;    // grace periods started
+static uint64_t rcu_completed;  // and ended, the callbacks waiting for it may run
+
+static wait_queue_t rcu_wait = WAIT_QUEUE_INIT;     // the rcu task sleeps here
+static spinlock_t rcu_cb_lock = SPINLOCK_INIT;
+static rcu_head_t *rcu_cb_head;
+static rcu_head_t **rcu_cb_tail = &rcu_cb_head;
+static task_t *rcu_task;
+static rcu_stats_t rcu_stats;
+
+static void rcu_report_qs(uint32_t id) {
+    uint64_t bit = 1UL << id;
+
+    // release: the reads this CPU did before are over before the period ends
+    if ((__atomic_fetch_and(&rcu_gp_mask, ~bit, __ATOMIC_RELEASE) & ~bit) == 0)
+        wake_up(&rcu_wait);
+}
+
+// on every context switch, so one load when there is nothing to report
+void rcu_note_qs(void) {
+    uint32_t id = smp_cpu_id();
+
+    if (__atomic_load_n(&rcu_gp_mask, __ATOMIC_RELAXED) & (1UL << id))
+        rcu_report_qs(id);
+}
+
+bool rcu_idle_enter(void) {
+    cpu_t *cpu = this_cpu();
+
+    if (cpu->preempt_count != 0)
+        return false;
+    __atomic_add_fetch(&rcu_cpus[cpu->id].dynticks, 1, __ATOMIC_SEQ_CST);
+    rcu_note_qs();
+    return true;
+}
+
+void rcu_idle_exit(void) {
+    __atomic_add_fetch(&rcu_cpus[smp_cpu_id()].dynticks, 1, __ATOMIC_SEQ_CST);
+}
+
+// The handler may switch tasks on its way out, and a task switched to from
+// an idle CPU's interrupt is running, so dynticks stays odd until the idle
+// task resumes. from_idle lives on that task's interrupt frame, which is why
+// the caller keeps it rather than the CPU
+bool rcu_irq_enter(void) {
+    rcu_cpu_t *rc = &rcu_cpus[smp_cpu_id()];
+
+    if (rc->dynticks & 1)
+        return false;
+    __atomic_add_fetch(&rc->dynticks, 1, __ATOMIC_SEQ_CST);
+    return true;
+}
+
+void rcu_irq_exit(bool from_idle) {
+    if (from_idle)
+        __atomic_add_fetch(&rcu_cpus[smp_cpu_id()].dynticks, 1, __ATOMIC_SEQ_CST);
+}
+
+// The rcu task's own CPU is between read-side sections right now, and CPUs
+// that are idle stay quiescent until they leave it, so neither is waited for
+static void rcu_start_gp(void) {
+    uint32_t self = smp_cpu_id();
+    uint64_t mask = 0;
+
+    // ordered after the updates the waiting callbacks were queued behind,
+    // any reader that could still see the old versions is counted below
+    __atomic_add_fetch(&rcu_started, 1, __ATOMIC_SEQ_CST);
+    for (uint32_t id = 0; id < SMP_MAX_CPUS; id++) {
+        cpu_t *cpu = smp_cpu(id);
+        if (id == self || !__atomic_load_n(&cpu->online, __ATOMIC_ACQUIRE))
+            continue;
+
+        uint64_t snap = __atomic_load_n(&rcu_cpus[id].dynticks, __ATOMIC_SEQ_CST);
+        rcu_cpus[id].snap = snap;
+        if (snap & 1)
+            mask |= 1UL << id;
+    }
+    __atomic_store_n(&rcu_gp_mask, mask, __ATOMIC_SEQ_CST);
+}
+
+// a CPU that has gone idle since the period started will not switch tasks
+// to report it, so its counter is checked from here
+static void rcu_check_idle(void) {
+    uint64_t mask = __atomic_load_n(&rcu_gp_mask, __ATOMIC_ACQUIRE);
+
+    while (mask != 0) {
+        uint32_t id = __builtin_ctzl(mask);
+        mask &= mask - 1;
+        if (__atomic_load_n(&rcu_cpus[id].dynticks, __ATOMIC_SEQ_CST) != rcu_cpus[id].snap)
+            rcu_report_qs(id);
+    }
+}
+
+// the IPI returns through sched_irq_exit(), which reports the quiescent
+// state unless the CPU was in a read-side section
+static void rcu_kick_holdouts(void) {
+    uint64_t mask = __atomic_load_n(&rcu_gp_mask, __ATOMIC_ACQUIRE);
+
+    while (mask != 0) {
+        uint32_t id = __builtin_ctzl(mask);
+        mask &= mask - 1;
+        LAPIC_SendIPI(smp_cpu(id)->lapic_id, SCHED_IPI_VECTOR);
+        rcu_stats.kicks++;
+    }
+}
+
+static bool rcu_callbacks_pending(void) {
+    return __atomic_load_n(&rcu_cb_head, __ATOMIC_ACQUIRE) != NULL;
+}
+
+// Callbacks are queued in the order of the grace period they wait for, so
+// the ready ones are a prefix of the list. They run without the lock held
+static void rcu_invoke_callbacks(uint64_t completed) {
+    uint64_t flags = spin_lock_irqsave(&rcu_cb_lock);
+    rcu_head_t *ready = rcu_cb_head;
+    rcu_head_t **end = &rcu_cb_head;
+
+    while (*end != NULL && (*end)->gp <= completed)
+        end = &(*end)->next;
+    rcu_cb_head = *end;
+    if (rcu_cb_head == NULL)
+        rcu_cb_tail = &rcu_cb_head;
+    *end = NULL;
+    spin_unlock_irqrestore(&rcu_cb_lock, flags);
+
+    while (ready != NULL) {
+        rcu_head_t *head = ready;
+        ready = head->next;
+        head->fn(head);
+        rcu_stats.invoked++;
+    }
+}
+
+static void rcu_gp_task(void *arg) {
+    (void)arg;
+
+    for (;;) {
+        wait_event(&rcu_wait, rcu_callbacks_pending());
+
+        uint64_t start = ktime_ns();
+        uint64_t kick_at = start + RCU_KICK_NS;
+        rcu_start_gp();
+        while (!wait_event_timeout(&rcu_wait, __atomic_load_n(&rcu_gp_mask, __ATOMIC_ACQUIRE) == 0, RCU_POLL_NS)) {
+            rcu_check_idle();
+            if (ktime_ns() >= kick_at) {
+                rcu_kick_holdouts();
+                kick_at = ktime_ns() + RCU_KICK_NS;
+            }
+        }
+
+        uint64_t completed = __atomic_load_n(&rcu_started, __ATOMIC_RELAXED);
+        __atomic_store_n(&rcu_completed, completed, __ATOMIC_RELEASE);
+
+        uint64_t took = ktime_ns() - start;
+        rcu_stats.gps++;
+        rcu_stats.gp_ns_total += took;
+        if (took > rcu_stats.gp_ns_max)
+            rcu_stats.gp_ns_max = took;
+
+        rcu_invoke_callbacks(completed);
+    }
+}
+
+// A grace period that has already started may have missed readers of what
+// the caller just unpublished, so the callback waits for the next one
+void call_rcu(rcu_head_t *head, rcu_callback_t fn) {
+    head->fn = fn;
+    head->next = NULL;
+
+    uint64_t flags = spin_lock_irqsave(&rcu_cb_lock);
+    head->gp = __atomic_load_n(&rcu_started, __ATOMIC_SEQ_CST) + 1;
+    *rcu_cb_tail = head;
+    rcu_cb_tail = &head->next;
+    rcu_stats.queued++;
+    spin_unlock_irqrestore(&rcu_cb_lock, flags);
+
+    wake_up(&rcu_wait);
+}
+
+typedef struct {
+    rcu_head_t head;            // has to stay first
+    completion_t done;
+} rcu_sync_t;
+
+static void rcu_sync_done(rcu_head_t *head) {
+    complete(&((rcu_sync_t *)head)->done);
+}
+
+void synchronize_rcu(void) {
+    // before rcu_init() the BSP is the only CPU, and its own interrupt
+    // handlers have all returned by the time it gets here
+    if (rcu_task == NULL)
+        return;
+
+    rcu_sync_t sync;
+    init_completion(&sync.done);
+    call_rcu(&sync.head, rcu_sync_done);
+    wait_for_completion(&sync.done);
+}
+
+void rcu_init(void) {
+    rcu_task = kthread_create("rcu", rcu_gp_task, NULL);
+    if (rcu_task == NULL) {
+        LOG_WARN("No memory for the rcu task, synchronize_rcu() will not wait\n");
+        SERIAL(Warn, rcu_init, "No memory for the rcu task, synchronize_rcu() will not wait\n");
+        return;
+    }
+
+    LOG_INFO("RCU running\n");
+    SERIAL(Info, rcu_init, "RCU running\n");
+}
+
+void rcu_print_stats(void) {
+    uint64_t avg = rcu_stats.gps != 0 ? rcu_stats.gp_ns_total / rcu_stats.gps : 0;
+
+    printf("grace periods: %lu started, %lu completed\n",
+           __atomic_load_n(&rcu_started, __ATOMIC_RELAXED), __atomic_load_n(&rcu_completed, __ATOMIC_RELAXED));
+    printf("grace period length avg/max: %lu/%lu us\n", avg / 1000, rcu_stats.gp_ns_max / 1000);
+    printf("callbacks: %lu queued, %lu run\n", rcu_stats.queued, rcu_stats.invoked);
+    printf("holdout IPIs: %lu\n", rcu_stats.kicks);
+
+    uint64_t start = ktime_ns();
+    synchronize_rcu();
+    printf("synchronize_rcu() took %lu us\n", (ktime_ns() - start) / 1000);
+}
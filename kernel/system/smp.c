@@ -0,0 +1,240 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: smp.c
+    Description: Multiprocessor bring-up for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/smp.h"
+#include "includes/percpu.h"
+#include "includes/idle.h"
+#include "boot/limine.h"
+#include "arch/x86_64/includes/gdt.h"
+#include "arch/x86_64/includes/idt.h"
+#include "arch/x86_64/includes/fpu.h"
+#include "arch/x86_64/includes/io.h"
+#include "drivers/pic/includes/apic/apic.h"
+#include "drivers/pic/includes/apic/lapic_timer.h"
+#include "kernel/time/includes/time.h"
+#include "kernel/time/includes/timer.h"
+#include "kernel/time/includes/tsc_sync.h"
+#include "kernel/sched/includes/sched.h"
+#include "tools/includes/log-info.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#define SMP_AP_TIMEOUT_NS 1000000000ull
+
+extern void syscall_init_cpu(void);
+
+__attribute__((used, section(".limine_requests")))
+static volatile struct limine_mp_request mp_request = {
+    .id = LIMINE_MP_REQUEST_ID,
+    .revision = 0,
+    .flags = 0};                // xAPIC, the LAPIC code uses the MMIO window
+
+// An AP that turns up after the BSP gave up on it must not touch its slot,
+// whichever of the two moves the state off WAITING first decides
+enum {
+    SMP_AP_WAITING,
+    SMP_AP_ARRIVED,
+    SMP_AP_ABANDONED,
+};
+
+static cpu_t smp_cpus[SMP_MAX_CPUS];
+static uint32_t smp_ap_state[SMP_MAX_CPUS];
+static uint32_t smp_online = 1;
+
+static inline void gs_base_write(uint32_t msr, uint64_t value) {
+    cpuSetMSR(msr, (uint32_t)value, (uint32_t)(value >> 32));
+}
+
+void percpu_setup(cpu_t *cpu, uint32_t id, uint32_t lapic_id) {
+    cpu->self = cpu;
+    cpu->id = id;
+    cpu->lapic_id = lapic_id;
+    cpu->boot_kernel_stack = cpu->kernel_stack;
+
+    GDT_InitializeCPU(&cpu->gdt, cpu->kernel_stack);
+    gs_base_write(MSR_IA32_GS_BASE, (uint64_t)cpu);
+    gs_base_write(MSR_IA32_KERNEL_GS_BASE, 0);
+}
+
+// also used for the BSP before its cpu_t is set up, which heap_lock() allows
+static uint64_t smp_alloc_stack(void) {
+    uint8_t *stack = malloc(CPU_KERNEL_STACK_SIZE);
+    if (stack == NULL)
+        return 0;
+    return ((uint64_t)stack + CPU_KERNEL_STACK_SIZE) & ~0xFull;
+}
+
+void smp_init_bsp(void) {
+    cpu_t *cpu = &smp_cpus[0];
+
+    cpu->kernel_stack = smp_alloc_stack();
+    percpu_setup(cpu, 0, LAPIC_GetID());
+    cpu->started = cpu->online = true;
+}
+
+// Limine drops each AP here on its own 64 KiB stack with interrupts off and
+// the kernel's page tables loaded
+static void smp_ap_entry(struct limine_mp_info *info) {
+    cpu_t *cpu = (cpu_t *)info->extra_argument;
+    uint32_t state = SMP_AP_WAITING;
+
+    if (!__atomic_compare_exchange_n(&smp_ap_state[cpu->id], &state, SMP_AP_ARRIVED, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        for (;;)
+            __asm__ volatile("cli; hlt");
+    }
+
+    percpu_setup(cpu, cpu->id, info->lapic_id);
+    IDT_Reload();
+    fpu_init_cpu();
+    LAPIC_InitializeCPU();
+    syscall_init_cpu();
+    __atomic_store_n(&cpu->started, true, __ATOMIC_RELEASE);
+
+    tsc_sync_target(cpu->id);
+    if (lapic_timer_init() == 0)
+        timer_subsystem_init();
+    sched_init_cpu();
+
+    __atomic_store_n(&cpu->online, true, __ATOMIC_RELEASE);
+    enable_interrupts();
+    sched_idle_loop();
+}
+
+static bool smp_wait(volatile bool *flag) {
+    uint64_t deadline = ktime_ns() + SMP_AP_TIMEOUT_NS;
+
+    while (!__atomic_load_n(flag, __ATOMIC_ACQUIRE)) {
+        if (ktime_ns() > deadline)
+            return false;
+        __asm__ volatile("pause");
+    }
+    return true;
+}
+
+void smp_init(void) {
+    struct limine_mp_response *mp = mp_request.response;
+
+    if (mp == NULL) {
+        LOG_WARN("Bootloader did not start the other CPUs, running on the BSP only\n");
+        SERIAL(Warn, smp_init, "Bootloader did not start the other CPUs, running on the BSP only\n");
+        return;
+    }
+
+    uint32_t next_id = 1;
+    for (uint64_t i = 0; i < mp->cpu_count; i++) {
+        struct limine_mp_info *info = mp->cpus[i];
+        if (info->lapic_id == mp->bsp_lapic_id)
+            continue;
+        if (next_id >= SMP_MAX_CPUS) {
+            LOG_WARN("Only %u of %lu CPUs are supported\n", SMP_MAX_CPUS, mp->cpu_count);
+            SERIAL(Warn, smp_init, "Only %u of %lu CPUs are supported\n", SMP_MAX_CPUS, mp->cpu_count);
+            break;
+        }
+
+        cpu_t *cpu = &smp_cpus[next_id];
+        cpu->id = next_id;
+        cpu->lapic_id = info->lapic_id;
+        cpu->kernel_stack = smp_alloc_stack();
+        if (cpu->kernel_stack == 0) {
+            // no goto_address was written, the AP stays parked in the
+            // bootloader and the slot goes to the next one
+            LOG_WARN("No memory for the kernel stack of CPU %u (LAPIC %u), skipping it\n", next_id, info->lapic_id);
+            SERIAL(Warn, smp_init, "No memory for the kernel stack of CPU %u (LAPIC %u), skipping it\n", next_id,
+                   info->lapic_id);
+            continue;
+        }
+        info->extra_argument = (uint64_t)cpu;
+        __atomic_store_n(&info->goto_address, smp_ap_entry, __ATOMIC_RELEASE);
+
+        if (!smp_wait(&cpu->started)) {
+            uint32_t state = SMP_AP_WAITING;
+            // goto_address is out, so the slot and its stack are retired for
+            // good; should the AP still come, it finds the slot abandoned
+            if (__atomic_compare_exchange_n(&smp_ap_state[next_id], &state, SMP_AP_ABANDONED, false,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                LOG_WARN("CPU %u (LAPIC %u) did not start\n", next_id, info->lapic_id);
+                SERIAL(Warn, smp_init, "CPU %u (LAPIC %u) did not start\n", next_id, info->lapic_id);
+                next_id++;
+                continue;
+            }
+            // it arrived just as we gave up, give it the time to finish
+            if (!smp_wait(&cpu->started)) {
+                LOG_WARN("CPU %u (LAPIC %u) hung during bring-up\n", next_id, info->lapic_id);
+                SERIAL(Warn, smp_init, "CPU %u (LAPIC %u) hung during bring-up\n", next_id, info->lapic_id);
+                next_id++;
+                continue;
+            }
+        }
+
+        uint64_t flags = irq_save();
+        tsc_sync_source(next_id);
+        irq_restore(flags);
+
+        if (!smp_wait(&cpu->online)) {
+            LOG_WARN("CPU %u (LAPIC %u) hung during bring-up\n", next_id, info->lapic_id);
+            SERIAL(Warn, smp_init, "CPU %u (LAPIC %u) hung during bring-up\n", next_id, info->lapic_id);
+            next_id++;
+            continue;
+        }
+        next_id++;
+        smp_online++;
+    }
+
+    LOG_INFO("%u of %lu CPUs online\n", smp_online, mp->cpu_count);
+    SERIAL(Info, smp_init, "%u of %lu CPUs online\n", smp_online, mp->cpu_count);
+}
+
+uint32_t smp_cpu_count(void) {
+    return smp_online;
+}
+
+cpu_t *smp_cpu(uint32_t id) {
+    return id < SMP_MAX_CPUS ? &smp_cpus[id] : NULL;
+}
+
+void smp_print_cpus(void) {
+    printf("cpu  lapic  state     irqs       syscalls\n");
+    for (uint32_t id = 0; id < SMP_MAX_CPUS; id++) {
+        cpu_t *cpu = &smp_cpus[id];
+        if (!cpu->started)
+            continue;
+        printf("%3u  %5u  %-8s  %9lu  %9lu\n", id, cpu->lapic_id, cpu->online ? "online" : "hung",
+               cpu->irqs, cpu->syscalls);
+    }
+}
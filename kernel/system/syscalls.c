@@ -43,6 +43,9 @@
 #include "kernel/terminal/src/flanterm_backends/fb.h"
 #include "kernel/terminal/src/flanterm.h"
 #include "kernel/shell/includes/keyboard.h"
+#include "kernel/time/includes/time.h"
+#include "kernel/time/includes/vdso.h"
+#include "includes/percpu.h"
 
 extern struct flanterm_context *global_flanterm;
 
@@ -94,14 +97,50 @@ uint64_t sys_read(uint64_t fd, uint64_t buf_ptr, uint64_t count,
     return (uint64_t)-1; // unsupported fd
 }
 
+uint64_t sys_clock_gettime(uint64_t clock_id, uint64_t ts_ptr, uint64_t a3,
+                           uint64_t a4, uint64_t a5, uint64_t a6) {
+    (void)a3; (void)a4; (void)a5; (void)a6;
+
+    if (!ts_ptr) return (uint64_t)-1;
+
+    uint64_t ns;
+    if (clock_id == CLOCK_MONOTONIC)
+        ns = ktime_ns();
+    else if (clock_id == CLOCK_REALTIME)
+        ns = ktime_real_ns();
+    else
+        return (uint64_t)-1;
+
+    sys_timespec_t *ts = (sys_timespec_t *)ts_ptr;
+    ts->tv_sec = ns / 1000000000;
+    ts->tv_nsec = ns % 1000000000;
+    return 0;
+}
+
+uint64_t sys_gettimeofday(uint64_t tv_ptr, uint64_t tz_ptr, uint64_t a3,
+                          uint64_t a4, uint64_t a5, uint64_t a6) {
+    (void)tz_ptr; (void)a3; (void)a4; (void)a5; (void)a6;
+
+    if (!tv_ptr) return (uint64_t)-1;
+
+    uint64_t ns = ktime_real_ns();
+    sys_timeval_t *tv = (sys_timeval_t *)tv_ptr;
+    tv->tv_sec = ns / 1000000000;
+    tv->tv_usec = (ns % 1000000000) / 1000;
+    return 0;
+}
+
 void init_syscall_table(void) {
     syscall_table[SYS_write] = sys_write;
     syscall_table[SYS_exit]  = sys_exit;
+    syscall_table[SYS_clock_gettime] = sys_clock_gettime;
+    syscall_table[SYS_gettimeofday]  = sys_gettimeofday;
 }
 
 uint64_t handle_syscall(uint64_t num,
                         uint64_t a1, uint64_t a2, uint64_t a3,
                         uint64_t a4, uint64_t a5) {
+    this_cpu()->syscalls++;
     if (num >= SYS_MAX || !syscall_table[num])
         return (uint64_t)-1;
 
@@ -126,14 +165,18 @@ static inline void wrmsr(uint32_t msr, uint64_t value) {
 
 extern void syscall_handler(void);
 
-void syscall_init(void) {
+// the MSRs are per CPU, every AP runs this during bring-up
+void syscall_init_cpu(void) {
     uint64_t star = ((uint64_t)0x08 << 32) |   // kernel CS
                     ((uint64_t)0x18 << 48);    // user CS base
 
     wrmsr(MSR_STAR, star);
     wrmsr(MSR_LSTAR, (uint64_t)syscall_handler);
     wrmsr(MSR_SFMASK, (1ULL << 9));
+}
 
+void syscall_init(void) {
+    syscall_init_cpu();
     init_syscall_table();
 
     LOG_INFO("Syscalls successfully initialized\n");
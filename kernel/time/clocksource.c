@@ -0,0 +1,307 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: clocksource.c
+    Description: Clocksource module of the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/clocksource.h"
+#include "includes/time.h"
+#include "includes/tsc.h"
+#include "includes/timer.h"
+#include "includes/vdso.h"
+#include "arch/x86_64/includes/io.h"
+#include "kernel/system/includes/seqlock.h"
+#include "tools/includes/log-info.h"
+#include <stdio.h>
+#include <string.h>
+
+static clocksource_t *cs_list;
+static clocksource_t *cs_current;
+static bool cs_pinned;          // chosen from the shell, leave it alone
+
+// timekeeping state while a source other than the TSC is current: ns at
+// cycle_last, folded forward whenever half the counter range has gone by.
+// Readers take a snapshot under the seqcount, the lock serialises folds and
+// switches
+static seqlock_t cs_seqlock = SEQLOCK_INIT;
+static uint64_t cs_cycle_last;
+static uint64_t cs_base_ns;
+
+extern bool time_uses_tsc;
+extern clocksource_t tsc_clocksource;
+
+clocksource_t *clocksource_current(void) {
+    return cs_current;
+}
+
+clocksource_t *clocksource_list(void) {
+    return cs_list;
+}
+
+clocksource_t *clocksource_find(const char *name) {
+    for (clocksource_t *cs = cs_list; cs; cs = cs->next) {
+        if (strcmp(cs->name, name) == 0)
+            return cs;
+    }
+    return NULL;
+}
+
+// The counter is read after the snapshot, so it is never behind the
+// snapshot's cycle_last however many folds other CPUs make meanwhile
+uint64_t clocksource_ns(void) {
+    clocksource_t *cs;
+    uint64_t last, base, now;
+    uint32_t seq;
+
+    do {
+        seq = read_seqbegin(&cs_seqlock);
+        cs = cs_current;
+        if (cs == NULL)
+            return 0;
+        last = cs_cycle_last;
+        base = cs_base_ns;
+        now = cs->read();
+    } while (read_seqretry(&cs_seqlock, seq));
+
+    uint64_t delta = (now - last) & cs->mask;
+    uint64_t ns = base + clock_scale_apply(cs->to_ns, delta);
+
+    if (delta > cs->mask >> 1) {
+        uint64_t flags = write_seqlock_irqsave(&cs_seqlock);
+        // whoever folded since the snapshot took the base past it already
+        if (cs_current == cs && cs_cycle_last == last) {
+            cs_cycle_last = now;
+            cs_base_ns = ns;
+        }
+        write_sequnlock_irqrestore(&cs_seqlock, flags);
+    }
+    return ns;
+}
+
+uint64_t clocksource_max_idle_ns(void) {
+    if (cs_current == NULL || cs_current->mask == UINT64_MAX)
+        return UINT64_MAX;
+    return clock_scale_apply(cs_current->to_ns, cs_current->mask >> 1);
+}
+
+// hand timekeeping over without ktime_ns() jumping
+static void clocksource_switch(clocksource_t *cs) {
+    uint64_t flags = irq_save();
+    uint64_t now_ns = ktime_ns();
+
+    // ktime_ns() may fold, so the lock is only taken once it is done
+    arch_spin_lock(&cs_seqlock.lock);
+    write_seqcount_begin(&cs_seqlock.seq);
+    if (cs == &tsc_clocksource) {
+        boot_tsc = read_tsc_synced() - clock_scale_apply(cs->from_ns, now_ns);
+        time_uses_tsc = true;
+    } else {
+        cs_cycle_last = cs->read();
+        cs_base_ns = now_ns;
+        time_uses_tsc = false;
+    }
+    cs_current = cs;
+    write_seqcount_end(&cs_seqlock.seq);
+    arch_spin_unlock(&cs_seqlock.lock);
+    irq_restore(flags);
+    vdso_update();
+
+    LOG_INFO("Switched clocksource to %s\n", cs->name);
+    SERIAL(Info, clocksource_switch, "Switched clocksource to %s\n", cs->name);
+}
+
+static clocksource_t *clocksource_best(void) {
+    for (clocksource_t *cs = cs_list; cs; cs = cs->next) {
+        if (!(cs->flags & CLOCKSOURCE_UNSTABLE))
+            return cs;
+    }
+    return NULL;
+}
+
+static void clocksource_reselect(void) {
+    clocksource_t *best = clocksource_best();
+
+    if (cs_pinned && cs_current && !(cs_current->flags & CLOCKSOURCE_UNSTABLE))
+        return;
+    if (best && best != cs_current)
+        clocksource_switch(best);
+}
+
+#define CLOCKSOURCE_READ_SAMPLES 64
+
+static void clocksource_measure_read(clocksource_t *cs) {
+    if (!cpu_has_tsc()) {
+        cs->read_cycles = 0;
+        return;
+    }
+
+    uint64_t start = read_tsc_serialized();
+    for (uint32_t i = 0; i < CLOCKSOURCE_READ_SAMPLES; i++)
+        (void)cs->read();
+    cs->read_cycles = (uint32_t)((read_tsc_serialized() - start) / CLOCKSOURCE_READ_SAMPLES);
+}
+
+void clocksource_update_freq(clocksource_t *cs, uint64_t freq_hz) {
+    cs->freq_hz = freq_hz;
+    cs->to_ns = clock_scale_make(freq_hz, 1000000000);
+    cs->from_ns = clock_scale_make(1000000000, freq_hz);
+}
+
+int8_t clocksource_register(clocksource_t *cs) {
+    if (cs->read == NULL || cs->freq_hz == 0 || cs->mask == 0)
+        return -1;
+
+    clocksource_update_freq(cs, cs->freq_hz);
+    clocksource_measure_read(cs);
+
+    // keep the list sorted, best first
+    clocksource_t **link = &cs_list;
+    while (*link && (*link)->rating >= cs->rating)
+        link = &(*link)->next;
+    cs->next = *link;
+    *link = cs;
+
+    LOG_INFO("Clocksource %s: %lu Hz, rating %u, %u cycles per read\n", cs->name, cs->freq_hz,
+             cs->rating, cs->read_cycles);
+    SERIAL(Info, clocksource_register, "Clocksource %s: %lu Hz, rating %u, %u cycles per read\n", cs->name,
+           cs->freq_hz, cs->rating, cs->read_cycles);
+
+    clocksource_reselect();
+    return 0;
+}
+
+int8_t clocksource_select(clocksource_t *cs) {
+    if (cs == NULL || (cs->flags & CLOCKSOURCE_UNSTABLE))
+        return -1;
+    cs_pinned = true;
+    if (cs != cs_current)
+        clocksource_switch(cs);
+    return 0;
+}
+
+void clocksource_mark_unstable(clocksource_t *cs, const char *reason) {
+    if (cs->flags & CLOCKSOURCE_UNSTABLE)
+        return;
+    cs->flags |= CLOCKSOURCE_UNSTABLE;
+
+    LOG_WARN("Clocksource %s marked unstable: %s\n", cs->name, reason);
+    SERIAL(Warn, clocksource_mark_unstable, "Clocksource %s marked unstable: %s\n", cs->name, reason);
+    if (cs == cs_current)
+        clocksource_reselect();
+}
+
+void clocksource_delay_us(clocksource_t *cs, uint32_t micros) {
+    uint64_t cycles = clock_scale_apply(cs->from_ns, (uint64_t)micros * 1000);
+    uint64_t chunk = cs->mask >> 1;     // never wait for more than half a wrap at once
+
+    while (cycles) {
+        uint64_t wait = cycles < chunk ? cycles : chunk;
+        uint64_t start = cs->read();
+        while (((cs->read() - start) & cs->mask) < wait)
+            __asm__ volatile("pause");
+        cycles -= wait;
+    }
+}
+
+// Watchdog: a source flagged MUST_VERIFY (a TSC that is not invariant) is
+// compared with the best trusted source every CLOCKSOURCE_WATCHDOG_NS while it
+// is current. The timer only runs then, so an invariant TSC costs no wakeups
+static ktimer_t cs_watchdog_timer;
+static clocksource_t *cs_watchdog;
+static clocksource_t *cs_watched;
+static uint64_t cs_wd_last, cs_watched_last;
+
+// A watchdog that wraps between two samples reads short by whole wraps and
+// would condemn a good TSC, so it must last at least two periods (the PIT
+// wraps every 55 ms)
+static clocksource_t *clocksource_find_watchdog(void) {
+    for (clocksource_t *cs = cs_list; cs; cs = cs->next) {
+        if (cs == cs_current || (cs->flags & (CLOCKSOURCE_UNSTABLE | CLOCKSOURCE_MUST_VERIFY)))
+            continue;
+        if (cs->mask < clock_scale_apply(cs->from_ns, 2 * CLOCKSOURCE_WATCHDOG_NS))
+            continue;
+        return cs;
+    }
+    return NULL;
+}
+
+static void clocksource_watchdog(void *arg) {
+    (void)arg;
+
+    if (cs_current != cs_watched)
+        return;     // switched away, nothing left to check
+
+    uint64_t wd_now = cs_watchdog->read();
+    uint64_t cs_now = cs_watched->read();
+    uint64_t wd_ns = clock_scale_apply(cs_watchdog->to_ns, (wd_now - cs_wd_last) & cs_watchdog->mask);
+    uint64_t cs_ns = clock_scale_apply(cs_watched->to_ns, (cs_now - cs_watched_last) & cs_watched->mask);
+    cs_wd_last = wd_now;
+    cs_watched_last = cs_now;
+
+    uint64_t skew = wd_ns > cs_ns ? wd_ns - cs_ns : cs_ns - wd_ns;
+    if (skew > CLOCKSOURCE_WATCHDOG_THRESHOLD_NS) {
+        clocksource_mark_unstable(cs_watched, "drifted from the watchdog");
+        return;
+    }
+    mod_timer(&cs_watchdog_timer, ktime_ns() + CLOCKSOURCE_WATCHDOG_NS);
+}
+
+int8_t clocksource_watchdog_start(void) {
+    if (cs_current == NULL || !(cs_current->flags & CLOCKSOURCE_MUST_VERIFY))
+        return 0;
+
+    cs_watchdog = clocksource_find_watchdog();
+    if (cs_watchdog == NULL) {
+        LOG_WARN("No trusted clocksource to verify %s against\n", cs_current->name);
+        SERIAL(Warn, clocksource_watchdog_start, "No trusted clocksource to verify %s against\n", cs_current->name);
+        return -1;
+    }
+
+    cs_watched = cs_current;
+    cs_wd_last = cs_watchdog->read();
+    cs_watched_last = cs_watched->read();
+    return timer_add(&cs_watchdog_timer, ktime_ns() + CLOCKSOURCE_WATCHDOG_NS, clocksource_watchdog, NULL);
+}
+
+void clocksource_print(void) {
+    printf("  name      rating        freq(Hz)  bits  read(cycles)  state\n");
+    for (clocksource_t *cs = cs_list; cs; cs = cs->next) {
+        uint32_t bits = cs->mask == UINT64_MAX ? 64 : 64 - __builtin_clzll(cs->mask);
+        const char *state = (cs->flags & CLOCKSOURCE_UNSTABLE) ? "unstable" :
+                            (cs->flags & CLOCKSOURCE_MUST_VERIFY) ? "verified by watchdog" : "ok";
+        printf("%c %-8s  %6u  %14lu  %4u  %12u  %s\n", cs == cs_current ? '*' : ' ', cs->name,
+               cs->rating, cs->freq_hz, bits, cs->read_cycles, state);
+    }
+}
@@ -0,0 +1,97 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: clocksource.h
+    Description: Clocksource module of the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef CLOCKSOURCE_H
+#define CLOCKSOURCE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "time.h"
+
+/*
+ * Every free running counter the kernel can tell time with registers itself
+ * here. The highest rated one that is not known to be unstable backs
+ * ktime_ns() and udelay(). Ratings follow the usual scale:
+ *   100-199  usable but slow or coarse (PIT)
+ *   200-299  good (ACPI PM timer, HPET)
+ *   300+     ideal, cheap and precise (invariant TSC)
+ */
+
+#define CLOCKSOURCE_MUST_VERIFY  (1u << 0)  // cross-checked against a trusted source while in use
+#define CLOCKSOURCE_UNSTABLE     (1u << 1)  // failed that check, never selected again
+
+// watchdog period and the drift over it that marks a source unstable
+#define CLOCKSOURCE_WATCHDOG_NS  500000000ull
+#define CLOCKSOURCE_WATCHDOG_THRESHOLD_NS (1000000000ull >> 4)
+
+typedef struct clocksource {
+    const char *name;
+    uint32_t rating;
+    uint64_t freq_hz;
+    uint64_t mask;              // counter width, deltas are taken modulo this
+    uint64_t (*read)(void);
+    uint32_t flags;
+    uint32_t read_cycles;       // measured cost of read() in TSC cycles, 0 if unknown
+    clock_scale_t to_ns;
+    clock_scale_t from_ns;
+    struct clocksource *next;   // registry, highest rating first
+} clocksource_t;
+
+// fills in the scales and read cost, and switches to it if it is now the best
+int8_t clocksource_register(clocksource_t *cs);
+
+clocksource_t *clocksource_current(void);
+clocksource_t *clocksource_list(void);
+clocksource_t *clocksource_find(const char *name);
+
+// pin a source by hand, the best one is no longer picked automatically after
+int8_t clocksource_select(clocksource_t *cs);
+void clocksource_mark_unstable(clocksource_t *cs, const char *reason);
+
+// re-derive the scales after freq_hz changed (TSC recalibration)
+void clocksource_update_freq(clocksource_t *cs, uint64_t freq_hz);
+
+uint64_t clocksource_ns(void);              // ktime_ns() for non-TSC sources
+uint64_t clocksource_max_idle_ns(void);     // longest sleep that cannot miss a wrap
+void clocksource_delay_us(clocksource_t *cs, uint32_t micros);
+
+int8_t clocksource_watchdog_start(void);    // needs the timer subsystem
+void clocksource_print(void);
+
+#endif // CLOCKSOURCE_H
@@ -48,22 +48,48 @@
 #include "tsc.h"
 
 
-typedef enum{
-    PIT_DELAY    = 0,
-    PIC_DELAY    = 1,
-    APIC_DELAY   = 2,
-    IOAPIC_DELAY = 3,
-    TSC_DELAY    = 4,
-    HPET_DELAY   = 5,
-} t_delay_mode;
+// Fixed-point rate conversion, out = (in * mult) >> shift with a 128-bit
+// product, so converting a counter value costs one multiply and one shift.
+typedef struct {
+    uint64_t mult;
+    uint32_t shift;
+} clock_scale_t;
 
+// scale turning ticks of a from_hz counter into to_hz units. shift is as large
+// as to_hz allows (one bit is left for rounding), which keeps ~40 bits of
+// precision even for ms
+static inline clock_scale_t clock_scale_make(uint64_t from_hz, uint64_t to_hz) {
+    clock_scale_t scale = { 0, 0 };
+
+    if (from_hz == 0 || to_hz == 0)
+        return scale;
+    scale.shift = __builtin_clzll(to_hz) - 1;
+    scale.mult = ((to_hz << scale.shift) + from_hz / 2) / from_hz;
+    return scale;
+}
+
+static inline uint64_t clock_scale_apply(clock_scale_t scale, uint64_t ticks) {
+    return (uint64_t)(((unsigned __int128)ticks * scale.mult) >> scale.shift);
+}
+
+// TSC conversions, all zero until time_init() has calibrated the TSC
+extern clock_scale_t tsc_to_ns;
+extern clock_scale_t tsc_to_us;
+extern clock_scale_t tsc_to_ms;
+extern clock_scale_t tsc_from_us;
 
 int8_t set_CPU_clock_speed(void);
+int8_t time_init(void);
+int8_t time_hpet_init(void);   // needs ACPI, the VMM and the APIC up
+void time_print_sources(void); // read cost, resolution and delay error per clocksource
 
+uint64_t ktime_ns(void);        // nanoseconds since kernel entry, does not wrap
 uint32_t get_time_us(void);
 uint32_t get_time_ms(void);
 double get_time_ms_fp(void);
 
+// Spins on the current clocksource, meant for waits under ~10 us. Anything
+// longer should use msleep() or usleep_range() from timer.h
 int8_t udelay(uint32_t micros);
 int8_t tsc_delay_us(uint32_t micros);
 
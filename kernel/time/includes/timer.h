@@ -0,0 +1,148 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: timer.h
+    Description: Kernel timer module of the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Kernel timers run from a hierarchical timing wheel, one per CPU, advanced from
+ * the LAPIC timer interrupt (the HPET when there is no usable LAPIC timer).
+ * Deadlines are rounded up to TIMER_TICK_NS.
+ *
+ * The first level has 256 one-tick slots. Each of the four levels above it has
+ * 64 slots, each 64 times coarser than the level below. Adding or cancelling a
+ * timer is a list insert or unlink. A timer in a higher level is moved down
+ * ("cascaded") once, when the level below wraps, so the work per tick does not
+ * grow with the number of pending timers.
+ */
+
+#define TIMER_TICK_NS   1000000     // 1 ms
+
+#define TIMER_TV1_BITS  8
+#define TIMER_TVN_BITS  6
+#define TIMER_TV1_SIZE  (1 << TIMER_TV1_BITS)
+#define TIMER_TVN_SIZE  (1 << TIMER_TVN_BITS)
+#define TIMER_TVN_LEVELS 4
+#define TIMER_MAX_TICKS 0xFFFFFFFFull  // further out than this waits in the top level
+#define TIMER_NONE      UINT64_MAX     // no timer pending
+
+#define TIMER_MAX_CPUS  64
+
+typedef void (*timer_fn_t)(void *arg);
+
+struct timer_wheel;
+
+typedef struct ktimer {
+    struct ktimer *next;
+    struct ktimer **pprev;      // NULL when not queued
+    uint64_t expires;           // in ticks
+    timer_fn_t fn;
+    void *arg;
+    struct timer_wheel *wheel;  // wheel it was last queued on
+} ktimer_t;
+
+typedef struct {
+    uint64_t added;
+    uint64_t cancelled;
+    uint64_t expired;
+    uint64_t cascaded;          // timers moved down a level
+    uint64_t pending;
+    uint64_t max_late_ticks;    // worst delay between expiry and the callback
+} timer_wheel_stats_t;
+
+// event device programming when tickless
+typedef struct {
+    uint64_t interrupts;        // timer interrupts taken
+    uint64_t programmed;        // one-shots set for the next expiry
+    uint64_t stopped;           // times nothing was pending and the device was stopped
+    uint64_t latency_sum_ns;    // interrupt arrival past the programmed tick
+    uint64_t latency_max_ns;
+} timer_nohz_stats_t;
+
+typedef struct timer_wheel {
+    uint64_t clk;               // next tick to run
+    ktimer_t *tv1[TIMER_TV1_SIZE];
+    ktimer_t *tvn[TIMER_TVN_LEVELS][TIMER_TVN_SIZE];
+    timer_wheel_stats_t stats;
+} timer_wheel_t;
+
+// The wheel itself, no locking and no notion of time beyond the ticks passed in
+void timer_wheel_init(timer_wheel_t *wheel, uint64_t now_tick);
+void timer_wheel_add(timer_wheel_t *wheel, ktimer_t *timer);
+bool timer_wheel_del(ktimer_t *timer);                  // true if it was queued
+void timer_wheel_advance(timer_wheel_t *wheel, uint64_t now_tick); // runs callbacks due by now_tick
+uint64_t timer_wheel_next(timer_wheel_t *wheel);        // earliest expiry, TIMER_NONE if empty
+
+// Kernel API, deadlines are absolute ktime_ns() values. Each CPU has its own
+// wheel with no lock, interrupts off is all that keeps it consistent, so a
+// timer is queued on the calling CPU and, while it is pending, may only be
+// re-armed or cancelled from that same CPU. A task that arms one pins itself
+// until it is gone (see schedule_timeout()); a callback may re-arm its own
+// timer, it runs on the timer's CPU
+void timer_setup(ktimer_t *timer, timer_fn_t fn, void *arg);
+int8_t timer_add(ktimer_t *timer, uint64_t deadline_ns, timer_fn_t fn, void *arg);
+bool mod_timer(ktimer_t *timer, uint64_t deadline_ns);  // true if it was pending
+bool timer_cancel(ktimer_t *timer);                     // true if it was pending
+
+static inline bool timer_pending(const ktimer_t *timer) {
+    return timer->pprev != NULL;
+}
+
+// Tickless: the LAPIC (or HPET) one-shot is set for the earliest pending timer
+// only, and stopped when there is none, so an idle CPU is not woken to find
+// nothing to do. The wheel catches up from ktime_ns() on the next interrupt.
+// Without a calibrated TSC there is no clock to catch up from and a fixed
+// TIMER_TICK_NS tick is used instead
+int8_t timer_subsystem_init(void);  // per CPU, after lapic_timer_init()
+void timer_run(void);               // runs what is due on this CPU, reprograms the next event
+timer_nohz_stats_t *timer_nohz_stats(uint32_t cpu);    // by CPU id
+uint64_t timer_next_event_ns(void); // when this CPU's event device fires next, UINT64_MAX if stopped
+void timer_print_stats(void);
+
+// Sleeping waits: the task blocks (or, before the scheduler runs, the CPU
+// halts) until a timer wakes it instead of spinning.
+// usleep_range() wakes somewhere between min_us and max_us, a wide range lets
+// it use the tick; when the next tick is past max_us it falls back to udelay()
+void msleep(uint32_t ms);
+void usleep_range(uint32_t min_us, uint32_t max_us);
+
+#endif // TIMER_H
@@ -44,11 +44,33 @@
 #include "arch/x86_64/includes/io.h"
 #include "tools/includes/math.h"
 
+// where CPU_clock_speed came from, best first
+typedef enum {
+    TSC_SOURCE_NONE       = 0,
+    TSC_SOURCE_HYPERVISOR = 1, // CPUID 0x40000010, exact under KVM/QEMU/VMware
+    TSC_SOURCE_CRYSTAL    = 2, // CPUID 0x15 core crystal ratio
+    TSC_SOURCE_BASE_FREQ  = 3, // CPUID 0x16 nominal base frequency
+    TSC_SOURCE_PIT        = 4, // measured against the PIT
+    TSC_SOURCE_HPET       = 5, // PIT result refined against the HPET once ACPI is up
+} tsc_source_t;
+
 extern uint64_t CPU_clock_speed;
 extern uint64_t boot_tsc;  // TSC value at kernel entry
+extern tsc_source_t tsc_source;
+extern bool tsc_invariant; // ticks at a constant rate across P-, C- and T-states
+
+#define TSC_MAX_CPUS 64
+
+// per-CPU corrections found by the sync check (tsc_sync.h), only used when a
+// CPU has no IA32_TSC_ADJUST to fix its skew in hardware
+extern bool tsc_offsets_in_use;
+extern int64_t tsc_cpu_offset[TSC_MAX_CPUS];
 
 uint64_t measure_tsc_over_pit(uint16_t pit_reload);
 uint64_t get_cpu_clock_speed_khz(void);
+uint64_t tsc_freq_from_cpuid(tsc_source_t *source);
+bool tsc_is_invariant(void);
+const char *tsc_source_name(tsc_source_t source);
 int8_t tsc_delay_us(uint32_t micros);
 
 static inline bool cpu_has_tsc(void) {
@@ -80,6 +102,16 @@ static inline uint64_t read_tsc_fast(void) {
     return ((uint64_t)hi << 32) | lo;
 }
 
+// TSC reading comparable across CPUs, for timestamps rather than short deltas
+static inline uint64_t read_tsc_synced(void) {
+    if (!tsc_offsets_in_use)
+        return read_tsc_fast();
+
+    uint32_t lo, hi, aux;
+    asm volatile("rdtscp" : "=a"(lo), "=d"(hi), "=c"(aux));
+    return (((uint64_t)hi << 32) | lo) + tsc_cpu_offset[aux % TSC_MAX_CPUS];
+}
+
 // Call this as early as possible in kernel entry
 static inline void capture_boot_tsc(void) {
     if (cpu_has_tsc()) {
@@ -87,24 +119,8 @@ static inline void capture_boot_tsc(void) {
     }
 }
 
-static inline int8_t set_CPU_clock_speed_partial(void) {
-    if (CPU_clock_speed == 0)
-        CPU_clock_speed = get_cpu_clock_speed_khz() * 1000;  // set in hz
-    return CPU_clock_speed == 0 ? -1 : 0; // Error detection
-}
-
-static inline int8_t set_CPU_clock_speed(void) {
-    if (CPU_clock_speed != 0)
-        return 0; // Already set
-    uint64_t accumulate = 0;
-    for (int i=0; i<10; i++) {
-        set_CPU_clock_speed_partial();
-        if (CPU_clock_speed == 0) 
-            return -1;
-        accumulate += CPU_clock_speed/1000; // in khz
-    }
-    CPU_clock_speed = accumulate * 100; // average in hz
-    return 0; // Success
-}
+// reads the TSC frequency from CPUID, or calibrates against the PIT when the
+// CPU does not report it. Runs once, later calls return the cached result
+int8_t set_CPU_clock_speed(void);
 
 #endif // TSC_H
\ No newline at end of file
@@ -0,0 +1,71 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: tsc_sync.h
+    Description: Cross-CPU TSC synchronization for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef TSC_SYNC_H
+#define TSC_SYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Every AP runs a warp test against the BSP when it comes up: both CPUs read
+ * the TSC in turn under a shared lock for TSC_SYNC_TEST_MS, and any reading
+ * smaller than the one before it (taken on the other CPU) is a warp. The
+ * direction of the warps tells whether the AP is behind or ahead.
+ *
+ * A skewed AP is pulled into line through IA32_TSC_ADJUST when the CPU has
+ * it, otherwise through a per-CPU offset that read_tsc_synced() adds (the CPU
+ * is found with rdtscp, which returns the index kept in IA32_TSC_AUX). If the
+ * warp survives TSC_SYNC_RETRIES corrections, or goes both ways, the TSC is
+ * marked unstable and timekeeping moves to the HPET.
+ */
+
+#define TSC_SYNC_TEST_MS  20
+#define TSC_SYNC_RETRIES  3
+
+#define MSR_IA32_TSC_ADJUST 0x3B
+#define MSR_IA32_TSC_AUX    0xC0000103
+
+// boot CPU, after the TSC is calibrated. Records its TSC_ADJUST and TSC_AUX
+void tsc_sync_init(void);
+
+// called in pairs while AP cpu comes up, the BSP runs the source side
+void tsc_sync_source(uint32_t cpu);
+void tsc_sync_target(uint32_t cpu);
+
+#endif // TSC_SYNC_H
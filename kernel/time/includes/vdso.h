@@ -0,0 +1,121 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: vdso.h
+    Description: Shared user-space time page for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef VDSO_H
+#define VDSO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * The kernel keeps one page with everything needed to turn a TSC read into
+ * CLOCK_MONOTONIC / CLOCK_REALTIME, and maps it read-only at VDSO_TIME_ADDR so
+ * user code can tell the time with rdtsc and a multiply instead of a syscall.
+ *
+ * The page is guarded by a sequence count: the kernel makes seq odd, updates
+ * the fields, then makes it even again. A reader copies the fields and retries
+ * if seq was odd or changed under it. When clock_mode is VDSO_CLOCK_NONE (the
+ * TSC is not the clocksource) readers go to SYS_clock_gettime instead.
+ *
+ * This header is the ABI, user/lib builds against it, so fields only get added
+ * at the end.
+ */
+
+#define VDSO_TIME_ADDR   0x00007FFFFFFFE000UL  // just under the top of user space
+#define VDSO_TIME_VERSION 1
+
+#define VDSO_CLOCK_NONE  0      // no user-readable clock, use the syscall
+#define VDSO_CLOCK_TSC   1
+
+typedef struct {
+    volatile uint32_t seq;      // odd while the kernel is writing
+    uint32_t version;
+    uint32_t clock_mode;
+    uint32_t shift;
+    uint64_t mult;              // ns = mono_base_ns + ((tsc - tsc_base) * mult >> shift)
+    uint64_t tsc_base;
+    uint64_t mono_base_ns;
+    uint64_t realtime_offset_ns;    // CLOCK_REALTIME - CLOCK_MONOTONIC
+} vdso_time_t;
+
+static inline void vdso_barrier(void) {
+    __asm__ volatile("" ::: "memory");     // x86 keeps loads and stores in order
+}
+
+static inline uint64_t vdso_rdtsc(void) {
+    uint32_t lo, hi;
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// CLOCK_MONOTONIC from the page, false when the caller has to ask the kernel.
+// realtime gets the CLOCK_REALTIME offset from the same snapshot, may be NULL
+static inline bool vdso_read_ns(const volatile vdso_time_t *vt, uint64_t *mono_ns,
+                                uint64_t *realtime_offset) {
+    uint32_t seq;
+    uint64_t ns, offset;
+
+    do {
+        seq = vt->seq;
+        if (seq & 1) {
+            __asm__ volatile("pause");
+            continue;
+        }
+        vdso_barrier();
+        if (vt->clock_mode != VDSO_CLOCK_TSC)
+            return false;
+
+        uint64_t delta = vdso_rdtsc() - vt->tsc_base;
+        ns = vt->mono_base_ns +
+             (uint64_t)(((unsigned __int128)delta * vt->mult) >> vt->shift);
+        offset = vt->realtime_offset_ns;
+        vdso_barrier();
+    } while ((seq & 1) || vt->seq != seq);
+
+    *mono_ns = ns;
+    if (realtime_offset)
+        *realtime_offset = offset;
+    return true;
+}
+
+// kernel side
+void vdso_init(void);           // needs the PMM and VMM, maps the page
+void vdso_update(void);         // after the clocksource or its rate changed
+uint64_t ktime_real_ns(void);   // ns since 1970-01-01 UTC, from the RTC at boot
+
+#endif // VDSO_H
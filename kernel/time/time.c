@@ -44,72 +44,194 @@
 #include "tools/includes/pit.h"
 #include "includes/tsc.h"
 #include "includes/time.h"
+#include "tools/includes/log-info.h"
+#include "includes/clocksource.h"
+#include "includes/vdso.h"
+#include "includes/tsc_sync.h"
+#include "drivers/hpet/includes/hpet.h"
+#include <stdio.h>
 
-t_delay_mode microdelay_mode = TSC_DELAY;
+// ktime_ns() reads the TSC directly while it is the clocksource, the common
+// case, and goes through the clocksource layer otherwise
+bool time_uses_tsc = true;
 
-// Get milliseconds since kernel entry (boot time)
+clock_scale_t tsc_to_ns;
+clock_scale_t tsc_to_us;
+clock_scale_t tsc_to_ms;
+clock_scale_t tsc_from_us;
+
+static void time_set_tsc_scales(void) {
+    tsc_to_ns = clock_scale_make(CPU_clock_speed, 1000000000);
+    tsc_to_us = clock_scale_make(CPU_clock_speed, 1000000);
+    tsc_to_ms = clock_scale_make(CPU_clock_speed, 1000);
+    tsc_from_us = clock_scale_make(1000000, CPU_clock_speed);
+}
+
+static uint64_t tsc_clocksource_read(void) {
+    return read_tsc_synced();
+}
+
+static uint64_t pit_clocksource_read(void) {
+    return (uint16_t)(0 - pit_read_channel2());     // counts down, make it count up
+}
+
+clocksource_t tsc_clocksource = {
+    .name = "tsc",
+    .rating = 300,
+    .mask = UINT64_MAX,
+    .read = tsc_clocksource_read,
+};
+
+static clocksource_t pit_clocksource = {
+    .name = "pit",
+    .rating = 110,
+    .freq_hz = PIT_FREQ,
+    .mask = 0xFFFF,
+    .read = pit_clocksource_read,
+};
+
+static clocksource_t hpet_clocksource = {
+    .name = "hpet",
+    .rating = 250,
+    .mask = UINT64_MAX,
+    .read = hpet_read_counter,
+};
+
+// the PIT clocksource is always registered after the TSC (when there is one),
+// so its arrival does not rebase ktime_ns() away from kernel entry
+static void time_register_pit(void) {
+    if (!pit_get_is_legit())
+        return;
+    pit_channel2_start();
+    clocksource_register(&pit_clocksource);
+}
+
+// Calibrate the TSC once and precompute the conversions the getters below use,
+// then register the TSC and PIT as clocksources
+int8_t time_init(void) {
+    if (!cpu_has_tsc() || set_CPU_clock_speed() != 0) {
+        LOG_WARN("TSC calibration failed, falling back to slower clocksources\n");
+        SERIAL(Warn, time_init, "TSC calibration failed, falling back to slower clocksources\n");
+        time_register_pit();
+        return -1;
+    }
+
+    time_set_tsc_scales();
+    tsc_clocksource.freq_hz = CPU_clock_speed;
+    // a TSC that changes rate with P-states gets checked against another source
+    if (!tsc_invariant)
+        tsc_clocksource.flags |= CLOCKSOURCE_MUST_VERIFY;
+
+    LOG_INFO("TSC runs at %lu kHz (from %s%s)\n", CPU_clock_speed / 1000,
+             tsc_source_name(tsc_source), tsc_invariant ? ", invariant" : "");
+    SERIAL(Info, time_init, "TSC runs at %lu kHz (from %s%s)\n", CPU_clock_speed / 1000,
+           tsc_source_name(tsc_source), tsc_invariant ? ", invariant" : "");
+    if (!tsc_invariant) {
+        LOG_WARN("TSC is not invariant, timestamps may drift with CPU frequency\n");
+        SERIAL(Warn, time_init, "TSC is not invariant, timestamps may drift with CPU frequency\n");
+    }
+
+    clocksource_register(&tsc_clocksource);
+    time_register_pit();
+    tsc_sync_init();
+    return 0;
+}
+
+#define TIME_HPET_CALIBRATION_MS 50
+
+// Bring up the HPET and, if the TSC rate was only guessed from the PIT, measure
+// it again against the HPET, which is ~12x finer and not subject to port I/O
+// latency. boot_tsc is moved so ktime_ns() carries on from where it was
+int8_t time_hpet_init(void) {
+    if (hpet_init() != 0)
+        return -1;
+
+    hpet_clocksource.freq_hz = hpet_frequency();
+    // the driver extends a 32-bit counter, but only if read once per wrap
+    if (!hpet_counter_is_64bit())
+        hpet_clocksource.mask = 0xFFFFFFFF;
+    clocksource_register(&hpet_clocksource);
+
+    if (!cpu_has_tsc() || (tsc_source != TSC_SOURCE_PIT && tsc_source != TSC_SOURCE_NONE))
+        return 0;
+
+    uint64_t hz = hpet_measure_tsc_hz(TIME_HPET_CALIBRATION_MS);
+    if (hz == 0)
+        return 0;
+
+    uint64_t elapsed_us = ktime_ns() / 1000;
+    uint64_t now = read_tsc_synced();
+    uint64_t old_hz = CPU_clock_speed;
+
+    CPU_clock_speed = hz;
+    tsc_source = TSC_SOURCE_HPET;
+    time_set_tsc_scales();
+    clocksource_update_freq(&tsc_clocksource, hz);
+    if (time_uses_tsc)
+        boot_tsc = now - clock_scale_apply(tsc_from_us, elapsed_us);
+    vdso_update();
+
+    LOG_INFO("TSC recalibrated against the HPET: %lu kHz (PIT said %lu kHz)\n", hz / 1000, old_hz / 1000);
+    SERIAL(Info, time_hpet_init, "TSC recalibrated against the HPET: %lu kHz (PIT said %lu kHz)\n", hz / 1000, old_hz / 1000);
+    return 0;
+}
+
+// Get nanoseconds since kernel entry (boot time)
+uint64_t ktime_ns(void) {
+    if (!time_uses_tsc)
+        return clocksource_ns();
+    return clock_scale_apply(tsc_to_ns, read_tsc_synced() - boot_tsc);
+}
+
+// Get milliseconds since kernel entry, wraps after ~49 days
 uint32_t get_time_ms(void) {
-    int8_t error = set_CPU_clock_speed();
-
-    if (error || boot_tsc == 0)
-        return 0; // Error: CPU clock speed not set or boot TSC not captured
-    
-    uint64_t current_tsc = read_tsc_fast();
-    uint64_t elapsed_tsc = current_tsc - boot_tsc;
-    
-    // Convert TSC ticks to milliseconds
-    uint64_t ms = (elapsed_tsc * 1000) / CPU_clock_speed;
-    return (uint32_t)ms;
+    if (!time_uses_tsc)
+        return (uint32_t)(clocksource_ns() / 1000000);
+    return (uint32_t)clock_scale_apply(tsc_to_ms, read_tsc_synced() - boot_tsc);
 }
 
 // Get milliseconds with fractional precision
 double get_time_ms_fp(void) {
-    int8_t error = set_CPU_clock_speed();
-    if (error || boot_tsc == 0)
-        return 0.0;
-
-    uint64_t current_tsc = read_tsc_fast();
-    uint64_t elapsed_tsc = current_tsc - boot_tsc;
-    
-    double seconds = (double)elapsed_tsc / CPU_clock_speed;
-    return seconds * 1000.0;
+    return (double)ktime_ns() * 1e-6;
 }
 
-// Get microseconds since kernel entry
+// Get microseconds since kernel entry, wraps after ~71 minutes
 uint32_t get_time_us(void) {
-    int8_t error = set_CPU_clock_speed();
-
-    if (error || boot_tsc == 0)
-        return 0;
-    
-    uint64_t current_tsc = read_tsc_fast();
-    uint64_t elapsed_tsc = current_tsc - boot_tsc;
-    
-    uint64_t cycles_per_us = CPU_clock_speed / 1000000;
-    return (uint32_t)(elapsed_tsc / cycles_per_us);
+    if (!time_uses_tsc)
+        return (uint32_t)(clocksource_ns() / 1000);
+    return (uint32_t)clock_scale_apply(tsc_to_us, read_tsc_synced() - boot_tsc);
 }
 
+// Busy-wait on the current clocksource. Only the PIT one-shot is left when
+// nothing registered, which is before time_init()
 int8_t udelay(uint32_t micros) {
-    if (microdelay_mode == PIT_DELAY && !pit_get_is_legit()) {
-        microdelay_mode = TSC_DELAY;
-    }
-    if (microdelay_mode == TSC_DELAY && !cpu_has_tsc()) {
-        microdelay_mode = HPET_DELAY;
+    clocksource_t *cs = clocksource_current();
+
+    if (cs == NULL) {
+        pit_delay_us(micros);
+        return 0;
     }
-    switch (microdelay_mode) {
-        case PIT_DELAY:
-            pit_delay_us(micros); return 0;
-        case PIC_DELAY:
-            return -1;
-        case APIC_DELAY:
-            return -1;
-        case IOAPIC_DELAY:
-            return -1;
-        case TSC_DELAY:
-            return tsc_delay_us(micros);
-        case HPET_DELAY:
-            return -1;
-        default:
-            return -1;
+    clocksource_delay_us(cs, micros);
+    return 0;
+}
+
+// how far a delay of `micros` on this source overshoots, in ns of ktime_ns()
+static int64_t time_delay_error_ns(clocksource_t *cs, uint32_t micros) {
+    uint64_t start = ktime_ns();
+    clocksource_delay_us(cs, micros);
+    return (int64_t)(ktime_ns() - start) - (int64_t)micros * 1000;
+}
+
+// Print read cost, resolution and delay error of every clocksource. Elapsed
+// time comes from the current clocksource, so its own row shows loop overhead
+void time_print_sources(void) {
+    const uint32_t delays[] = { 10, 100, 1000 };
+
+    printf("source  read(cycles)  resolution(ps)  delay error(ns) @10us/100us/1ms\n");
+    for (clocksource_t *cs = clocksource_list(); cs; cs = cs->next) {
+        printf("%-6s  %12u  %14lu ", cs->name, cs->read_cycles, 1000000000000ull / cs->freq_hz);
+        for (size_t d = 0; d < sizeof(delays) / sizeof(delays[0]); d++)
+            printf(" %9ld", time_delay_error_ns(cs, delays[d]));
+        printf("\n");
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,337 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: timer.c
+    Description: Kernel timer module of the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/timer.h"
+#include "includes/time.h"
+#include "includes/clocksource.h"
+#include "arch/x86_64/includes/io.h"
+#include "drivers/pic/includes/apic/apic.h"
+#include "drivers/pic/includes/apic/lapic_timer.h"
+#include "drivers/hpet/includes/hpet.h"
+#include "kernel/system/includes/idle.h"
+#include "kernel/system/includes/percpu.h"
+#include "kernel/sched/includes/sched.h"
+#include "tools/includes/log-info.h"
+#include <stdio.h>
+
+#define TIMER_HPET_TIMER 0
+#define TIMER_HPET_IRQ   49
+
+// how the event device is driven: one-shot at the next expiry (tickless), or
+// a fixed tick when there is no calibrated TSC to tell the time with
+typedef struct {
+    bool online;
+    bool periodic;
+    uint64_t programmed;        // tick the event device is set for, TIMER_NONE if stopped
+    timer_nohz_stats_t nohz;
+} timer_cpu_t;
+
+static timer_wheel_t timer_wheels[TIMER_MAX_CPUS];
+static timer_cpu_t timer_cpus[TIMER_MAX_CPUS];
+static bool timer_use_hpet;
+
+static inline uint32_t timer_cpu(void) {
+    return smp_cpu_id();
+}
+
+// without a calibrated TSC ktime_ns() reads 0, so count interrupts instead
+static uint64_t timer_now_tick(timer_wheel_t *wheel) {
+    if (CPU_clock_speed == 0)
+        return wheel->clk;
+    return ktime_ns() / TIMER_TICK_NS;
+}
+
+// program the event device for `tick`, returns -1 if that is already past.
+// A clocksource that wraps (PM timer, PIT) has to be read at least once per
+// wrap, so sleeps are cut short to clocksource_max_idle_ns() for it
+static int8_t timer_program(timer_cpu_t *cpu, uint64_t tick) {
+    uint64_t max_idle = clocksource_max_idle_ns();
+
+    cpu->programmed = tick;
+    if (tick == TIMER_NONE && max_idle == UINT64_MAX) {
+        cpu->nohz.stopped++;
+        if (timer_use_hpet)
+            hpet_timer_cancel(TIMER_HPET_TIMER);
+        else
+            lapic_timer_stop();
+        return 0;
+    }
+
+    uint64_t deadline = tick == TIMER_NONE ? UINT64_MAX : tick * TIMER_TICK_NS;
+    uint64_t now = ktime_ns();
+    uint64_t delta = deadline > now ? deadline - now : 0;
+    if (delta > max_idle)
+        delta = max_idle;
+
+    cpu->nohz.programmed++;
+    if (timer_use_hpet)
+        return hpet_timer_oneshot(TIMER_HPET_TIMER, delta);
+    return lapic_timer_oneshot_ns(delta);
+}
+
+// interrupts go off before the CPU id is read, a task could be moved otherwise
+void timer_run(void) {
+    uint64_t flags = irq_save();
+    uint32_t id = timer_cpu();
+    timer_wheel_t *wheel = &timer_wheels[id];
+    timer_cpu_t *cpu = &timer_cpus[id];
+
+    timer_wheel_advance(wheel, timer_now_tick(wheel));
+    if (!cpu->periodic) {
+        // the HPET refuses deadlines that passed while we were programming it
+        while (timer_program(cpu, timer_wheel_next(wheel)) != 0)
+            timer_wheel_advance(wheel, timer_now_tick(wheel));
+    }
+    irq_restore(flags);
+}
+
+static void timer_event(Registers_t *regs) {
+    (void)regs;
+    timer_cpu_t *cpu = &timer_cpus[timer_cpu()];
+
+    cpu->nohz.interrupts++;
+    if (!cpu->periodic && cpu->programmed != TIMER_NONE) {
+        uint64_t now = ktime_ns();
+        uint64_t deadline = cpu->programmed * TIMER_TICK_NS;
+        uint64_t late = now > deadline ? now - deadline : 0;
+        cpu->nohz.latency_sum_ns += late;
+        if (late > cpu->nohz.latency_max_ns)
+            cpu->nohz.latency_max_ns = late;
+    }
+    if (timer_use_hpet && cpu->periodic)
+        hpet_timer_oneshot(TIMER_HPET_TIMER, TIMER_TICK_NS);
+    timer_run();
+}
+
+int8_t timer_subsystem_init(void) {
+    uint32_t id = timer_cpu();
+    timer_wheel_t *wheel = &timer_wheels[id];
+    timer_cpu_t *cpu = &timer_cpus[id];
+
+    timer_wheel_init(wheel, 0);
+    wheel->clk = timer_now_tick(wheel);
+    cpu->periodic = CPU_clock_speed == 0;
+    cpu->programmed = TIMER_NONE;
+
+    if (lapic_timer_frequency() != 0) {
+        lapic_timer_set_handler(timer_event);
+        if (cpu->periodic)
+            lapic_timer_periodic_ns(TIMER_TICK_NS);
+    } else if (hpet_timer_setup(TIMER_HPET_TIMER, TIMER_HPET_IRQ, timer_event) == 0) {
+        timer_use_hpet = true;
+        if (cpu->periodic)
+            hpet_timer_oneshot(TIMER_HPET_TIMER, TIMER_TICK_NS);
+    } else {
+        LOG_WARN("No timer interrupt source, kernel timers will not fire\n");
+        SERIAL(Warn, timer_subsystem_init, "No timer interrupt source, kernel timers will not fire\n");
+        return -1;
+    }
+    cpu->online = true;
+
+    LOG_INFO("Timer wheel on CPU %u, %u us ticks from the %s, %s\n", id, TIMER_TICK_NS / 1000,
+             timer_use_hpet ? "HPET" : "LAPIC timer", cpu->periodic ? "periodic" : "tickless");
+    SERIAL(Info, timer_subsystem_init, "Timer wheel on CPU %u, %u us ticks from the %s, %s\n", id, TIMER_TICK_NS / 1000,
+           timer_use_hpet ? "HPET" : "LAPIC timer", cpu->periodic ? "periodic" : "tickless");
+    return 0;
+}
+
+timer_nohz_stats_t *timer_nohz_stats(uint32_t cpu) {
+    return &timer_cpus[cpu % TIMER_MAX_CPUS].nohz;
+}
+
+// what the idle governor can count on sleeping for, a wrapping clocksource
+// still cuts it short to clocksource_max_idle_ns()
+uint64_t timer_next_event_ns(void) {
+    uint64_t flags = irq_save();
+    timer_cpu_t *cpu = &timer_cpus[timer_cpu()];
+    uint64_t next;
+
+    if (!cpu->online)
+        next = UINT64_MAX;
+    else if (cpu->periodic)
+        next = (ktime_ns() / TIMER_TICK_NS + 1) * TIMER_TICK_NS;
+    else if (cpu->programmed == TIMER_NONE)
+        next = UINT64_MAX;
+    else
+        next = cpu->programmed * TIMER_TICK_NS;
+    irq_restore(flags);
+
+    uint64_t max_idle = clocksource_max_idle_ns();
+    if (max_idle != UINT64_MAX) {
+        uint64_t now = ktime_ns();
+        if (next > now && next - now > max_idle)
+            next = now + max_idle;
+    }
+    return next;
+}
+
+void timer_setup(ktimer_t *timer, timer_fn_t fn, void *arg) {
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->expires = 0;
+    timer->fn = fn;
+    timer->arg = arg;
+    timer->wheel = NULL;
+}
+
+// round up, a timer never fires before its deadline
+static inline uint64_t timer_ns_to_tick(uint64_t ns) {
+    return (ns + TIMER_TICK_NS - 1) / TIMER_TICK_NS;
+}
+
+bool mod_timer(ktimer_t *timer, uint64_t deadline_ns) {
+    uint64_t flags = irq_save();
+    uint32_t id = timer_cpu();
+    timer_cpu_t *cpu = &timer_cpus[id];
+    bool was_pending = timer_pending(timer);
+
+    timer->expires = timer_ns_to_tick(deadline_ns);
+    timer_wheel_add(&timer_wheels[id], timer);
+
+    // only an earlier deadline needs the event device moved, a cancelled or
+    // later one just costs a spurious wakeup
+    if (cpu->online && !cpu->periodic && timer->expires < cpu->programmed) {
+        if (timer_program(cpu, timer->expires) != 0) {
+            irq_restore(flags);
+            timer_run();
+            return was_pending;
+        }
+    }
+    irq_restore(flags);
+    return was_pending;
+}
+
+int8_t timer_add(ktimer_t *timer, uint64_t deadline_ns, timer_fn_t fn, void *arg) {
+    if (fn == NULL)
+        return -1;
+    timer_setup(timer, fn, arg);
+    mod_timer(timer, deadline_ns);
+    return 0;
+}
+
+bool timer_cancel(ktimer_t *timer) {
+    uint64_t flags = irq_save();
+    bool was_pending = timer_wheel_del(timer);
+    irq_restore(flags);
+    return was_pending;
+}
+
+typedef struct {
+    task_t *task;               // NULL when halting instead of blocking
+    volatile bool done;
+} timer_sleeper_t;
+
+// the sleeper is on the waiting task's stack, which is gone as soon as it
+// sees done, so the task is read first
+static void timer_wake(void *arg) {
+    timer_sleeper_t *sleeper = arg;
+    task_t *task = sleeper->task;
+
+    __atomic_store_n(&sleeper->done, true, __ATOMIC_RELEASE);
+    if (task != NULL)
+        sched_wake(task);
+}
+
+// Block until ktime_ns() reaches deadline_ns, so the CPU can run something
+// else. Before the scheduler is up the CPU halts instead, and it spins before
+// the timer subsystem is up on this CPU or with interrupts off, since nothing
+// would wake us then
+static void timer_sleep_until(uint64_t deadline_ns) {
+    if (!timer_cpus[timer_cpu()].online || !are_interrupts_enabled()) {
+        while (ktime_ns() < deadline_ns)
+            __asm__ volatile("pause");
+        return;
+    }
+
+    timer_sleeper_t sleeper = { .task = sched_active() ? current_task() : NULL, .done = false };
+    ktimer_t timer;
+    timer_add(&timer, deadline_ns, timer_wake, &sleeper);
+
+    if (sleeper.task == NULL) {
+        while (!sleeper.done)
+            cpu_idle();
+        return;
+    }
+    for (;;) {
+        sched_prepare_block();
+        if (__atomic_load_n(&sleeper.done, __ATOMIC_ACQUIRE)) {
+            sched_cancel_block();
+            break;
+        }
+        schedule();
+    }
+}
+
+void msleep(uint32_t ms) {
+    timer_sleep_until(ktime_ns() + (uint64_t)ms * 1000000);
+}
+
+void usleep_range(uint32_t min_us, uint32_t max_us) {
+    uint64_t now = ktime_ns();
+    uint64_t earliest = now + (uint64_t)min_us * 1000;
+    uint64_t latest = now + (uint64_t)max_us * 1000;
+
+    // timers only fire on tick boundaries, spin if the next one is too late
+    if (timer_ns_to_tick(earliest) * TIMER_TICK_NS > latest) {
+        udelay(min_us);
+        return;
+    }
+    timer_sleep_until(earliest);
+}
+
+void timer_print_stats(void) {
+    printf("cpu  pending      added  cancelled    expired   cascaded  max late(ms)\n");
+    for (uint32_t id = 0; id < TIMER_MAX_CPUS; id++) {
+        if (!timer_cpus[id].online)
+            continue;
+        timer_wheel_stats_t *s = &timer_wheels[id].stats;
+        printf("%3u  %7lu  %9lu  %9lu  %9lu  %9lu  %12lu\n", id, s->pending, s->added,
+               s->cancelled, s->expired, s->cascaded, s->max_late_ticks);
+    }
+
+    printf("cpu  mode      interrupts  programmed  stopped  latency avg/max(ns)\n");
+    for (uint32_t id = 0; id < TIMER_MAX_CPUS; id++) {
+        timer_cpu_t *cpu = &timer_cpus[id];
+        if (!cpu->online)
+            continue;
+        uint64_t fired = cpu->nohz.interrupts ? cpu->nohz.interrupts : 1;
+        printf("%3u  %-8s  %10lu  %10lu  %7lu  %lu/%lu\n", id, cpu->periodic ? "periodic" : "tickless",
+               cpu->nohz.interrupts, cpu->nohz.programmed, cpu->nohz.stopped,
+               cpu->nohz.latency_sum_ns / fired, cpu->nohz.latency_max_ns);
+    }
+}
@@ -0,0 +1,203 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: timer_wheel.c
+    Description: Kernel timer module of the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/timer.h"
+#include <string.h>
+
+#define TIMER_TV1_MASK (TIMER_TV1_SIZE - 1)
+#define TIMER_TVN_MASK (TIMER_TVN_SIZE - 1)
+
+// slot of `tick` in level n of the upper wheels
+#define TIMER_TVN_INDEX(tick, n) \
+    (((tick) >> (TIMER_TV1_BITS + (n) * TIMER_TVN_BITS)) & TIMER_TVN_MASK)
+
+void timer_wheel_init(timer_wheel_t *wheel, uint64_t now_tick) {
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->clk = now_tick;
+}
+
+static void timer_list_push(ktimer_t **head, ktimer_t *timer) {
+    timer->next = *head;
+    if (*head)
+        (*head)->pprev = &timer->next;
+    *head = timer;
+    timer->pprev = head;
+}
+
+static void timer_list_unlink(ktimer_t *timer) {
+    *timer->pprev = timer->next;
+    if (timer->next)
+        timer->next->pprev = timer->pprev;
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+// pick the slot from how far away the expiry is, not from where it is
+static ktimer_t **timer_wheel_slot(timer_wheel_t *wheel, uint64_t expires) {
+    if ((int64_t)(expires - wheel->clk) < 0)
+        return &wheel->tv1[wheel->clk & TIMER_TV1_MASK];   // overdue, run next tick
+
+    uint64_t delta = expires - wheel->clk;
+    if (delta < TIMER_TV1_SIZE)
+        return &wheel->tv1[expires & TIMER_TV1_MASK];
+
+    if (delta > TIMER_MAX_TICKS)
+        expires = wheel->clk + TIMER_MAX_TICKS;   // cascades back up until it is in range
+    for (uint32_t n = 0; n < TIMER_TVN_LEVELS - 1; n++) {
+        if (delta < 1ull << (TIMER_TV1_BITS + (n + 1) * TIMER_TVN_BITS))
+            return &wheel->tvn[n][TIMER_TVN_INDEX(expires, n)];
+    }
+    return &wheel->tvn[TIMER_TVN_LEVELS - 1][TIMER_TVN_INDEX(expires, TIMER_TVN_LEVELS - 1)];
+}
+
+void timer_wheel_add(timer_wheel_t *wheel, ktimer_t *timer) {
+    if (timer->pprev) {
+        timer_list_unlink(timer);
+        timer->wheel->stats.pending--;
+    }
+    timer->wheel = wheel;
+    timer_list_push(timer_wheel_slot(wheel, timer->expires), timer);
+    wheel->stats.added++;
+    wheel->stats.pending++;
+}
+
+bool timer_wheel_del(ktimer_t *timer) {
+    if (!timer->pprev)
+        return false;
+    timer_list_unlink(timer);
+    timer->wheel->stats.cancelled++;
+    timer->wheel->stats.pending--;
+    return true;
+}
+
+// re-file every timer of one upper slot, returns the slot index so the caller
+// knows whether the next level wrapped as well
+static uint32_t timer_wheel_cascade(timer_wheel_t *wheel, uint32_t level) {
+    uint32_t index = TIMER_TVN_INDEX(wheel->clk, level);
+    ktimer_t *list = wheel->tvn[level][index];
+
+    wheel->tvn[level][index] = NULL;
+    while (list) {
+        ktimer_t *timer = list;
+        list = timer->next;
+        timer_list_push(timer_wheel_slot(wheel, timer->expires), timer);
+        wheel->stats.cascaded++;
+    }
+    return index;
+}
+
+static uint64_t timer_list_earliest(ktimer_t *list) {
+    uint64_t earliest = TIMER_NONE;
+    for (; list; list = list->next) {
+        if (list->expires < earliest)
+            earliest = list->expires;
+    }
+    return earliest;
+}
+
+// Slots of a level are in deadline order starting after the current one, so
+// only the first non-empty slot of each level has to be looked into. The
+// current slot of an upper level comes last, it was already cascaded and
+// anything there is a whole revolution away
+uint64_t timer_wheel_next(timer_wheel_t *wheel) {
+    uint64_t next = TIMER_NONE;
+
+    if (wheel->stats.pending == 0)
+        return next;
+
+    for (uint32_t i = 0; i < TIMER_TV1_SIZE; i++) {
+        ktimer_t *list = wheel->tv1[(wheel->clk + i) & TIMER_TV1_MASK];
+        if (list) {
+            next = timer_list_earliest(list);
+            break;
+        }
+    }
+
+    for (uint32_t n = 0; n < TIMER_TVN_LEVELS; n++) {
+        uint32_t current = TIMER_TVN_INDEX(wheel->clk, n);
+        for (uint32_t k = 1; k <= TIMER_TVN_SIZE; k++) {
+            ktimer_t *list = wheel->tvn[n][(current + k) & TIMER_TVN_MASK];
+            if (list) {
+                uint64_t earliest = timer_list_earliest(list);
+                if (earliest < next)
+                    next = earliest;
+                break;
+            }
+        }
+    }
+    return next;
+}
+
+void timer_wheel_advance(timer_wheel_t *wheel, uint64_t now_tick) {
+    // nothing can cascade or expire, so after a long idle stretch skip
+    // straight to now instead of walking every tick
+    if (wheel->stats.pending == 0) {
+        if ((int64_t)(now_tick - wheel->clk) >= 0)
+            wheel->clk = now_tick + 1;
+        return;
+    }
+
+    while ((int64_t)(now_tick - wheel->clk) >= 0) {
+        uint32_t index = wheel->clk & TIMER_TV1_MASK;
+
+        if (index == 0) {
+            for (uint32_t n = 0; n < TIMER_TVN_LEVELS; n++) {
+                if (timer_wheel_cascade(wheel, n) != 0)
+                    break;
+            }
+        }
+
+        // move the slot onto a local list so callbacks can add to the wheel
+        // or cancel timers still waiting on this list
+        ktimer_t *expired = wheel->tv1[index];
+        wheel->tv1[index] = NULL;
+        if (expired)
+            expired->pprev = &expired;
+        uint64_t clk = wheel->clk++;
+
+        while (expired) {
+            ktimer_t *timer = expired;
+            timer_list_unlink(timer);
+            wheel->stats.expired++;
+            wheel->stats.pending--;
+            if ((int64_t)(clk - timer->expires) > (int64_t)wheel->stats.max_late_ticks)
+                wheel->stats.max_late_ticks = clk - timer->expires;
+            timer->fn(timer->arg);
+        }
+    }
+}
@@ -47,6 +47,13 @@
 
 uint64_t CPU_clock_speed = 0; // in hz
 uint64_t boot_tsc = 0;        // TSC value at kernel entry
+tsc_source_t tsc_source = TSC_SOURCE_NONE;
+bool tsc_invariant = false;
+bool tsc_offsets_in_use = false;
+int64_t tsc_cpu_offset[TSC_MAX_CPUS];
+
+#define CPUID_HYPERVISOR_BIT  (1u << 31) // leaf 1 ecx
+#define CPUID_INVARIANT_TSC   (1u << 8)  // leaf 0x80000007 edx
 
 // Measure elapsed TSC ticks over a PIT countdown
 uint64_t measure_tsc_over_pit(uint16_t pit_reload) {
@@ -83,16 +90,155 @@ uint64_t get_cpu_clock_speed_khz(void) {
     return CPU_KHz / 4;
 }
 
-int8_t tsc_delay_us(uint32_t micros) {
-    uint32_t last_recorded_time, start_time;
-    start_time = get_time_us();
-    last_recorded_time = start_time;
-
-    if (start_time == 0)
-        return -1; // Error: CPU clock speed not set
-    
-    while (last_recorded_time != 0 && last_recorded_time-start_time < micros) {
-        last_recorded_time = get_time_us();
+// Intel parts that report a 0x15 ratio but leave the crystal frequency 0
+#define CRYSTAL_24MHZ   24000000    // Skylake/Kaby Lake client
+#define CRYSTAL_25MHZ   25000000    // Skylake server, Atom Denverton
+#define CRYSTAL_19_2MHZ 19200000    // Atom Goldmont
+
+static uint32_t cpu_family_model(void) {
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+
+    uint32_t family = (eax >> 8) & 0xF;
+    uint32_t model = (eax >> 4) & 0xF;
+    if (family == 0x6 || family == 0xF)
+        model |= ((eax >> 16) & 0xF) << 4;
+    if (family == 0xF)
+        family += (eax >> 20) & 0xFF;
+    return (family << 8) | model;
+}
+
+static uint32_t crystal_hz_for_model(void) {
+    switch (cpu_family_model()) {
+        case 0x64E: case 0x65E: case 0x68E: case 0x69E:
+            return CRYSTAL_24MHZ;
+        case 0x655: case 0x65F:
+            return CRYSTAL_25MHZ;
+        case 0x65C:
+            return CRYSTAL_19_2MHZ;
+        default:
+            return 0;
+    }
+}
+
+// TSC frequency in hz as the CPU (or hypervisor) reports it, 0 if it does not
+uint64_t tsc_freq_from_cpuid(tsc_source_t *source) {
+    uint32_t eax, ebx, ecx, edx;
+    uint32_t max_leaf;
+
+    *source = TSC_SOURCE_NONE;
+    cpuid(0, 0, &max_leaf, &ebx, &ecx, &edx);
+
+    // hypervisors that expose the timing leaf know the host TSC rate exactly,
+    // while 0x15/0x16 inside a guest are often zero or describe the wrong part
+    cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+    if (ecx & CPUID_HYPERVISOR_BIT) {
+        uint32_t max_hv_leaf;
+        cpuid(0x40000000, 0, &max_hv_leaf, &ebx, &ecx, &edx);
+        if (max_hv_leaf >= 0x40000010 && max_hv_leaf < 0x40010000) {
+            cpuid(0x40000010, 0, &eax, &ebx, &ecx, &edx);
+            if (eax) {
+                *source = TSC_SOURCE_HYPERVISOR;
+                return (uint64_t)eax * 1000;
+            }
+        }
+    }
+
+    // TSC = crystal * ebx / eax
+    if (max_leaf >= 0x15) {
+        uint32_t denominator, numerator, crystal_hz;
+        cpuid(0x15, 0, &denominator, &numerator, &crystal_hz, &edx);
+        if (denominator && numerator) {
+            if (!crystal_hz && max_leaf >= 0x16) {
+                // derive the crystal from the base frequency the CPU reports
+                cpuid(0x16, 0, &eax, &ebx, &ecx, &edx);
+                crystal_hz = (uint64_t)eax * 1000000 * denominator / numerator;
+            }
+            if (!crystal_hz)
+                crystal_hz = crystal_hz_for_model();
+            if (crystal_hz) {
+                *source = TSC_SOURCE_CRYSTAL;
+                return (uint64_t)crystal_hz * numerator / denominator;
+            }
+        }
+    }
+
+    // the nominal base frequency, which the TSC runs at on Intel parts
+    if (max_leaf >= 0x16) {
+        cpuid(0x16, 0, &eax, &ebx, &ecx, &edx);
+        if (eax & 0xFFFF) {
+            *source = TSC_SOURCE_BASE_FREQ;
+            return (uint64_t)(eax & 0xFFFF) * 1000000;
+        }
+    }
+
+    return 0;
+}
+
+bool tsc_is_invariant(void) {
+    uint32_t max_ext, ebx, ecx, edx;
+
+    cpuid(0x80000000, 0, &max_ext, &ebx, &ecx, &edx);
+    if (max_ext < 0x80000007)
+        return false;
+
+    uint32_t eax;
+    cpuid(0x80000007, 0, &eax, &ebx, &ecx, &edx);
+    return (edx & CPUID_INVARIANT_TSC) != 0;
+}
+
+const char *tsc_source_name(tsc_source_t source) {
+    switch (source) {
+        case TSC_SOURCE_HYPERVISOR: return "CPUID 0x40000010";
+        case TSC_SOURCE_CRYSTAL:    return "CPUID 0x15";
+        case TSC_SOURCE_BASE_FREQ:  return "CPUID 0x16";
+        case TSC_SOURCE_PIT:        return "PIT";
+        case TSC_SOURCE_HPET:       return "HPET";
+        default:                    return "none";
     }
-    return last_recorded_time == 0 ? -1 : 0;
+}
+
+#define TSC_CALIBRATION_SAMPLES 5
+
+int8_t set_CPU_clock_speed(void) {
+    uint64_t samples[TSC_CALIBRATION_SAMPLES];
+
+    if (CPU_clock_speed != 0)
+        return 0; // Already set
+
+    tsc_invariant = tsc_is_invariant();
+
+    // no busy-waiting at all when the CPU just tells us
+    CPU_clock_speed = tsc_freq_from_cpuid(&tsc_source);
+    if (CPU_clock_speed != 0)
+        return 0;
+
+    // take the median, one PIT read delayed by an SMI or a slow emulator
+    // should not skew every timestamp for the rest of the boot
+    for (int i = 0; i < TSC_CALIBRATION_SAMPLES; i++) {
+        samples[i] = get_cpu_clock_speed_khz();
+        if (samples[i] == 0)
+            return -1;
+    }
+    for (int i = 1; i < TSC_CALIBRATION_SAMPLES; i++)
+        for (int j = i; j > 0 && samples[j - 1] > samples[j]; j--) {
+            uint64_t t = samples[j];
+            samples[j] = samples[j - 1];
+            samples[j - 1] = t;
+        }
+
+    CPU_clock_speed = samples[TSC_CALIBRATION_SAMPLES / 2] * 1000; // in hz
+    tsc_source = TSC_SOURCE_PIT;
+    return 0; // Success
+}
+
+int8_t tsc_delay_us(uint32_t micros) {
+    if (tsc_from_us.mult == 0)
+        return -1; // Error: TSC not calibrated yet
+
+    uint64_t start = read_tsc_fast();
+    uint64_t cycles = clock_scale_apply(tsc_from_us, micros);
+
+    while (read_tsc_fast() - start < cycles);
+    return 0;
 }
\ No newline at end of file
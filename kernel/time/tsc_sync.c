@@ -0,0 +1,259 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: tsc_sync.c
+    Description: Cross-CPU TSC synchronization for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/tsc_sync.h"
+#include "includes/tsc.h"
+#include "includes/time.h"
+#include "includes/clocksource.h"
+#include "includes/vdso.h"
+#include "arch/x86_64/includes/io.h"
+#include "tools/includes/log-info.h"
+#include <stdio.h>
+
+#define CPUID_7_EBX_TSC_ADJUST   (1u << 1)
+#define CPUID_EXT_EDX_RDTSCP     (1u << 27)
+
+extern clocksource_t tsc_clocksource;
+
+static bool sync_enabled;
+static bool has_tsc_adjust;
+static bool has_rdtscp;
+static int64_t bsp_tsc_adjust;
+
+typedef enum {
+    TSC_SYNC_OK,
+    TSC_SYNC_ADJUST,        // target applies sync_delta and the test runs again
+    TSC_SYNC_FAIL,
+} tsc_sync_verdict_t;
+
+typedef enum {
+    ROLE_SOURCE = 1,
+    ROLE_TARGET = 2,
+} tsc_sync_role_t;
+
+// shared between the two CPUs of one check
+static volatile uint32_t sync_arrived;     // only ever grows, two arrivals per rendezvous
+static volatile uint32_t sync_lock;
+static volatile uint64_t sync_last_tsc;
+static volatile uint32_t sync_last_role;
+static volatile uint64_t sync_target_behind;   // largest warp seen by each side
+static volatile uint64_t sync_target_ahead;
+static volatile uint64_t sync_self_warp;       // a CPU going backwards on its own
+static volatile uint32_t sync_verdict;
+static volatile int64_t sync_delta;
+
+static inline int64_t msr_read(uint32_t msr) {
+    uint32_t lo, hi;
+    cpuGetMSR(msr, &lo, &hi);
+    return (int64_t)(((uint64_t)hi << 32) | lo);
+}
+
+static inline void msr_write(uint32_t msr, int64_t value) {
+    cpuSetMSR(msr, (uint32_t)value, (uint32_t)((uint64_t)value >> 32));
+}
+
+// rdtsc can run ahead of earlier loads without the fence, which shows up as
+// a bogus warp of a few cycles
+static inline uint64_t rdtsc_ordered(uint32_t cpu) {
+    uint32_t lo, hi;
+    asm volatile("lfence; rdtsc" : "=a"(lo), "=d"(hi) :: "memory");
+    return (((uint64_t)hi << 32) | lo) + tsc_cpu_offset[cpu];
+}
+
+// two-CPU barrier, whoever arrives first waits for the other
+static void sync_rendezvous(void) {
+    uint32_t n = __atomic_add_fetch(&sync_arrived, 1, __ATOMIC_ACQ_REL);
+    uint32_t target = (n + 1) & ~1u;
+    while (__atomic_load_n(&sync_arrived, __ATOMIC_ACQUIRE) < target)
+        asm volatile("pause");
+}
+
+static inline void sync_lock_take(void) {
+    while (__atomic_exchange_n(&sync_lock, 1, __ATOMIC_ACQUIRE))
+        while (__atomic_load_n(&sync_lock, __ATOMIC_RELAXED))
+            asm volatile("pause");
+}
+
+static inline void sync_lock_drop(void) {
+    __atomic_store_n(&sync_lock, 0, __ATOMIC_RELEASE);
+}
+
+static inline void sync_record(volatile uint64_t *slot, uint64_t warp) {
+    if (warp > *slot)
+        *slot = warp;
+}
+
+static void tsc_warp_check(uint32_t cpu, tsc_sync_role_t role) {
+    uint64_t cycles = CPU_clock_speed / 1000 * TSC_SYNC_TEST_MS;
+    uint64_t end = rdtsc_ordered(cpu) + cycles;
+
+    for (;;) {
+        sync_lock_take();
+        uint64_t prev = sync_last_tsc;
+        uint32_t prev_role = sync_last_role;
+        uint64_t now = rdtsc_ordered(cpu);
+        sync_last_tsc = now;
+        sync_last_role = role;
+
+        if (now < prev) {
+            uint64_t warp = prev - now;
+            if (prev_role == role)
+                sync_record(&sync_self_warp, warp);
+            else if (role == ROLE_TARGET)
+                sync_record(&sync_target_behind, warp);
+            else
+                sync_record(&sync_target_ahead, warp);
+        }
+        sync_lock_drop();
+
+        if (now > end)
+            break;
+    }
+}
+
+static void tsc_sync_apply(uint32_t cpu, int64_t delta) {
+    if (has_tsc_adjust) {
+        msr_write(MSR_IA32_TSC_ADJUST, msr_read(MSR_IA32_TSC_ADJUST) + delta);
+        return;
+    }
+    tsc_cpu_offset[cpu] += delta;
+    tsc_offsets_in_use = true;
+}
+
+void tsc_sync_init(void) {
+    uint32_t eax, ebx, ecx, edx, max_leaf;
+
+    if (!cpu_has_tsc() || CPU_clock_speed == 0)
+        return;
+
+    cpuid(0, 0, &max_leaf, &ebx, &ecx, &edx);
+    if (max_leaf >= 7) {
+        cpuid(7, 0, &eax, &ebx, &ecx, &edx);
+        has_tsc_adjust = ebx & CPUID_7_EBX_TSC_ADJUST;
+    }
+    cpuid(0x80000000, 0, &max_leaf, &ebx, &ecx, &edx);
+    if (max_leaf >= 0x80000001) {
+        cpuid(0x80000001, 0, &eax, &ebx, &ecx, &edx);
+        has_rdtscp = edx & CPUID_EXT_EDX_RDTSCP;
+    }
+
+    if (has_rdtscp)
+        msr_write(MSR_IA32_TSC_AUX, 0);
+    if (has_tsc_adjust) {
+        bsp_tsc_adjust = msr_read(MSR_IA32_TSC_ADJUST);
+        if (bsp_tsc_adjust != 0) {
+            LOG_WARN("Firmware left IA32_TSC_ADJUST at %ld on the boot CPU\n", bsp_tsc_adjust);
+            SERIAL(Warn, tsc_sync_init, "Firmware left IA32_TSC_ADJUST at %ld on the boot CPU\n", bsp_tsc_adjust);
+        }
+    }
+    sync_enabled = true;
+}
+
+void tsc_sync_target(uint32_t cpu) {
+    if (!sync_enabled || cpu >= TSC_MAX_CPUS)
+        return;
+
+    if (has_rdtscp)
+        msr_write(MSR_IA32_TSC_AUX, cpu);
+    // firmware often writes TSC_ADJUST per socket, start from the BSP's value
+    if (has_tsc_adjust && msr_read(MSR_IA32_TSC_ADJUST) != bsp_tsc_adjust)
+        msr_write(MSR_IA32_TSC_ADJUST, bsp_tsc_adjust);
+
+    for (;;) {
+        sync_rendezvous();
+        tsc_warp_check(cpu, ROLE_TARGET);
+        sync_rendezvous();
+        sync_rendezvous();      // source has decided
+        if (sync_verdict != TSC_SYNC_ADJUST)
+            return;
+        tsc_sync_apply(cpu, sync_delta);
+    }
+}
+
+void tsc_sync_source(uint32_t cpu) {
+    if (!sync_enabled || cpu >= TSC_MAX_CPUS)
+        return;
+
+    bool can_correct = has_tsc_adjust || has_rdtscp;
+    int64_t total = 0;
+
+    for (uint32_t attempt = 0;; attempt++) {
+        sync_last_tsc = 0;
+        sync_last_role = 0;
+        sync_target_behind = 0;
+        sync_target_ahead = 0;
+        sync_self_warp = 0;
+
+        sync_rendezvous();
+        tsc_warp_check(0, ROLE_SOURCE);
+        sync_rendezvous();
+
+        uint64_t behind = sync_target_behind, ahead = sync_target_ahead;
+        if (behind == 0 && ahead == 0 && sync_self_warp == 0) {
+            sync_verdict = TSC_SYNC_OK;
+        } else if (sync_self_warp || (behind && ahead) || !can_correct ||
+                   attempt == TSC_SYNC_RETRIES) {
+            sync_verdict = TSC_SYNC_FAIL;
+        } else {
+            // a warp only bounds the skew from below, retesting closes the rest
+            sync_delta = behind ? (int64_t)behind : -(int64_t)ahead;
+            total += sync_delta;
+            sync_verdict = TSC_SYNC_ADJUST;
+        }
+        sync_rendezvous();
+
+        if (sync_verdict == TSC_SYNC_OK) {
+            if (total) {
+                LOG_INFO("TSC on CPU %u was %ld cycles off, corrected through %s\n", cpu, -total,
+                         has_tsc_adjust ? "IA32_TSC_ADJUST" : "a per-CPU offset");
+                SERIAL(Info, tsc_sync_source, "TSC on CPU %u was %ld cycles off, corrected through %s\n", cpu, -total,
+                       has_tsc_adjust ? "IA32_TSC_ADJUST" : "a per-CPU offset");
+                vdso_update();  // user space cannot apply per-CPU offsets
+            }
+            return;
+        }
+        if (sync_verdict == TSC_SYNC_FAIL) {
+            LOG_WARN("TSC on CPU %u warps by up to %lu cycles against CPU 0\n", cpu,
+                     behind > ahead ? behind : ahead);
+            SERIAL(Warn, tsc_sync_source, "TSC on CPU %u warps by up to %lu cycles against CPU 0 (self %lu)\n", cpu,
+                   behind > ahead ? behind : ahead, (uint64_t)sync_self_warp);
+            clocksource_mark_unstable(&tsc_clocksource, "TSCs are not synchronized across CPUs");
+            return;
+        }
+    }
+}
@@ -0,0 +1,114 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: vdso.c
+    Description: Shared user-space time page for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/vdso.h"
+#include "includes/time.h"
+#include "includes/tsc.h"
+#include "mm/includes/pmm.h"
+#include "mm/includes/vmm.h"
+#include "drivers/rtc/includes/rtc.h"
+#include "tools/includes/log-info.h"
+#include "kernel/system/includes/spinlock.h"
+#include <string.h>
+#include <stdio.h>
+
+extern bool time_uses_tsc;
+
+static vdso_time_t *vdso_page;         // kernel's writable view through the HHDM
+static uint64_t realtime_offset_ns;
+static spinlock_t vdso_lock = SPINLOCK_INIT;    // writers, from any CPU
+
+uint64_t ktime_real_ns(void) {
+    return ktime_ns() + realtime_offset_ns;
+}
+
+// Publish the current TSC scale. Readers only see the TSC mode while the TSC is
+// the clocksource and needs no per-CPU offsets, otherwise user time would
+// disagree with ktime_ns(). Two writers interleaving their seq bumps would
+// leave it even mid-update, so they take vdso_lock first
+void vdso_update(void) {
+    vdso_time_t *vt = vdso_page;
+    if (vt == NULL)
+        return;
+
+    uint64_t flags = irq_save();
+    arch_spin_lock(&vdso_lock);
+    vt->seq++;
+    vdso_barrier();
+
+    if (time_uses_tsc && !tsc_offsets_in_use && tsc_to_ns.mult != 0) {
+        vt->clock_mode = VDSO_CLOCK_TSC;
+        vt->tsc_base = boot_tsc;
+        vt->mono_base_ns = 0;
+        vt->mult = tsc_to_ns.mult;
+        vt->shift = tsc_to_ns.shift;
+    } else {
+        vt->clock_mode = VDSO_CLOCK_NONE;
+    }
+    vt->realtime_offset_ns = realtime_offset_ns;
+
+    vdso_barrier();
+    vt->seq++;
+    arch_spin_unlock(&vdso_lock);
+    irq_restore(flags);
+}
+
+void vdso_init(void) {
+    uint64_t phys = palloc();
+    if (phys == 0) {
+        LOG_WARN("No page for the vDSO time data, user clocks will use syscalls\n");
+        SERIAL(Warn, vdso_init, "No page for the vDSO time data, user clocks will use syscalls\n");
+        return;
+    }
+
+    vdso_page = phys_to_virt(phys);
+    memset(vdso_page, 0, 4096);
+    vdso_page->version = VDSO_TIME_VERSION;
+    realtime_offset_ns = rtc_read_unix() * 1000000000ull - ktime_ns();
+    vdso_update();
+
+    // user mapping is read-only, the kernel writes through the HHDM alias
+    map_page(VDSO_TIME_ADDR, phys, PTE_USER);
+
+    uint64_t user_ns = 0;
+    bool direct = vdso_read_ns((const volatile vdso_time_t *)VDSO_TIME_ADDR, &user_ns, NULL);
+    LOG_INFO("vDSO time page at 0x%lx (%s)\n", VDSO_TIME_ADDR,
+             direct ? "TSC, no syscall" : "syscall fallback");
+    SERIAL(Info, vdso_init, "vDSO time page at 0x%lx (%s), reads %lu ns vs ktime %lu ns\n",
+           VDSO_TIME_ADDR, direct ? "TSC, no syscall" : "syscall fallback", user_ns, ktime_ns());
+}
@@ -0,0 +1,145 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: sort.h
+    Description: Type-specialized introsort for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef SORT_H
+#define SORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * SORT_DEFINE(name, type, less) generates
+ *
+ *     static inline void name(type *v, size_t n);
+ *
+ * an introsort over an array of `type` that calls `less(a, b)` (a macro or
+ * function taking two values) instead of going through a comparator pointer.
+ * Same algorithm as qsort(): median-of-three quicksort, insertion sort below
+ * SORT_INSERTION_THRESHOLD elements, heapsort once the recursion gets deeper
+ * than 2*log2(n). It never allocates and uses O(log n) stack.
+ *
+ *     #define MEMMAP_LESS(a, b) ((a)->base < (b)->base)
+ *     SORT_DEFINE(sort_memmap, struct limine_memmap_entry *, MEMMAP_LESS)
+ */
+
+#define SORT_INSERTION_THRESHOLD 16
+
+#define SORT_LESS(a, b) ((a) < (b))
+
+static inline uint32_t sort_log2(size_t n) {
+    return 63 - __builtin_clzll((unsigned long long)n | 1);
+}
+
+#define SORT_SWAP(type, a, b)                                                   \
+    do {                                                                         \
+        type _t = (a);                                                           \
+        (a) = (b);                                                               \
+        (b) = _t;                                                                \
+    } while (0)
+
+#define SORT_DEFINE(name, type, less)                                           \
+static inline void name##_insertion(type *v, size_t n) {                        \
+    for (size_t i = 1; i < n; i++) {                                             \
+        type x = v[i];                                                           \
+        size_t j = i;                                                            \
+        for (; j > 0 && less(x, v[j - 1]); j--) v[j] = v[j - 1];                 \
+        v[j] = x;                                                                \
+    }                                                                            \
+}                                                                                \
+                                                                                 \
+static inline void name##_sift(type *v, size_t root, size_t n) {                 \
+    type x = v[root];                                                            \
+    for (size_t child; (child = 2 * root + 1) < n; root = child) {               \
+        if (child + 1 < n && less(v[child], v[child + 1])) child++;              \
+        if (!less(x, v[child])) break;                                           \
+        v[root] = v[child];                                                      \
+    }                                                                            \
+    v[root] = x;                                                                 \
+}                                                                                \
+                                                                                 \
+static inline void name##_heapsort(type *v, size_t n) {                          \
+    for (size_t i = n / 2; i-- > 0;) name##_sift(v, i, n);                       \
+    for (size_t i = n; i-- > 1;) {                                               \
+        SORT_SWAP(type, v[0], v[i]);                                             \
+        name##_sift(v, 0, i);                                                    \
+    }                                                                            \
+}                                                                                \
+                                                                                 \
+static inline void name##_loop(type *v, size_t n, uint32_t depth) {              \
+    while (n > SORT_INSERTION_THRESHOLD) {                                       \
+        if (depth-- == 0) {                                                      \
+            name##_heapsort(v, n);                                               \
+            return;                                                              \
+        }                                                                        \
+                                                                                 \
+        size_t mid = n / 2;                                                      \
+        if (less(v[mid], v[0])) SORT_SWAP(type, v[mid], v[0]);                   \
+        if (less(v[n - 1], v[mid])) {                                            \
+            SORT_SWAP(type, v[n - 1], v[mid]);                                   \
+            if (less(v[mid], v[0])) SORT_SWAP(type, v[mid], v[0]);               \
+        }                                                                        \
+        SORT_SWAP(type, v[0], v[mid]);                                           \
+                                                                                 \
+        size_t i = 1, j = n - 1;                                                 \
+        for (;;) {                                                               \
+            while (i <= j && less(v[i], v[0])) i++;                              \
+            while (i <= j && less(v[0], v[j])) j--;                              \
+            if (i >= j) break;                                                   \
+            SORT_SWAP(type, v[i], v[j]);                                         \
+            i++;                                                                 \
+            j--;                                                                 \
+        }                                                                        \
+        SORT_SWAP(type, v[0], v[j]);                                             \
+                                                                                 \
+        if (j < n - 1 - j) {                                                     \
+            name##_loop(v, j, depth);                                            \
+            v += j + 1;                                                          \
+            n -= j + 1;                                                          \
+        } else {                                                                 \
+            name##_loop(v + j + 1, n - j - 1, depth);                            \
+            n = j;                                                               \
+        }                                                                        \
+    }                                                                            \
+    name##_insertion(v, n);                                                      \
+}                                                                                \
+                                                                                 \
+static inline void name(type *v, size_t n) {                                     \
+    name##_loop(v, n, 2 * sort_log2(n));                                         \
+}
+
+#endif
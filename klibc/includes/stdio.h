@@ -44,25 +44,36 @@
 #include <stddef.h>
 
 /**
- * terminal_printf - formatted output to terminal
+ * printf - formatted output to terminal
  *
- * supported format specifiers:
- *   %d - signed decimal integer
- *   %u - unsigned decimal integer
- *   %x - hexadecimal integer
- *   %o - octal integer
- *   %f - floating point (6 decimal places)
- *   %s - null-terminated string
- *   %c - character
- *   %p - pointer (hexadecimal with 0x prefix)
- *   %m - memory (prints raw memory bytes)
+ * every formatter below shares the vcbprintf() engine, so the terminal,
+ * strings and the serial port all print the same thing for the same format.
  *
- * padding:
- *   %Nd  - pad with spaces to N width
- *   %0Nd - pad with zeros to N width
+ * supported format specifiers:
+ *   %d %i - signed decimal integer
+ *   %u    - unsigned decimal integer
+ *   %x %X - hexadecimal integer (no prefix, use %#x for 0x)
+ *   %o    - octal integer
+ *   %f    - floating point (6 decimal places by default, at most 9)
+ *   %s    - null-terminated string
+ *   %c    - character
+ *   %p    - pointer (hexadecimal with 0x prefix)
+ *   %m    - memory (prints N raw bytes, N = width, default 16)
  *
- * note: depends on terminal_putchar() and itoa() being defined elsewhere
+ * flags: - + space # 0, width and .precision (both may be *)
+ * length modifiers: hh h l ll L z j t
  */
-void printf(const char *format, ...);
+
+// receives formatted output in chunks of up to a few hundred bytes
+typedef void (*fmt_sink_t)(void *ctx, const char *s, size_t n);
+
+int vcbprintf(fmt_sink_t sink, void *ctx, const char *fmt, va_list args);
+int cbprintf(fmt_sink_t sink, void *ctx, const char *fmt, ...);
+
+int printf(const char *format, ...);
+int vprintf(const char *format, va_list args);
 int vsprintf(char *buf, const char *fmt, va_list args);
-#endif
\ No newline at end of file
+int sprintf(char *buf, const char *fmt, ...);
+int vsnprintf(char *buf, size_t size, const char *fmt, va_list args);
+int snprintf(char *buf, size_t size, const char *fmt, ...);
+#endif
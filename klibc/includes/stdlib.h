@@ -45,7 +45,9 @@
 //#include "arch/x86_64/includes/gdt.h"
 
 
-void *itoa(int32_t value, char *str, uint32_t base);
+char *itoa(int64_t value, char *str, uint32_t base);
+size_t utoa64(uint64_t value, char *str, uint32_t base);    // returns the length, str needs up to 65 bytes
+size_t itoa64(int64_t value, char *str, uint32_t base);
 void* malloc(size_t size);
 void free(void* ptr);
 void* calloc(size_t nmemb, size_t size);
@@ -66,6 +68,9 @@ void* bsearch(const void* key, const void* base, size_t num, size_t size,
 void qsort(void* base, size_t num, size_t size,
            int (*compar)(const void*, const void*));
 
+// ascending sort of plain keys, no comparator call (see sort.h for other types)
+void qsort_u64(uint64_t* keys, size_t num);
+
 #define min(a, b) ((a) < (b) ? (a) : (b))
 #define max(a, b) ((a) > (b) ? (a) : (b))
 
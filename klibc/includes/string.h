@@ -49,6 +49,8 @@ void* memset(void* ptr, int value, size_t num);
 void* memcpy(void* dest, const void* src, size_t n);
 int memcmp(const void* ptr1, const void* ptr2, size_t n);
 void* memmove(void* dst, const void* src, size_t n);
+void* memchr(const void* ptr, int value, size_t n);
+void* memrchr(const void* ptr, int value, size_t n);
 
 size_t strlen(const char* str);
 int strcmp(const char* str1, const char* str2);
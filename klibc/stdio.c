@@ -37,6 +37,8 @@
 */
 
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
 #include "kernel/terminal/src/flanterm.h"
 #include <stdint.h>
 #include <stddef.h>
@@ -45,358 +47,459 @@
 // Global flanterm context (should be set in kernel_main)
 struct flanterm_context *global_flanterm = NULL;
 
-int printf(const char *format, ...) {
-    if (!global_flanterm) return -1;
+/*
+ * Every formatted-output function in the kernel (printf, vsnprintf, serial_printf,
+ * printk and the LOG_* macros) goes through vcbprintf() below. Output is collected
+ * in a small stack buffer and handed to the sink in chunks, so a whole line costs
+ * one flanterm_write()/serial burst instead of one per character.
+ */
 
-    va_list args;
-    va_start(args, format);
+#define FMT_BUFFER_SIZE 256
 
-    char c;
-    char buf[64];
-    char *p = NULL;
-    int pad = 0;
-    char pad_char = ' ';
-    int chars_written = 0;
+#define FMT_LEFT    (1u << 0)   // '-'
+#define FMT_PLUS    (1u << 1)   // '+'
+#define FMT_SPACE   (1u << 2)   // ' '
+#define FMT_ALT     (1u << 3)   // '#'
+#define FMT_ZERO    (1u << 4)   // '0'
 
-    while ((c = *format++) != 0) {
-        pad = 0;
-        pad_char = ' ';
+typedef enum {
+    LEN_NONE,
+    LEN_HH,
+    LEN_H,
+    LEN_L,
+    LEN_LL,
+    LEN_Z,
+    LEN_J,
+    LEN_T,
+    LEN_LONG_DOUBLE,
+} fmt_length_t;
 
-        if (c != '%') {
-            flanterm_write(global_flanterm, &c, 1);
-            chars_written++;
-            continue;
-        }
+typedef struct {
+    unsigned flags;
+    size_t width;
+    int precision;      // -1 when not given
+    fmt_length_t length;
+} fmt_spec_t;
 
-        // handle padding: %0width
-        if (*format == '0') {
-            pad_char = '0';
-            format++;
-        }
+typedef struct {
+    fmt_sink_t sink;
+    void *ctx;
+    size_t used;
+    size_t total;
+    char buf[FMT_BUFFER_SIZE];
+} fmt_out_t;
 
-        while (*format >= '0' && *format <= '9') {
-            pad = pad * 10 + (*format - '0');
-            format++;
-        }
+static void fmt_flush(fmt_out_t *out) {
+    if (out->used) {
+        out->sink(out->ctx, out->buf, out->used);
+        out->used = 0;
+    }
+}
 
-        // handle length modifiers: l, ll, L
-        int is_long = 0;
-        int is_longlong = 0;
-        if (*format == 'l') {
-            format++;
-            if (*format == 'l') {
-                is_longlong = 1;
-                format++;
-            } else {
-                is_long = 1;
-            }
-        } else if (*format == 'L') {
-            is_longlong = 1;
-            format++;
+static void fmt_write(fmt_out_t *out, const char *s, size_t n) {
+    out->total += n;
+    if (n > FMT_BUFFER_SIZE - out->used) {
+        fmt_flush(out);
+        // big runs (long %s arguments) skip the buffer entirely
+        if (n >= FMT_BUFFER_SIZE) {
+            out->sink(out->ctx, s, n);
+            return;
         }
+    }
+    memcpy(out->buf + out->used, s, n);
+    out->used += n;
+}
 
-        c = *format++;
-        p = NULL;
+static void fmt_pad(fmt_out_t *out, char c, size_t n) {
+    out->total += n;
+    while (n) {
+        if (out->used == FMT_BUFFER_SIZE)
+            fmt_flush(out);
+        size_t chunk = min(n, FMT_BUFFER_SIZE - out->used);
+        memset(out->buf + out->used, c, chunk);
+        out->used += chunk;
+        n -= chunk;
+    }
+}
 
-        switch (c) {
-            case 'd':
-            case 'u':
-            case 'x':
-            case 'o': {
-                if (is_longlong) {
-                    uint64_t val = va_arg(args, uint64_t);
-                    if (c == 'x') {
-                        flanterm_write(global_flanterm, "0x", 2);
-                        chars_written += 2;
-                    }
-                    itoa(val, buf, (c == 'x') ? 16 : (c == 'o') ? 8 : 10);
-                    p = buf;
-                } else if (is_long) {
-                    long val = va_arg(args, long);
-                    if (c == 'x') {
-                        flanterm_write(global_flanterm, "0x", 2);
-                        chars_written += 2;
-                    }
-                    itoa(val, buf, (c == 'x') ? 16 : (c == 'o') ? 8 : 10);
-                    p = buf;
-                } else {
-                    int val = va_arg(args, int);
-                    if (c == 'x') {
-                        flanterm_write(global_flanterm, "0x", 2);
-                        chars_written += 2;
-                    }
-                    itoa(val, buf, (c == 'x') ? 16 : (c == 'o') ? 8 : 10);
-                    p = buf;
-                }
-                break;
-            }
+// emit [padding][prefix][zeros][body][padding] for a numeric conversion
+static void fmt_number(fmt_out_t *out, const fmt_spec_t *spec, const char *prefix, size_t plen,
+                       size_t zeros, const char *body, size_t blen, int zero_pad_ok) {
+    size_t len = plen + zeros + blen;
+    size_t pad = spec->width > len ? spec->width - len : 0;
 
-            case 'f': {
-                double fval = va_arg(args, double);
-                int int_part = (int)fval;
-                double frac = fval - int_part;
-                itoa(int_part, buf, 10);
-                
-                // Write integer part
-                char *temp = buf;
-                while (*temp) {
-                    flanterm_write(global_flanterm, temp, 1);
-                    temp++;
-                    chars_written++;
-                }
-                
-                // Write decimal point
-                flanterm_write(global_flanterm, ".", 1);
-                chars_written++;
-                
-                // Write fractional part
-                frac *= 1000000;
-                itoa((int)frac, buf, 10);
-                temp = buf;
-                while (*temp) {
-                    flanterm_write(global_flanterm, temp, 1);
-                    temp++;
-                    chars_written++;
-                }
-                continue;
-            }
+    if ((spec->flags & (FMT_ZERO | FMT_LEFT)) == FMT_ZERO && zero_pad_ok) {
+        zeros += pad;
+        pad = 0;
+    }
 
-            case 's':
-                p = va_arg(args, char *);
-                if (!p) p = "(null)";
-                break;
+    if (!(spec->flags & FMT_LEFT))
+        fmt_pad(out, ' ', pad);
+    fmt_write(out, prefix, plen);
+    fmt_pad(out, '0', zeros);
+    fmt_write(out, body, blen);
+    if (spec->flags & FMT_LEFT)
+        fmt_pad(out, ' ', pad);
+}
 
-            case 'c': {
-                char ch = (char)va_arg(args, int);
-                flanterm_write(global_flanterm, &ch, 1);
-                chars_written++;
-                continue;
-            }
+static void fmt_integer(fmt_out_t *out, const fmt_spec_t *spec, uint64_t value, int negative,
+                        unsigned base, int upper, int force_prefix) {
+    char digits[24];
+    size_t ndigits = utoa64(value, digits, base);
 
-            case 'p':
-                flanterm_write(global_flanterm, "0x", 2);
-                chars_written += 2;
-                itoa((uintptr_t)va_arg(args, void *), buf, 16);
-                p = buf;
-                break;
+    if (upper) {
+        for (size_t i = 0; i < ndigits; i++) {
+            if (digits[i] >= 'a')
+                digits[i] -= 'a' - 'A';
+        }
+    }
 
-            case 'm': {
-                char *mem = va_arg(args, char *);
-                if (!mem) mem = "(null)";
-                int len = pad ? pad : 16;
-                for (int i = 0; i < len; i++) {
-                    flanterm_write(global_flanterm, &mem[i], 1);
-                    chars_written++;
-                }
-                continue;
-            }
+    // "%.0d" of zero prints nothing at all
+    if (spec->precision == 0 && value == 0)
+        ndigits = 0;
 
-            default: {
-                flanterm_write(global_flanterm, &c, 1);
-                chars_written++;
-                continue;
-            }
-        }
+    char prefix[3];
+    size_t plen = 0;
+    if (negative)
+        prefix[plen++] = '-';
+    else if (spec->flags & FMT_PLUS)
+        prefix[plen++] = '+';
+    else if (spec->flags & FMT_SPACE)
+        prefix[plen++] = ' ';
 
-        // If we have a string to print (p is set)
-        if (p) {
-            // Calculate length
-            int len = 0;
-            char *p2 = p;
-            while (*p2++) len++;
-            
-            // Print padding
-            for (int i = len; i < pad; i++) {
-                flanterm_write(global_flanterm, &pad_char, 1);
-                chars_written++;
-            }
-            
-            // Print the string
-            while (*p) {
-                flanterm_write(global_flanterm, p, 1);
-                p++;
-                chars_written++;
-            }
-        }
+    if (base == 16 && (force_prefix || ((spec->flags & FMT_ALT) && value != 0))) {
+        prefix[plen++] = '0';
+        prefix[plen++] = upper ? 'X' : 'x';
     }
 
-    va_end(args);
-    return chars_written;
+    size_t zeros = 0;
+    if (spec->precision > 0 && (size_t)spec->precision > ndigits)
+        zeros = spec->precision - ndigits;
+    if (base == 8 && (spec->flags & FMT_ALT) && zeros == 0 && (ndigits == 0 || digits[0] != '0'))
+        zeros = 1;
+
+    fmt_number(out, spec, prefix, plen, zeros, digits, ndigits, spec->precision < 0);
 }
 
-static char *num_to_str(char *buf, unsigned long long num, int base, int uppercase)
-{
-    const char *digits = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
-    char tmp[32];
-    int i = 0;
-    
-    if (num == 0) {
-        *buf++ = '0';
-        return buf;
+static void fmt_float(fmt_out_t *out, const fmt_spec_t *spec, double value) {
+    static const uint32_t pow10[] = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+    };
+    char prefix[1];
+    size_t plen = 0;
+    char tmp[48];
+    char *end = tmp + sizeof(tmp);
+    char *p = end;
+
+    if (value < 0) {
+        prefix[plen++] = '-';
+        value = -value;
+    } else if (spec->flags & FMT_PLUS) {
+        prefix[plen++] = '+';
+    } else if (spec->flags & FMT_SPACE) {
+        prefix[plen++] = ' ';
     }
-    
-    while (num) {
-        tmp[i++] = digits[num % base];
-        num /= base;
+
+    if (value != value || value > 1.8e19) {
+        // NaN, or too large for the integer part; no exponent form in the kernel
+        const char *s = value != value ? "nan" : "inf";
+        fmt_number(out, spec, prefix, plen, 0, s, 3, 0);
+        return;
     }
-    
-    while (i > 0) {
-        *buf++ = tmp[--i];
+
+    int prec = spec->precision < 0 ? 6 : min(spec->precision, 9);
+    uint64_t whole = (uint64_t)value;
+    uint64_t frac = (uint64_t)((value - (double)whole) * pow10[prec] + 0.5);
+    if (frac >= pow10[prec]) {
+        whole++;
+        frac -= pow10[prec];
     }
-    
-    return buf;
+
+    if (prec > 0) {
+        for (int i = 0; i < prec; i++) {
+            *--p = '0' + frac % 10;
+            frac /= 10;
+        }
+    }
+    if (prec > 0 || (spec->flags & FMT_ALT))
+        *--p = '.';
+
+    char whole_digits[24];
+    size_t nwhole = utoa64(whole, whole_digits, 10);
+    p -= nwhole;
+    memcpy(p, whole_digits, nwhole);
+
+    fmt_number(out, spec, prefix, plen, 0, p, end - p, 1);
 }
 
-int vsprintf(char *buf, const char *fmt, va_list args)
-{
-    char *str = buf;
-    
-    for (; *fmt; fmt++) {
-        if (*fmt != '%') {
-            *str++ = *fmt;
+static void fmt_text(fmt_out_t *out, const fmt_spec_t *spec, const char *s, size_t n) {
+    size_t pad = spec->width > n ? spec->width - n : 0;
+
+    if (!(spec->flags & FMT_LEFT))
+        fmt_pad(out, ' ', pad);
+    fmt_write(out, s, n);
+    if (spec->flags & FMT_LEFT)
+        fmt_pad(out, ' ', pad);
+}
+
+int vcbprintf(fmt_sink_t sink, void *ctx, const char *fmt, va_list args) {
+    fmt_out_t out;
+    out.sink = sink;
+    out.ctx = ctx;
+    out.used = 0;
+    out.total = 0;
+
+    va_list ap;
+    va_copy(ap, args);
+
+    while (*fmt) {
+        // copy the literal run up to the next conversion in one go
+        const char *pct = strchr(fmt, '%');
+        if (!pct)
+            pct = fmt + strlen(fmt);
+        if (pct != fmt) {
+            fmt_write(&out, fmt, pct - fmt);
+            fmt = pct;
             continue;
         }
-        
         fmt++;
-        
-        if (*fmt == '%') {
-            *str++ = '%';
-            continue;
-        }
-        
-        int zero_pad = 0;
-        if (*fmt == '0') {
-            zero_pad = 1;
-            fmt++;
+
+        fmt_spec_t spec = { 0, 0, -1, LEN_NONE };
+
+        for (;; fmt++) {
+            if (*fmt == '-')      spec.flags |= FMT_LEFT;
+            else if (*fmt == '+') spec.flags |= FMT_PLUS;
+            else if (*fmt == ' ') spec.flags |= FMT_SPACE;
+            else if (*fmt == '#') spec.flags |= FMT_ALT;
+            else if (*fmt == '0') spec.flags |= FMT_ZERO;
+            else break;
         }
-    
-        int width = 0;
-        while (*fmt >= '0' && *fmt <= '9') {
-            width = width * 10 + (*fmt - '0');
+
+        if (*fmt == '*') {
+            int w = va_arg(ap, int);
+            if (w < 0) {
+                spec.flags |= FMT_LEFT;
+                w = -w;
+            }
+            spec.width = (size_t)w;
             fmt++;
+        } else {
+            while (*fmt >= '0' && *fmt <= '9')
+                spec.width = spec.width * 10 + (*fmt++ - '0');
         }
 
-        int is_long = 0;
-        int is_long_long = 0;
-        if (*fmt == 'l') {
-            is_long = 1;
-            fmt++;
-            if (*fmt == 'l') {
-                is_long_long = 1;
-                fmt++;
-            }
-        } else if (*fmt == 'h') {
+        if (*fmt == '.') {
             fmt++;
-            if (*fmt == 'h') {
+            spec.precision = 0;
+            if (*fmt == '*') {
+                int pr = va_arg(ap, int);
+                spec.precision = pr < 0 ? -1 : pr;
                 fmt++;
+            } else {
+                while (*fmt >= '0' && *fmt <= '9')
+                    spec.precision = spec.precision * 10 + (*fmt++ - '0');
             }
-        } else if (*fmt == 'z') {
-            is_long = (sizeof(size_t) == sizeof(long));
-            is_long_long = (sizeof(size_t) == sizeof(long long));
-            fmt++;
         }
-        
-        char *start = str;
-        unsigned long long num;
-        int base = 10;
-        int uppercase = 0;
-        int is_signed = 0;
-        
+
         switch (*fmt) {
+            case 'h':
+                fmt++;
+                spec.length = LEN_H;
+                if (*fmt == 'h') {
+                    fmt++;
+                    spec.length = LEN_HH;
+                }
+                break;
+            case 'l':
+                fmt++;
+                spec.length = LEN_L;
+                if (*fmt == 'l') {
+                    fmt++;
+                    spec.length = LEN_LL;
+                }
+                break;
+            case 'L': fmt++; spec.length = LEN_LONG_DOUBLE; break;
+            case 'z': fmt++; spec.length = LEN_Z; break;
+            case 'j': fmt++; spec.length = LEN_J; break;
+            case 't': fmt++; spec.length = LEN_T; break;
+            default: break;
+        }
+
+        char conv = *fmt;
+        if (conv == '\0')
+            break;
+        fmt++;
+
+        switch (conv) {
             case 'd':
-            case 'i':
-                is_signed = 1;
-            case 'u': {
-                if (is_signed) {
-                    long long val;
-                    if (is_long_long)
-                        val = va_arg(args, long long);
-                    else if (is_long)
-                        val = va_arg(args, long);
-                    else
-                        val = va_arg(args, int);
-                    
-                    if (val < 0) {
-                        *str++ = '-';
-                        num = -val;
-                    } else {
-                        num = val;
-                    }
-                } else {
-                    if (is_long_long)
-                        num = va_arg(args, unsigned long long);
-                    else if (is_long)
-                        num = va_arg(args, unsigned long);
-                    else
-                        num = va_arg(args, unsigned int);
+            case 'i': {
+                int64_t v;
+                switch (spec.length) {
+                    case LEN_HH: v = (signed char)va_arg(ap, int); break;
+                    case LEN_H:  v = (short)va_arg(ap, int); break;
+                    case LEN_L:  v = va_arg(ap, long); break;
+                    case LEN_LL:
+                    case LEN_LONG_DOUBLE:   // %Ld is long long, like the old printf
+                    case LEN_J:  v = va_arg(ap, long long); break;
+                    case LEN_Z:  v = va_arg(ap, ssize_t); break;
+                    case LEN_T:  v = va_arg(ap, ptrdiff_t); break;
+                    default:     v = va_arg(ap, int); break;
                 }
-                str = num_to_str(str, num, 10, 0);
+                uint64_t mag = v < 0 ? -(uint64_t)v : (uint64_t)v;
+                fmt_integer(&out, &spec, mag, v < 0, 10, 0, 0);
                 break;
             }
-            
+
+            case 'u':
             case 'x':
-                base = 16;
-                goto unsigned_hex;
             case 'X':
-                base = 16;
-                uppercase = 1;
-                goto unsigned_hex;
-            case 'o':
-                base = 8;
-unsigned_hex:
-                if (is_long_long)
-                    num = va_arg(args, unsigned long long);
-                else if (is_long)
-                    num = va_arg(args, unsigned long);
-                else
-                    num = va_arg(args, unsigned int);
-                
-                str = num_to_str(str, num, base, uppercase);
+            case 'o': {
+                uint64_t v;
+                switch (spec.length) {
+                    case LEN_HH: v = (unsigned char)va_arg(ap, unsigned int); break;
+                    case LEN_H:  v = (unsigned short)va_arg(ap, unsigned int); break;
+                    case LEN_L:  v = va_arg(ap, unsigned long); break;
+                    case LEN_LL:
+                    case LEN_LONG_DOUBLE:
+                    case LEN_J:  v = va_arg(ap, unsigned long long); break;
+                    case LEN_Z:  v = va_arg(ap, size_t); break;
+                    case LEN_T:  v = (uint64_t)va_arg(ap, ptrdiff_t); break;
+                    default:     v = va_arg(ap, unsigned int); break;
+                }
+                unsigned base = conv == 'u' ? 10 : conv == 'o' ? 8 : 16;
+                spec.flags &= ~(FMT_PLUS | FMT_SPACE);
+                fmt_integer(&out, &spec, v, 0, base, conv == 'X', 0);
                 break;
-            
+            }
+
             case 'p':
-                *str++ = '0';
-                *str++ = 'x';
-                num = (unsigned long)va_arg(args, void *);
-                str = num_to_str(str, num, 16, 0);
+                fmt_integer(&out, &spec, (uintptr_t)va_arg(ap, void *), 0, 16, 0, 1);
+                break;
+
+            case 'f':
+            case 'F': {
+                double v = spec.length == LEN_LONG_DOUBLE ? (double)va_arg(ap, long double)
+                                                          : va_arg(ap, double);
+                fmt_float(&out, &spec, v);
                 break;
-            
+            }
+
             case 's': {
-                const char *s = va_arg(args, const char *);
+                const char *s = va_arg(ap, const char *);
                 if (!s)
                     s = "(null)";
-                while (*s)
-                    *str++ = *s++;
+                size_t n;
+                if (spec.precision >= 0) {
+                    const char *nul = memchr(s, '\0', (size_t)spec.precision);
+                    n = nul ? (size_t)(nul - s) : (size_t)spec.precision;
+                } else {
+                    n = strlen(s);
+                }
+                fmt_text(&out, &spec, s, n);
                 break;
             }
-            
-            case 'c':
-                *str++ = (char)va_arg(args, int);
+
+            case 'c': {
+                char ch = (char)va_arg(ap, int);
+                fmt_text(&out, &spec, &ch, 1);
                 break;
-            
-            default:
-                *str++ = '%';
-                *str++ = *fmt;
+            }
+
+            case 'm': {
+                // VNiX extension: dump raw bytes, width is the byte count (default 16)
+                const char *mem = va_arg(ap, const char *);
+                if (!mem)
+                    mem = "(null)";
+                fmt_write(&out, mem, spec.width ? spec.width : 16);
                 break;
-        }
-        
-        int len = str - start;
-        if (width > len) {
-            int pad = width - len;
-            char pad_char = zero_pad ? '0' : ' ';
-            
-            for (int i = len - 1; i >= 0; i--) {
-                start[i + pad] = start[i];
             }
-            
-            for (int i = 0; i < pad; i++) {
-                start[i] = pad_char;
+
+            case '%':
+                fmt_write(&out, "%", 1);
+                break;
+
+            default: {
+                // unknown conversion, echo it back untouched
+                char bad[2] = { '%', conv };
+                fmt_write(&out, bad, 2);
+                break;
             }
-            
-            str += pad;
         }
     }
-    
-    *str = '\0';
-    return str - buf;
-}
\ No newline at end of file
+
+    va_end(ap);
+    fmt_flush(&out);
+    return out.total > INT32_MAX ? INT32_MAX : (int)out.total;
+}
+
+int cbprintf(fmt_sink_t sink, void *ctx, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int n = vcbprintf(sink, ctx, fmt, args);
+    va_end(args);
+    return n;
+}
+
+// sink for the terminal
+static void flanterm_sink(void *ctx, const char *s, size_t n) {
+    flanterm_write((struct flanterm_context *)ctx, s, n);
+}
+
+int vprintf(const char *format, va_list args) {
+    if (!global_flanterm) return -1;
+    return vcbprintf(flanterm_sink, global_flanterm, format, args);
+}
+
+int printf(const char *format, ...) {
+    if (!global_flanterm) return -1;
+
+    va_list args;
+    va_start(args, format);
+    int chars_written = vcbprintf(flanterm_sink, global_flanterm, format, args);
+    va_end(args);
+    return chars_written;
+}
+
+typedef struct {
+    char *dst;
+    size_t room;    // space left, not counting the terminator
+} fmt_string_ctx_t;
+
+// sink for vsnprintf; silently drops whatever does not fit
+static void string_sink(void *ctx, const char *s, size_t n) {
+    fmt_string_ctx_t *str = (fmt_string_ctx_t *)ctx;
+    size_t take = min(n, str->room);
+
+    memcpy(str->dst, s, take);
+    str->dst += take;
+    str->room -= take;
+}
+
+int vsnprintf(char *buf, size_t size, const char *fmt, va_list args) {
+    fmt_string_ctx_t ctx = { buf, size ? size - 1 : 0 };
+    int n = vcbprintf(string_sink, &ctx, fmt, args);
+
+    if (size)
+        *ctx.dst = '\0';
+    return n;
+}
+
+int snprintf(char *buf, size_t size, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, size, fmt, args);
+    va_end(args);
+    return n;
+}
+
+int vsprintf(char *buf, const char *fmt, va_list args) {
+    return vsnprintf(buf, SIZE_MAX, fmt, args);
+}
+
+int sprintf(char *buf, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, SIZE_MAX, fmt, args);
+    va_end(args);
+    return n;
+}
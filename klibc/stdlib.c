@@ -43,6 +43,8 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include "mm/heapalloc/tlsf.h"
+#include "kernel/system/includes/locks.h"
+#include <sort.h>
 
 #define ALIGN_UP(x, a) (((x) + (uintptr_t)((a)-1)) & ~((uintptr_t)((a)-1)))
 
@@ -52,12 +54,18 @@ uint8_t* heap_end = (uint8_t*)0x200000;
 
 extern tlsf_t kernel_tlsf; // global TLSF instance
 
+// TLSF itself is not thread safe, every CPU and interrupt handler shares it
 void* malloc(size_t size) {
-    return tlsf_malloc(kernel_tlsf, size);
+    uint64_t flags = heap_lock();
+    void* ptr = tlsf_malloc(kernel_tlsf, size);
+    heap_unlock(flags);
+    return ptr;
 }
 
 void free(void* ptr) {
+    uint64_t flags = heap_lock();
     tlsf_free(kernel_tlsf, ptr);
+    heap_unlock(flags);
 }
 
 void* calloc(size_t nmemb, size_t size) {
@@ -72,7 +80,10 @@ void* calloc(size_t nmemb, size_t size) {
 }
 
 void* realloc(void* ptr, size_t size) {
-    return tlsf_realloc(kernel_tlsf, ptr, size);
+    uint64_t flags = heap_lock();
+    void* new_ptr = tlsf_realloc(kernel_tlsf, ptr, size);
+    heap_unlock(flags);
+    return new_ptr;
 }
 
 uint8_t *memset_pattern(void *ptr, const void *pattern, size_t pattern_size, size_t num) {
@@ -88,43 +99,159 @@ uint8_t *memset_pattern(void *ptr, const void *pattern, size_t pattern_size, siz
     return p;
 }
 
-char *itoa(int32_t value, char *str, uint32_t base) {
-    int i = 0;
-    int isNegative = 0;
+/*
+ * Integer to string conversion.
+ * Decimal output goes two digits at a time through a lookup table, and every
+ * division is by a constant done as multiply + shift, so no div instruction is
+ * ever issued. Hex and octal are plain shifts.
+ */
+
+static const char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const uint64_t pow10_u64[20] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+// v / 10^8 for any 64-bit v (m = ceil(2^90 / 10^8))
+static inline uint64_t div_1e8(uint64_t v) {
+    return (uint64_t)(((unsigned __int128)v * 0xABCC77118461CEFDULL) >> 90);
+}
+
+// v / 10^4, exact for any 32-bit v
+static inline uint32_t div_1e4(uint32_t v) {
+    return (uint32_t)(((uint64_t)v * 3518437209ULL) >> 45);
+}
+
+// v / 100, exact for any 32-bit v
+static inline uint32_t div_100(uint32_t v) {
+    return (uint32_t)(((uint64_t)v * 1374389535ULL) >> 37);
+}
+
+static inline void put_pair(char *dst, uint32_t v) {
+    dst[0] = digit_pairs[v * 2];
+    dst[1] = digit_pairs[v * 2 + 1];
+}
+
+// exactly 4 digits (v < 10^4), leading zeros included
+static inline void put_4(char *dst, uint32_t v) {
+    uint32_t hi = (v * 5243) >> 19;     // v / 100, exact below 43699
+    put_pair(dst, hi);
+    put_pair(dst + 2, v - hi * 100);
+}
+
+// exactly 8 digits (v < 10^8), leading zeros included
+static inline void put_8(char *dst, uint32_t v) {
+    uint32_t hi = div_1e4(v);
+    put_4(dst, hi);
+    put_4(dst + 4, v - hi * 10000);
+}
+
+static inline size_t dec_digits(uint64_t v) {
+    // log10 estimate from the bit length, then correct by one
+    size_t bits = 64 - __builtin_clzll(v | 1);
+    size_t n = (bits * 1233) >> 12;
+    return n + ((v | 1) >= pow10_u64[n]);
+}
+
+static size_t u64toa_dec(uint64_t value, char *str) {
+    size_t len = dec_digits(value);
+    char *p = str + len;
+    *p = '\0';
 
-    if (value == 0) {
-        str[i++] = '0';
-        str[i] = '\0';
-        return str;
+    while (value >= 100000000) {
+        uint64_t q = div_1e8(value);
+        p -= 8;
+        put_8(p, (uint32_t)(value - q * 100000000));
+        value = q;
     }
 
-    if (value < 0 && base == 10) {
-        isNegative = 1;
-        value = -value;  
+    uint32_t v = (uint32_t)value;
+    while (v >= 100) {
+        uint32_t q = div_100(v);
+        p -= 2;
+        put_pair(p, v - q * 100);
+        v = q;
+    }
+    if (v >= 10) {
+        p -= 2;
+        put_pair(p, v);
+    } else {
+        *--p = '0' + v;
     }
 
-    while (value != 0) {
-        int rem = value % base;
-        str[i++] = (rem > 9) ? (rem - 10) + 'a' : rem + '0';  // Convert to char
-        value = value / base;
+    return len;
+}
+
+// base 2, 8 and 16 are just shifts of 1, 3 or 4 bits per digit
+static size_t u64toa_pow2(uint64_t value, char *str, uint32_t shift) {
+    static const char digits[] = "0123456789abcdef";
+    size_t bits = 64 - __builtin_clzll(value | 1);
+    size_t len = (bits + shift - 1) / shift;
+    uint64_t mask = (1ULL << shift) - 1;
+    char *p = str + len;
+
+    *p = '\0';
+    do {
+        *--p = digits[value & mask];
+        value >>= shift;
+    } while (value);
+
+    return len;
+}
+
+size_t utoa64(uint64_t value, char *str, uint32_t base) {
+    switch (base) {
+        case 10: return u64toa_dec(value, str);
+        case 16: return u64toa_pow2(value, str, 4);
+        case 8:  return u64toa_pow2(value, str, 3);
+        case 2:  return u64toa_pow2(value, str, 1);
+        default: break;
     }
 
-    if (isNegative) {
-        str[i++] = '-';
+    if (base < 2 || base > 36) {
+        str[0] = '\0';
+        return 0;
     }
 
-    str[i] = '\0'; 
+    // odd bases are rare enough that the slow path is fine
+    char tmp[64];
+    size_t i = 0;
+    do {
+        uint32_t rem = value % base;
+        tmp[i++] = (rem > 9) ? (rem - 10) + 'a' : rem + '0';
+        value /= base;
+    } while (value);
+
+    for (size_t j = 0; j < i; j++)
+        str[j] = tmp[i - 1 - j];
+    str[i] = '\0';
+    return i;
+}
 
-    int start = 0;
-    int end = i - 1;
-    while (start < end) {
-        char temp = str[start];
-        str[start] = str[end];
-        str[end] = temp;
-        start++;
-        end--;
+size_t itoa64(int64_t value, char *str, uint32_t base) {
+    // only base 10 is signed, like the old itoa
+    if (value < 0 && base == 10) {
+        str[0] = '-';
+        return utoa64(-(uint64_t)value, str + 1, base) + 1;
     }
+    return utoa64((uint64_t)value, str, base);
+}
 
+char *itoa(int64_t value, char *str, uint32_t base) {
+    itoa64(value, str, base);
     return str;
 }
 
@@ -267,14 +394,6 @@ unsigned long long strtoull(const char* str, char** endptr, int base) {
     return (unsigned long long)strtol(str, endptr, base);
 }
 
-static void swap_bytes(char* a, char* b, size_t size) {
-    while (size--) {
-        char temp = *a;
-        *a++ = *b;
-        *b++ = temp;
-    }
-}
-
 //binary search 
 void* bsearch(const void* key, const void* base, size_t num, size_t size,
               int (*compar)(const void*, const void*)) {
@@ -300,36 +419,144 @@ void* bsearch(const void* key, const void* base, size_t num, size_t size,
     return NULL;
 }
 
-//quick sort
-void qsort(void* base, size_t num, size_t size,
-           int (*compar)(const void*, const void*)) {
-    if (num < 2) return;
-    
-    char* arr = (char*)base;
-    char* pivot = arr + (num / 2) * size;
-    char* left = arr;
-    char* right = arr + (num - 1) * size;
-
-    while (left <= right) {
-        while (compar(left, pivot) < 0) left += size;
-        while (compar(right, pivot) > 0) right -= size;
-        
-        if (left <= right) {
-            if (left != right) {
-                swap_bytes(left, right, size);
-            }
-            left += size;
-            right -= size;
+// introsort: median-of-three quicksort that falls back to heapsort when the
+// recursion goes bad and leaves short runs to insertion sort. Only the smaller
+// side is recursed into, so the stack stays O(log n) on the 16K kernel stack.
+
+typedef enum {
+    SWAP_BYTES,
+    SWAP_WORDS32,
+    SWAP_WORDS64
+} swap_kind_t;
+
+typedef struct {
+    size_t size;
+    swap_kind_t swap;
+    int (*compar)(const void*, const void*);
+} qsort_ctx_t;
+
+static inline void swap_elems(const qsort_ctx_t *ctx, char *a, char *b) {
+    size_t size = ctx->size;
+
+    switch (ctx->swap) {
+    case SWAP_WORDS64:
+        for (uint64_t *x = (uint64_t *)a, *y = (uint64_t *)b; size; size -= 8) {
+            uint64_t t = *x;
+            *x++ = *y;
+            *y++ = t;
+        }
+        break;
+    case SWAP_WORDS32:
+        for (uint32_t *x = (uint32_t *)a, *y = (uint32_t *)b; size; size -= 4) {
+            uint32_t t = *x;
+            *x++ = *y;
+            *y++ = t;
+        }
+        break;
+    default:
+        while (size--) {
+            char t = *a;
+            *a++ = *b;
+            *b++ = t;
         }
+        break;
     }
-    
+}
 
-    if (arr < right) {
-        qsort(arr, (right - arr) / size + 1, size, compar);
+static void qsort_insertion(const qsort_ctx_t *ctx, char *base, size_t num) {
+    size_t size = ctx->size;
+
+    for (char *i = base + size; i < base + num * size; i += size)
+        for (char *j = i; j > base && ctx->compar(j - size, j) > 0; j -= size)
+            swap_elems(ctx, j - size, j);
+}
+
+static void qsort_sift(const qsort_ctx_t *ctx, char *base, size_t root, size_t num) {
+    size_t size = ctx->size;
+
+    for (size_t child; (child = 2 * root + 1) < num; root = child) {
+        if (child + 1 < num && ctx->compar(base + child * size, base + (child + 1) * size) < 0)
+            child++;
+        if (ctx->compar(base + root * size, base + child * size) >= 0)
+            break;
+        swap_elems(ctx, base + root * size, base + child * size);
     }
-    if (left < arr + (num - 1) * size) {
-        qsort(left, (arr + (num - 1) * size - left) / size + 1, size, compar);
+}
+
+static void qsort_heapsort(const qsort_ctx_t *ctx, char *base, size_t num) {
+    for (size_t i = num / 2; i-- > 0;)
+        qsort_sift(ctx, base, i, num);
+    for (size_t i = num; i-- > 1;) {
+        swap_elems(ctx, base, base + i * ctx->size);
+        qsort_sift(ctx, base, 0, i);
+    }
+}
+
+static void qsort_loop(const qsort_ctx_t *ctx, char *base, size_t num, uint32_t depth) {
+    size_t size = ctx->size;
+
+    while (num > SORT_INSERTION_THRESHOLD) {
+        if (depth-- == 0) {
+            qsort_heapsort(ctx, base, num);
+            return;
+        }
+
+        // order first/middle/last, then park the median at base[0] as the pivot
+        // so it does not move while partitioning
+        char *first = base, *mid = base + (num / 2) * size, *last = base + (num - 1) * size;
+        if (ctx->compar(mid, first) < 0) swap_elems(ctx, mid, first);
+        if (ctx->compar(last, mid) < 0) {
+            swap_elems(ctx, last, mid);
+            if (ctx->compar(mid, first) < 0) swap_elems(ctx, mid, first);
+        }
+        swap_elems(ctx, first, mid);
+
+        // Hoare partition, stopping on equal keys keeps runs of duplicates balanced
+        char *i = base + size, *j = last;
+        for (;;) {
+            while (i <= j && ctx->compar(i, base) < 0) i += size;
+            while (i <= j && ctx->compar(base, j) < 0) j -= size;
+            if (i >= j) break;
+            swap_elems(ctx, i, j);
+            i += size;
+            j -= size;
+        }
+        swap_elems(ctx, base, j);
+
+        size_t left = (size_t)(j - base) / size;
+        size_t right = num - left - 1;
+        if (left < right) {
+            qsort_loop(ctx, base, left, depth);
+            base = j + size;
+            num = right;
+        } else {
+            qsort_loop(ctx, j + size, right, depth);
+            num = left;
+        }
     }
+    qsort_insertion(ctx, base, num);
+}
+
+void qsort(void* base, size_t num, size_t size,
+           int (*compar)(const void*, const void*)) {
+    if (num < 2 || size == 0) return;
+
+    // every element sits at base + k*size, so checking base and size once
+    // tells us whether whole words can be swapped
+    uintptr_t align = (uintptr_t)base | size;
+    qsort_ctx_t ctx = {
+        .size = size,
+        .swap = !(align & 7) ? SWAP_WORDS64 : !(align & 3) ? SWAP_WORDS32 : SWAP_BYTES,
+        .compar = compar,
+    };
+
+    qsort_loop(&ctx, (char *)base, num, 2 * sort_log2(num));
+}
+
+SORT_DEFINE(sort_u64_keys, uint64_t, SORT_LESS)
+
+void qsort_u64(uint64_t *keys, size_t num) {
+    sort_u64_keys(keys, num);
 }
 
 void __assert_fail(const char *expr, const char *file, int line, const char *func) {
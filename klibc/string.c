@@ -40,35 +40,137 @@
 #include <string.h>
 #include <stdlib.h>
 
+/*
+ * Word-at-a-time helpers.
+ * HASZERO() sets the top bit of every zero byte in a 64-bit word. Only the
+ * lowest flagged byte is guaranteed to be exact (a borrow can flag a 0x01 byte
+ * sitting above a real zero), so callers only ever look at the lowest one.
+ */
+#define WORD_SIZE           sizeof(uint64_t)
+#define ONES                0x0101010101010101ULL
+#define HIGHS               0x8080808080808080ULL
+#define HASZERO(x)          (((x) - ONES) & ~(x) & HIGHS)
+#define STR_PAGE_SIZE       4096
+
+// true if an n-byte read at p would spill into the next page
+#define CROSSES_PAGE(p, n)  ((((uintptr_t)(p)) & (STR_PAGE_SIZE - 1)) > STR_PAGE_SIZE - (n))
+
+typedef uint64_t __attribute__((may_alias)) word_t;
+typedef uint64_t __attribute__((may_alias, aligned(1))) unaligned_word_t;
+
+static inline uint64_t load_word(const void *p) {
+    return *(const unaligned_word_t *)p;
+}
+
+// index of the lowest flagged byte in a HASZERO()/xor mask
+static inline size_t first_byte(uint64_t mask) {
+    return (size_t)__builtin_ctzll(mask) >> 3;
+}
+
+#ifdef __SSE2__
+typedef char v16qi __attribute__((vector_size(16), may_alias));
+
+static inline v16qi sse2_splat(uint8_t c) {
+    char b = (char)c;
+    return (v16qi){ b, b, b, b, b, b, b, b, b, b, b, b, b, b, b, b };
+}
+
+// pcmpeqb + pmovmskb: bit i is set when byte i of the aligned 16-byte block equals c
+static inline uint32_t sse2_match(const void *block, v16qi c) {
+    return (uint32_t)__builtin_ia32_pmovmskb128(__builtin_ia32_pcmpeqb128(*(const v16qi *)block, c));
+}
+#endif
+
 
 int strncmp(const char *str1, const char *str2, size_t n) {
-    while (n-- > 0) {
-        if (*str1 != *str2) {
-            return (unsigned char)(*str1) - (unsigned char)(*str2);
+    const uint8_t *s1 = (const uint8_t *)str1;
+    const uint8_t *s2 = (const uint8_t *)str2;
+
+    while (n > 0) {
+        // compare 8 bytes at once as long as neither read can fault
+        if (n >= WORD_SIZE && !CROSSES_PAGE(s1, WORD_SIZE) && !CROSSES_PAGE(s2, WORD_SIZE)) {
+            uint64_t a = load_word(s1);
+            uint64_t b = load_word(s2);
+            uint64_t stop = (a ^ b) | HASZERO(a);
+
+            if (stop) {
+                size_t i = first_byte(stop);
+                return s1[i] - s2[i];
+            }
+            s1 += WORD_SIZE;
+            s2 += WORD_SIZE;
+            n -= WORD_SIZE;
+            continue;
         }
-        if (*str1 == '\0') {
+
+        if (*s1 != *s2) {
+            return *s1 - *s2;
+        }
+        if (*s1 == '\0') {
             return 0;  // Return 0 if both strings are identical up to the null terminator
         }
-        str1++;
-        str2++;
+        s1++;
+        s2++;
+        n--;
     }
     return 0;  
 }
 
 size_t strlen(const char *str) {
-    size_t l = 0;
-    while (*str++ != 0) {
-        l++;
+#ifdef __SSE2__
+    // aligned 16-byte loads never cross a page, so peeking past the terminator is safe
+    const v16qi zero = sse2_splat(0);
+    uintptr_t misalign = (uintptr_t)str & 15;
+    const char *block = str - misalign;
+    uint32_t mask = sse2_match(block, zero) & (0xFFFFu << misalign);
+
+    while (!mask) {
+        block += 16;
+        mask = sse2_match(block, zero);
+    }
+    return (size_t)(block - str) + __builtin_ctz(mask);
+#else
+    const char *s = str;
+    while ((uintptr_t)s & (WORD_SIZE - 1)) {
+        if (*s == '\0')
+            return s - str;
+        s++;
     }
-    return l;
+
+    const word_t *w = (const word_t *)s;
+    uint64_t mask;
+    while (!(mask = HASZERO(*w))) {
+        w++;
+    }
+    return (size_t)((const char *)w - str) + first_byte(mask);
+#endif
 }
 
 int strcmp(const char *str1, const char *str2) {
-    while (*str1 && (*str1 == *str2)) {
-        str1++;
-        str2++;
+    const uint8_t *s1 = (const uint8_t *)str1;
+    const uint8_t *s2 = (const uint8_t *)str2;
+
+    for (;;) {
+        if (!CROSSES_PAGE(s1, WORD_SIZE) && !CROSSES_PAGE(s2, WORD_SIZE)) {
+            uint64_t a = load_word(s1);
+            uint64_t b = load_word(s2);
+            uint64_t stop = (a ^ b) | HASZERO(a);
+
+            if (stop) {
+                size_t i = first_byte(stop);
+                return s1[i] - s2[i];
+            }
+            s1 += WORD_SIZE;
+            s2 += WORD_SIZE;
+            continue;
+        }
+
+        if (*s1 == '\0' || *s1 != *s2) {
+            return *s1 - *s2;
+        }
+        s1++;
+        s2++;
     }
-    return (unsigned char)(*str1) - (unsigned char)(*str2);
 }
 
 // SEE: https://opensource.apple.com/source/Libc/Libc-1158.30.7/string/strlcat.c.auto.html
@@ -119,15 +221,140 @@ const char *strchr(const char *str, char chr) {
     if (str == NULL)
         return NULL;
 
-    while (*str)
-    {
+#ifdef __SSE2__
+    const v16qi zero = sse2_splat(0);
+    const v16qi needle = sse2_splat((uint8_t)chr);
+    uintptr_t misalign = (uintptr_t)str & 15;
+    const char *block = str - misalign;
+    uint32_t mask = (sse2_match(block, zero) | sse2_match(block, needle)) & (0xFFFFu << misalign);
+
+    while (!mask) {
+        block += 16;
+        mask = sse2_match(block, zero) | sse2_match(block, needle);
+    }
+    str = block + __builtin_ctz(mask);
+#else
+    while ((uintptr_t)str & (WORD_SIZE - 1)) {
         if (*str == chr)
             return str;
-
+        if (*str == '\0')
+            return NULL;
         ++str;
     }
 
+    const uint64_t pattern = ONES * (uint8_t)chr;
+    const word_t *w = (const word_t *)str;
+    uint64_t mask;
+    while (!(mask = HASZERO(*w) | HASZERO(*w ^ pattern))) {
+        w++;
+    }
+    str = (const char *)w + first_byte(mask);
+#endif
+
+    // we stopped on either the terminator or chr (both when chr is '\0')
+    return *str == chr ? str : NULL;
+}
+
+void *memchr(const void *ptr, int value, size_t n) {
+    const uint8_t *p = (const uint8_t *)ptr;
+    const uint8_t c = (uint8_t)value;
+
+    if (n == 0)
+        return NULL;
+
+#ifdef __SSE2__
+    const v16qi needle = sse2_splat(c);
+    uintptr_t misalign = (uintptr_t)p & 15;
+    const uint8_t *block = p - misalign;
+    size_t remaining = n > SIZE_MAX - misalign ? SIZE_MAX : n + misalign;
+    uint32_t mask = sse2_match(block, needle) & (0xFFFFu << misalign);
+
+    for (;;) {
+        if (mask) {
+            size_t i = __builtin_ctz(mask);
+            return i < remaining ? (void *)(block + i) : NULL;
+        }
+        if (remaining <= 16)
+            return NULL;
+        block += 16;
+        remaining -= 16;
+        mask = sse2_match(block, needle);
+    }
+#else
+    while (n && ((uintptr_t)p & (WORD_SIZE - 1))) {
+        if (*p == c)
+            return (void *)p;
+        p++;
+        n--;
+    }
+
+    const uint64_t pattern = ONES * c;
+    while (n >= WORD_SIZE) {
+        uint64_t mask = HASZERO(*(const word_t *)p ^ pattern);
+        if (mask)
+            return (void *)(p + first_byte(mask));
+        p += WORD_SIZE;
+        n -= WORD_SIZE;
+    }
+
+    while (n--) {
+        if (*p == c)
+            return (void *)p;
+        p++;
+    }
     return NULL;
+#endif
+}
+
+void *memrchr(const void *ptr, int value, size_t n) {
+    const uint8_t *start = (const uint8_t *)ptr;
+    const uint8_t c = (uint8_t)value;
+
+    if (n == 0)
+        return NULL;
+
+#ifdef __SSE2__
+    const v16qi needle = sse2_splat(c);
+    const uint8_t *last = start + n - 1;
+    const uint8_t *block = (const uint8_t *)((uintptr_t)last & ~(uintptr_t)15);
+    uint32_t mask = sse2_match(block, needle) & (0xFFFFu >> (15 - ((uintptr_t)last & 15)));
+
+    for (;;) {
+        if (mask) {
+            const uint8_t *hit = block + (31 - __builtin_clz(mask));
+            return hit >= start ? (void *)hit : NULL;
+        }
+        if (block <= start)
+            return NULL;
+        block -= 16;
+        mask = sse2_match(block, needle);
+    }
+#else
+    const uint8_t *p = start + n;
+
+    while (p > start && ((uintptr_t)p & (WORD_SIZE - 1))) {
+        if (*--p == c)
+            return (void *)p;
+    }
+
+    // HASZERO() is only exact for the lowest byte, so rescan a hit word backwards
+    const uint64_t pattern = ONES * c;
+    while ((size_t)(p - start) >= WORD_SIZE) {
+        p -= WORD_SIZE;
+        if (HASZERO(*(const word_t *)p ^ pattern)) {
+            for (size_t i = WORD_SIZE; i-- > 0;) {
+                if (p[i] == c)
+                    return (void *)(p + i);
+            }
+        }
+    }
+
+    while (p > start) {
+        if (*--p == c)
+            return (void *)p;
+    }
+    return NULL;
+#endif
 }
 
 void strswap(char *str, char char1, char char2) {
@@ -185,10 +412,47 @@ char *strncat(char *dest, const char *src, size_t n)
     return dest;
 }
 
+int memcmp(const void *ptr1, const void *ptr2, size_t n) {
+    const uint8_t *s1 = (const uint8_t *)ptr1;
+    const uint8_t *s2 = (const uint8_t *)ptr2;
+
+    while (n >= WORD_SIZE) {
+        uint64_t a = load_word(s1);
+        uint64_t b = load_word(s2);
+
+        if (a != b) {
+            // byte-swapped (big-endian) words order the same way a byte-wise compare does
+            return __builtin_bswap64(a) < __builtin_bswap64(b) ? -1 : 1;
+        }
+        s1 += WORD_SIZE;
+        s2 += WORD_SIZE;
+        n -= WORD_SIZE;
+    }
+
+    while (n--) {
+        if (*s1 != *s2) {
+            return *s1 - *s2;
+        }
+        s1++;
+        s2++;
+    }
+    return 0;
+}
+
 int memcmp_const(const void *ptr1, const uint8_t val, size_t n) {
     const uint8_t *s1 = (const uint8_t *)ptr1;
+    const uint64_t pattern = ONES * val;
+    size_t i = 0;
 
-    for (size_t i = 0; i < n; i++) {
+    for (; i + WORD_SIZE <= n; i += WORD_SIZE) {
+        uint64_t diff = load_word(s1 + i) ^ pattern;
+        if (diff) {
+            i += first_byte(diff);
+            return (int8_t)(s1[i] - val);
+        }
+    }
+
+    for (; i < n; i++) {
         if (s1[i] != val) {
             return (int8_t)(s1[i] - val);
         }
@@ -235,28 +499,117 @@ char* strcpy(char* dest, const char* src) {
 }
 
 
-//Source: https://github.com/jakogut/mlibc/blob/master/string.c
-//License: MIT, relicensed to GPLv2 for VNiX
+// Crochemore-Perrin maximal suffix of n[0..l), under either byte ordering.
+// Returns the position just before the suffix (may be (size_t)-1).
+static size_t maximal_suffix(const uint8_t *n, size_t l, size_t *period, int reverse) {
+    size_t ip = (size_t)-1, jp = 0, k = 1, p = 1;
+
+    while (jp + k < l) {
+        uint8_t a = n[ip + k];
+        uint8_t b = n[jp + k];
+
+        if (a == b) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else {
+                k++;
+            }
+        } else if (reverse ? a < b : a > b) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+
+    *period = p;
+    return ip;
+}
+
+// Two-Way string matching: linear time, constant space (plus a 256 byte skip table)
+static char *two_way_search(const uint8_t *h, size_t hl, const uint8_t *n, size_t l) {
+    uint64_t byteset[256 / 64] = { 0 };
+    uint8_t skip[256];
+    const uint8_t *end = h + hl;
+
+    // bad-character skip for the last haystack byte of each window, capped at 255
+    for (size_t i = 0; i < l; i++) {
+        byteset[n[i] >> 6] |= 1ULL << (n[i] & 63);
+        skip[n[i]] = (uint8_t)min(l - 1 - i, (size_t)255);
+    }
+
+    size_t p1, p2;
+    size_t ms1 = maximal_suffix(n, l, &p1, 0);
+    size_t ms2 = maximal_suffix(n, l, &p2, 1);
+    size_t ms = ms1, p = p1;
+    if (ms2 + 1 > ms1 + 1) {
+        ms = ms2;
+        p = p2;
+    }
+
+    // periodic needles remember how much of the left half already matched
+    size_t mem = 0, mem0;
+    if (memcmp(n, n + p, ms + 1)) {
+        mem0 = 0;
+        p = max(ms, l - ms - 1) + 1;
+    } else {
+        mem0 = l - p;
+    }
+
+    for (;;) {
+        if ((size_t)(end - h) < l)
+            return NULL;
+
+        uint8_t c = h[l - 1];
+        if (!(byteset[c >> 6] & (1ULL << (c & 63)))) {
+            h += l;
+            mem = 0;
+            continue;
+        }
+        if (skip[c]) {
+            h += max((size_t)skip[c], mem);
+            mem = 0;
+            continue;
+        }
+
+        size_t k;
+        for (k = max(ms + 1, mem); k < l && n[k] == h[k]; k++);
+        if (k < l) {
+            h += k - ms;
+            mem = 0;
+            continue;
+        }
+
+        for (k = ms + 1; k > mem && n[k - 1] == h[k - 1]; k--);
+        if (k <= mem)
+            return (char *)h;
+
+        h += p;
+        mem = mem0;
+    }
+}
+
 char *strstr(const char *haystack, const char *needle)
 {
-	char *hpos = (char *)haystack;
-
-	if (!*needle) return (char *)haystack;
-	while (*hpos && strlen(hpos) >= strlen(needle)) {
-		char *a = hpos, *b = (char *)needle;
-		while (*a && *b && *a == *b) {
-			a++;
-			b++;
-		}
+    if (!needle[0])
+        return (char *)haystack;
+    if (!needle[1])
+        return (char *)strchr(haystack, needle[0]);
+
+    size_t hl = strlen(haystack);
+    size_t nl = strlen(needle);
+    if (nl > hl)
+        return NULL;
 
-		if (*b == '\0')
-			return hpos;
+    return two_way_search((const uint8_t *)haystack, hl, (const uint8_t *)needle, nl);
+}
 
-		hpos++;
-	}
 
-	return NULL;
-}
+//Source: https://github.com/jakogut/mlibc/blob/master/string.c
+//License: MIT, relicensed to GPLv2 for VNiX
 
 char *strpbrk(const char *haystack, const char *needle)
 {
@@ -42,6 +42,7 @@
 #include "boot/limine.h"
 #include <stdio.h>
 #include "tools/includes/log-info.h"
+#include "kernel/system/includes/locks.h"
 #include <limits.h>
 
 static uint64_t pmm_total_pages = 0;
@@ -96,11 +97,16 @@ struct limine_memmap_entry **entries = response->entries;
 
 uint64_t palloc(void)
 {
-    if (!free_mem_head) return (uint64_t)NULL;
+    uint64_t flags = pmm_lock();
+    if (!free_mem_head) {
+        pmm_unlock(flags);
+        return (uint64_t)NULL;
+    }
     
     struct PhysicalMemoryRegion *region = free_mem_head;
     free_mem_head = free_mem_head->next;
     pmm_free_pages--;
+    pmm_unlock(flags);
     return region->base;
 }
 
@@ -109,10 +115,12 @@ void pfree(uint64_t physc_addr)
 
     struct limine_hhdm_response *hhdm_response = hhdm_request.response; 
     struct PhysicalMemoryRegion *region = (struct PhysicalMemoryRegion*)(physc_addr + hhdm_response->offset);
+    uint64_t flags = pmm_lock();
     region->next = free_mem_head;
     region->base = physc_addr;
     free_mem_head = region;
     pmm_free_pages++;
+    pmm_unlock(flags);
 }
 
 uint64_t pmm_get_total_pages(void)
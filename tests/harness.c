@@ -0,0 +1,174 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: harness.c
+    Description: Test runner and benchmark reporting for the hosted test harness.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "tests/includes/harness.h"
+#include <stdarg.h>
+
+// bounds of the "vnix_tests" section, filled in by the linker
+extern const test_case_t __start_vnix_tests[];
+extern const test_case_t __stop_vnix_tests[];
+
+static const test_case_t *current_case;
+static uint32_t current_failures;
+static int out_fd = -1;
+
+static uint64_t rand_state = 0x9E3779B97F4A7C15ull;
+
+uint64_t test_rand(void) {
+    rand_state ^= rand_state >> 12;
+    rand_state ^= rand_state << 25;
+    rand_state ^= rand_state >> 27;
+    return rand_state * 0x2545F4914F6CDD1Dull;
+}
+
+void test_srand(uint64_t seed) {
+    rand_state = seed ? seed : 0x9E3779B97F4A7C15ull;
+}
+
+static void fd_sink(void *ctx, const char *s, size_t n) {
+    host_write(*(int *)ctx, s, n);
+}
+
+// one JSON object per line, so results can be grepped, diffed or fed to jq
+static void emit(const char *fmt, ...) {
+    va_list args;
+
+    if (out_fd < 0) return;
+    va_start(args, fmt);
+    vcbprintf(fd_sink, &out_fd, fmt, args);
+    va_end(args);
+}
+
+void test_fail(const char *file, int line, const char *fmt, ...) {
+    va_list args;
+
+    current_failures++;
+    printf("    %s:%d: expected ", file, line);
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+    printf("\n");
+}
+
+uint64_t bench_now_ns(void) {
+    return host_clock_ns();
+}
+
+void bench_record(const char *metric, uint64_t ops, uint64_t ns, uint64_t bytes) {
+    uint64_t ps_per_op = ops ? (ns * 1000) / ops : 0;
+    uint64_t mb_per_s = ns ? (bytes * 1000) / ns : 0;
+
+    printf("  %-10s %-28s %10lu ops %8lu.%03lu ns/op", current_case->suite, metric,
+           ops, ps_per_op / 1000, ps_per_op % 1000);
+    if (bytes) printf(" %8lu MB/s", mb_per_s);
+    printf("\n");
+
+    emit("{\"kind\":\"bench\",\"suite\":\"%s\",\"metric\":\"%s\",\"ops\":%lu,\"ns\":%lu,"
+         "\"ns_per_op\":%lu.%03lu,\"bytes\":%lu,\"mb_per_s\":%lu}\n",
+         current_case->suite, metric, ops, ns, ps_per_op / 1000, ps_per_op % 1000,
+         bytes, mb_per_s);
+}
+
+static bool matches(const test_case_t *tc, const char *filter) {
+    char full[128];
+
+    if (!filter) return true;
+    snprintf(full, sizeof(full), "%s.%s", tc->suite, tc->name);
+    return strstr(full, filter) != NULL;
+}
+
+static void usage(const char *self) {
+    printf("usage: %s --test|--bench [--out FILE] [FILTER]\n", self);
+    printf("  FILTER selects cases whose \"suite.name\" contains it\n");
+}
+
+int host_main(int argc, char **argv) {
+    test_kind_t kind = CASE_TEST;
+    const char *out_path = NULL;
+    const char *filter = NULL;
+    uint32_t ran = 0, failed = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--test") == 0) {
+            kind = CASE_TEST;
+        } else if (strcmp(argv[i], "--bench") == 0) {
+            kind = CASE_BENCH;
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            filter = argv[i];
+        }
+    }
+
+    if (out_path) {
+        out_fd = host_open_write(out_path);
+        if (out_fd < 0) {
+            printf("cannot open %s\n", out_path);
+            return 2;
+        }
+    }
+
+    for (const test_case_t *tc = __start_vnix_tests; tc < __stop_vnix_tests; tc++) {
+        if (tc->kind != kind || !matches(tc, filter)) continue;
+
+        current_case = tc;
+        current_failures = 0;
+        test_srand(0);
+        if (kind == CASE_BENCH) printf("[bench] %s.%s\n", tc->suite, tc->name);
+
+        uint64_t start = bench_now_ns();
+        tc->fn();
+        uint64_t ns = bench_now_ns() - start;
+
+        ran++;
+        if (kind == CASE_TEST) {
+            printf("[%s] %s.%s\n", current_failures ? "FAIL" : " ok ", tc->suite, tc->name);
+            emit("{\"kind\":\"test\",\"suite\":\"%s\",\"name\":\"%s\",\"result\":\"%s\","
+                 "\"failures\":%u,\"ns\":%lu}\n", tc->suite, tc->name,
+                 current_failures ? "fail" : "pass", current_failures, ns);
+        }
+        if (current_failures) failed++;
+    }
+
+    printf("%u %s run, %u failed\n", ran, kind == CASE_TEST ? "tests" : "benchmarks", failed);
+    if (out_fd >= 0) host_close(out_fd);
+    return failed ? 1 : 0;
+}
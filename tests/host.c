@@ -0,0 +1,181 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: host.c
+    Description: Linux host runtime and kernel shims for the test harness.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+// The harness is built -nostdlib against klibc, so this file stands in for
+// both the C runtime (entry point, raw syscalls) and the parts of the kernel
+// the libraries under test reach for (terminal, serial, heap, time).
+
+#include "tests/includes/harness.h"
+#include "mm/heapalloc/tlsf.h"
+#include "kernel/terminal/src/flanterm.h"
+
+#define SYS_WRITE          1
+#define SYS_OPEN           2
+#define SYS_CLOSE          3
+#define SYS_MMAP           9
+#define SYS_MPROTECT       10
+#define SYS_CLOCK_GETTIME  228
+#define SYS_EXIT_GROUP     231
+
+#define HOST_O_WRONLY  0x001
+#define HOST_O_CREAT   0x040
+#define HOST_O_TRUNC   0x200
+
+#define HOST_PROT_NONE   0x0
+#define HOST_PROT_RW     0x3
+#define HOST_MAP_PRIVATE_ANON 0x22
+
+#define HOST_CLOCK_MONOTONIC 1
+#define HOST_PAGE_SIZE 4096
+
+static int64_t host_syscall(int64_t n, int64_t a, int64_t b, int64_t c,
+                            int64_t d, int64_t e, int64_t f) {
+    int64_t ret;
+    register int64_t r10 __asm__("r10") = d;
+    register int64_t r8 __asm__("r8") = e;
+    register int64_t r9 __asm__("r9") = f;
+    __asm__ volatile("syscall"
+                     : "=a"(ret)
+                     : "a"(n), "D"(a), "S"(b), "d"(c), "r"(r10), "r"(r8), "r"(r9)
+                     : "rcx", "r11", "memory");
+    return ret;
+}
+
+int64_t host_write(int fd, const void *buf, size_t len) {
+    const char *p = buf;
+    size_t done = 0;
+
+    while (done < len) {
+        int64_t n = host_syscall(SYS_WRITE, fd, (int64_t)(p + done), len - done, 0, 0, 0);
+        if (n <= 0) return -1;
+        done += n;
+    }
+    return done;
+}
+
+int host_open_write(const char *path) {
+    return host_syscall(SYS_OPEN, (int64_t)path, HOST_O_WRONLY | HOST_O_CREAT | HOST_O_TRUNC,
+                        0644, 0, 0, 0);
+}
+
+void host_close(int fd) {
+    host_syscall(SYS_CLOSE, fd, 0, 0, 0, 0, 0);
+}
+
+void host_exit(int code) {
+    host_syscall(SYS_EXIT_GROUP, code, 0, 0, 0, 0, 0);
+    __builtin_unreachable();
+}
+
+uint64_t host_clock_ns(void) {
+    struct { int64_t sec, nsec; } ts;
+    host_syscall(SYS_CLOCK_GETTIME, HOST_CLOCK_MONOTONIC, (int64_t)&ts, 0, 0, 0, 0);
+    return (uint64_t)ts.sec * 1000000000ull + ts.nsec;
+}
+
+void *host_guarded_alloc(size_t len) {
+    size_t span = (len + HOST_PAGE_SIZE - 1) & ~(size_t)(HOST_PAGE_SIZE - 1);
+    uint8_t *map = (uint8_t *)host_syscall(SYS_MMAP, 0, span + HOST_PAGE_SIZE, HOST_PROT_RW,
+                                           HOST_MAP_PRIVATE_ANON, -1, 0);
+    if ((int64_t)map < 0 && (int64_t)map > -4096) return NULL;
+
+    host_syscall(SYS_MPROTECT, (int64_t)(map + span), HOST_PAGE_SIZE, HOST_PROT_NONE, 0, 0, 0);
+    return map + span - len;
+}
+
+// kernel shims
+
+// printf() refuses to print until the terminal exists, any non-NULL value will do
+extern struct flanterm_context *global_flanterm;
+static int host_terminal;
+
+void flanterm_write(struct flanterm_context *ctx, const char *buf, size_t count) {
+    (void)ctx;
+    host_write(1, buf, count);
+}
+
+// serial output from LOG_*/SERIAL() would only duplicate the terminal line
+void serial_printf(const char *fmt, ...) {
+    (void)fmt;
+}
+
+static uint64_t host_boot_ns;
+
+// log timestamps count from harness start, like they count from boot in the kernel
+uint64_t ktime_ns(void) {
+    return host_clock_ns() - host_boot_ns;
+}
+
+uint32_t get_time_ms(void) {
+    return ktime_ns() / 1000000;
+}
+
+#define HOST_HEAP_SIZE 0x400000
+static unsigned char host_heap[HOST_HEAP_SIZE] __attribute__((aligned(16)));
+tlsf_t kernel_tlsf;
+
+// one thread and no interrupts, nothing to lock against
+uint64_t heap_lock(void) {
+    return 0;
+}
+
+void heap_unlock(uint64_t flags) {
+    (void)flags;
+}
+
+int host_main(int argc, char **argv);
+
+__attribute__((used)) static void host_start(uint64_t *sp) {
+    int argc = (int)sp[0];
+    char **argv = (char **)(sp + 1);
+
+    host_boot_ns = host_clock_ns();
+    global_flanterm = (struct flanterm_context *)&host_terminal;
+    kernel_tlsf = tlsf_create_with_pool(host_heap, HOST_HEAP_SIZE);
+    host_exit(host_main(argc, argv));
+}
+
+__asm__(
+    ".globl _start\n"
+    "_start:\n"
+    "    xor %rbp, %rbp\n"
+    "    mov %rsp, %rdi\n"
+    "    and $-16, %rsp\n"
+    "    call host_start\n"
+    "    hlt\n"
+);
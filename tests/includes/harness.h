@@ -0,0 +1,129 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: harness.h
+    Description: Hosted unit-test and microbenchmark harness for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#ifndef TESTS_HARNESS_H
+#define TESTS_HARNESS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * The harness links klibc, tlsf and the PMM into a plain Linux process with no
+ * libc of its own (see tests/host.c), so everything here goes through klibc.
+ *
+ * TEST(suite, name) { ... }   - unit test, run by `make test`
+ * BENCH(suite, name) { ... }  - timed benchmark, run by `make bench`
+ *
+ * Both register themselves in the "vnix_tests" section, the same trick the
+ * kernel uses for its Limine requests, so adding a case is just writing it.
+ */
+
+typedef enum {
+    CASE_TEST,
+    CASE_BENCH
+} test_kind_t;
+
+typedef struct {
+    test_kind_t kind;
+    const char *suite;
+    const char *name;
+    void (*fn)(void);
+} test_case_t;
+
+#define TEST_REGISTER(kind, suite, name)                                        \
+    static void suite##_##name##_##kind(void);                                   \
+    __attribute__((used, section("vnix_tests"), aligned(8)))                     \
+    static const test_case_t suite##_##name##_##kind##_case = {                  \
+        kind, #suite, #name, suite##_##name##_##kind };                          \
+    static void suite##_##name##_##kind(void)
+
+#define TEST(suite, name)  TEST_REGISTER(CASE_TEST, suite, name)
+#define BENCH(suite, name) TEST_REGISTER(CASE_BENCH, suite, name)
+
+// failed checks are counted against the running case, they do not abort it
+void test_fail(const char *file, int line, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#define EXPECT(cond)                                                            \
+    do {                                                                         \
+        if (!(cond)) test_fail(__FILE__, __LINE__, "%s", #cond);                 \
+    } while (0)
+
+#define EXPECT_EQ(a, b)                                                         \
+    do {                                                                         \
+        uint64_t _a = (uint64_t)(a), _b = (uint64_t)(b);                         \
+        if (_a != _b)                                                            \
+            test_fail(__FILE__, __LINE__, "%s == %s (0x%lx != 0x%lx)",           \
+                      #a, #b, _a, _b);                                           \
+    } while (0)
+
+#define EXPECT_STR_EQ(a, b)                                                     \
+    do {                                                                         \
+        const char *_a = (a), *_b = (b);                                         \
+        if (strcmp(_a, _b) != 0)                                                 \
+            test_fail(__FILE__, __LINE__, "%s == %s (\"%s\" != \"%s\")",         \
+                      #a, #b, _a, _b);                                           \
+    } while (0)
+
+// benchmarks time a loop with bench_now_ns() and report it with bench_record(),
+// bytes is 0 when a throughput figure makes no sense
+uint64_t bench_now_ns(void);
+void bench_record(const char *metric, uint64_t ops, uint64_t ns, uint64_t bytes);
+
+// keeps the compiler from deleting work whose result is never looked at
+#define BENCH_KEEP(value) __asm__ volatile("" : : "r"(value) : "memory")
+
+// small deterministic PRNG (xorshift64*) so runs are comparable
+uint64_t test_rand(void);
+void test_srand(uint64_t seed);
+
+// host services provided by tests/host.c
+int64_t host_write(int fd, const void *buf, size_t len);
+int host_open_write(const char *path);
+void host_close(int fd);
+__attribute__((noreturn)) void host_exit(int code);
+uint64_t host_clock_ns(void);
+
+// len bytes that end exactly at an inaccessible page, for overread checks
+void *host_guarded_alloc(size_t len);
+
+#endif
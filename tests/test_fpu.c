@@ -0,0 +1,218 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: test_fpu.c
+    Description: FPU state save/restore tests for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "tests/includes/harness.h"
+#include "arch/x86_64/includes/fpu.h"
+#include <stdio.h>
+#include <string.h>
+
+#define AREA_MAX 4096
+
+static uint8_t area[AREA_MAX] __attribute__((aligned(FPU_AREA_ALIGN)));
+
+typedef struct {
+    bool xsave;             // XSAVE and the OS enabled it
+    bool xsaveopt;
+    uint64_t mask;          // what the kernel would put in XCR0, limited to what this host enabled
+    size_t size;            // standard format area for mask
+} host_fpu_t;
+
+static void host_cpuid(uint32_t leaf, uint32_t sub, uint32_t r[4]) {
+    __asm__ volatile("cpuid" : "=a"(r[0]), "=b"(r[1]), "=c"(r[2]), "=d"(r[3]) : "a"(leaf), "c"(sub));
+}
+
+static host_fpu_t host_fpu(void) {
+    host_fpu_t f = { false, false, 0, FPU_FXSAVE_SIZE };
+    uint32_t r[4];
+
+    host_cpuid(1, 0, r);
+    if (!(r[2] & (1 << 27)))        // OSXSAVE
+        return f;
+
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    f.mask = (((uint64_t)hi << 32) | lo) & (XFEATURE_X87 | XFEATURE_SSE | XFEATURE_AVX | XFEATURE_AVX512);
+    f.xsave = true;
+    host_cpuid(0xD, 1, r);
+    f.xsaveopt = r[0] & 1;
+
+    // CPUID reports the size for all of XCR0, which on some hosts includes
+    // AMX tiles; only the components we save count
+    f.size = FPU_XSAVE_HDR + FPU_XSAVE_HDR_SIZE;
+    for (uint32_t i = 2; i < 64; i++) {
+        if (!(f.mask & (1ull << i)))
+            continue;
+        host_cpuid(0xD, i, r);
+        if (r[1] + r[0] > f.size)
+            f.size = r[1] + r[0];
+    }
+    return f;
+}
+
+static inline uint32_t get_mxcsr(void) {
+    uint32_t v;
+    __asm__ volatile("stmxcsr %0" : "=m"(v));
+    return v;
+}
+
+static inline void set_mxcsr(uint32_t v) {
+    __asm__ volatile("ldmxcsr %0" : : "m"(v));
+}
+
+static inline void set_xmm15(uint64_t lo, uint64_t hi) {
+    uint64_t v[2] = { lo, hi };
+    __asm__ volatile("movdqu %0, %%xmm15" : : "m"(v) : "xmm15");
+}
+
+static inline uint64_t xmm15_lo(void) {
+    uint64_t v[2];
+    __asm__ volatile("movdqu %%xmm15, %0" : "=m"(v));
+    return v[0];
+}
+
+// MXCSR and xmm15 come back from a save after being overwritten. The
+// compiler never touches MXCSR and has no reason to use xmm15 here
+static void round_trip(fpu_mode_t mode, uint64_t mask) {
+    set_mxcsr(FPU_MXCSR_DEFAULT | 0x40);    // DAZ
+    set_xmm15(0x0123456789ABCDEFull, 0xFEDCBA9876543210ull);
+    fpu_area_save(area, mode, mask);
+
+    set_mxcsr(FPU_MXCSR_DEFAULT);
+    set_xmm15(0, 0);
+    fpu_area_restore(area, mode, mask);
+
+    EXPECT_EQ(get_mxcsr(), FPU_MXCSR_DEFAULT | 0x40);
+    EXPECT_EQ(xmm15_lo(), 0x0123456789ABCDEFull);
+    set_mxcsr(FPU_MXCSR_DEFAULT);
+}
+
+TEST(fpu, fxsave_round_trip) {
+    memset(area, 0, sizeof(area));
+    round_trip(FPU_MODE_FXSAVE, 0);
+}
+
+TEST(fpu, xsave_round_trip) {
+    host_fpu_t f = host_fpu();
+    if (!f.xsave || f.size > AREA_MAX)
+        return;
+
+    memset(area, 0, sizeof(area));
+    round_trip(FPU_MODE_XSAVE, f.mask);
+    if (f.xsaveopt) {
+        // the area now matches what was restored, so XSAVEOPT may skip writes
+        round_trip(FPU_MODE_XSAVEOPT, f.mask);
+        round_trip(FPU_MODE_XSAVEOPT, f.mask);
+    }
+}
+
+// a fresh area is what a new task starts from: FNINIT state, default MXCSR,
+// zeroed vector registers
+TEST(fpu, reset_area_restores_init_state) {
+    host_fpu_t f = host_fpu();
+    fpu_mode_t mode = f.xsave ? FPU_MODE_XSAVE : FPU_MODE_FXSAVE;
+    if (f.size > AREA_MAX)
+        return;
+
+    set_mxcsr(FPU_MXCSR_DEFAULT | 0x40);
+    set_xmm15(~0ull, ~0ull);
+    fpu_area_reset(area, f.size, mode, f.mask);
+    fpu_area_restore(area, mode, f.mask);
+
+    EXPECT_EQ(get_mxcsr(), FPU_MXCSR_DEFAULT);
+    EXPECT_EQ(xmm15_lo(), 0);
+    uint16_t fcw;
+    __asm__ volatile("fnstcw %0" : "=m"(fcw));
+    EXPECT_EQ(fcw, FPU_FCW_DEFAULT);
+}
+
+// An interrupt that formats output while a task has live vector state: the
+// handler gets the default MXCSR whatever the task set, and the task gets its
+// registers back. xmm15 is clobbered by hand, the formatting code may well
+// only use the low registers
+TEST(fpu, irq_park_preserves_task_xmm) {
+    host_fpu_t f = host_fpu();
+    fpu_mode_t mode = f.xsave ? FPU_MODE_XSAVE : FPU_MODE_FXSAVE;
+    if (f.size > AREA_MAX)
+        return;
+
+    set_mxcsr(FPU_MXCSR_DEFAULT | 0x6000);  // round toward zero
+    set_xmm15(0x0123456789ABCDEFull, 0xFEDCBA9876543210ull);
+    fpu_irq_park(area, mode, f.mask);
+
+    EXPECT_EQ(get_mxcsr(), FPU_MXCSR_DEFAULT);
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.3f %s", 2.0 / 3.0, "irq");
+    EXPECT_STR_EQ(buf, "0.667 irq");
+    EXPECT_EQ(strlen(buf), 9);
+    set_xmm15(0, 0);
+    fpu_irq_unpark(area, mode, f.mask);
+
+    EXPECT_EQ(get_mxcsr(), FPU_MXCSR_DEFAULT | 0x6000);
+    EXPECT_EQ(xmm15_lo(), 0x0123456789ABCDEFull);
+    set_mxcsr(FPU_MXCSR_DEFAULT);
+}
+
+// What a switch out costs: the full save against the optimised one when
+// nothing changed since the restore, which is the common case for a task
+// that only touched the FPU briefly
+BENCH(fpu, save_cost) {
+    enum { N = 200000 };
+    host_fpu_t f = host_fpu();
+    uint64_t start;
+
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < N; i++)
+        fpu_area_save(area, FPU_MODE_FXSAVE, 0);
+    bench_record("fxsave", N, bench_now_ns() - start, 0);
+
+    if (!f.xsave || f.size > AREA_MAX)
+        return;
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < N; i++)
+        fpu_area_save(area, FPU_MODE_XSAVE, f.mask);
+    bench_record("xsave", N, bench_now_ns() - start, 0);
+
+    if (!f.xsaveopt)
+        return;
+    fpu_area_save(area, FPU_MODE_XSAVE, f.mask);
+    fpu_area_restore(area, FPU_MODE_XSAVE, f.mask);
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < N; i++)
+        fpu_area_save(area, FPU_MODE_XSAVEOPT, f.mask);
+    bench_record("xsaveopt_unmodified", N, bench_now_ns() - start, 0);
+}
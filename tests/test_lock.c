@@ -0,0 +1,223 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: test_lock.c
+    Description: Ticket, MCS and reader-writer lock tests for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "tests/includes/harness.h"
+#include "kernel/system/includes/spinlock.h"
+#include "kernel/system/includes/mcs_lock.h"
+#include "kernel/system/includes/rwlock.h"
+#include "kernel/system/includes/seqlock.h"
+
+// The harness is one thread with no %gs and no cli, so only the arch_ level
+// of each lock is exercised here, and a second CPU is played by hand where
+// a test needs one
+
+TEST(lock, ticket_lock_and_trylock) {
+    spinlock_t lock = SPINLOCK_INIT;
+
+    EXPECT(!spin_is_locked(&lock));
+    arch_spin_lock(&lock);
+    EXPECT(spin_is_locked(&lock));
+    EXPECT_EQ(lock.owner, 0);
+    EXPECT_EQ(lock.next, 1);
+    EXPECT(!arch_spin_trylock(&lock));
+    arch_spin_unlock(&lock);
+    EXPECT(!spin_is_locked(&lock));
+
+    EXPECT(arch_spin_trylock(&lock));
+    EXPECT(!arch_spin_trylock(&lock));
+    arch_spin_unlock(&lock);
+    EXPECT_EQ(lock.owner, 2);
+    EXPECT_EQ(lock.next, 2);
+}
+
+TEST(lock, ticket_wraps) {
+    spinlock_t lock = SPINLOCK_INIT;
+
+    lock.owner = lock.next = 0xFFFE;
+    for (uint32_t i = 0; i < 4; i++) {
+        arch_spin_lock(&lock);
+        EXPECT(spin_is_locked(&lock));
+        arch_spin_unlock(&lock);
+        EXPECT(!spin_is_locked(&lock));
+    }
+    EXPECT_EQ(lock.owner, 2);
+    EXPECT(arch_spin_trylock(&lock));
+    arch_spin_unlock(&lock);
+}
+
+// a waiter that drew its ticket gets the lock on the holder's release
+TEST(lock, ticket_hands_over_in_order) {
+    spinlock_t lock = SPINLOCK_INIT;
+
+    arch_spin_lock(&lock);
+    uint16_t waiter = __atomic_fetch_add(&lock.next, 1, __ATOMIC_ACQUIRE);
+    EXPECT(!arch_spin_trylock(&lock));
+    arch_spin_unlock(&lock);
+    EXPECT_EQ(lock.owner, waiter);
+    EXPECT(spin_is_locked(&lock));
+    arch_spin_unlock(&lock);
+    EXPECT(!spin_is_locked(&lock));
+}
+
+TEST(lock, mcs_lock_and_trylock) {
+    mcs_lock_t lock = MCS_LOCK_INIT;
+    mcs_node_t a, b;
+
+    arch_mcs_lock(&lock, &a);
+    EXPECT(lock.tail == &a);
+    EXPECT(!arch_mcs_trylock(&lock, &b));
+    arch_mcs_unlock(&lock, &a);
+    EXPECT(!mcs_is_locked(&lock));
+
+    EXPECT(arch_mcs_trylock(&lock, &b));
+    EXPECT(lock.tail == &b);
+    arch_mcs_unlock(&lock, &b);
+    EXPECT(lock.tail == NULL);
+}
+
+// the unlock has to find the queued waiter, flag it, and leave it the tail
+TEST(lock, mcs_hands_over_to_next_node) {
+    mcs_lock_t lock = MCS_LOCK_INIT;
+    mcs_node_t a, b;
+
+    arch_mcs_lock(&lock, &a);
+
+    // what arch_mcs_lock() does on the other CPU up to its spin
+    b.next = NULL;
+    b.locked = 0;
+    mcs_node_t *prev = __atomic_exchange_n(&lock.tail, &b, __ATOMIC_ACQ_REL);
+    EXPECT(prev == &a);
+    prev->next = &b;
+
+    arch_mcs_unlock(&lock, &a);
+    EXPECT_EQ(b.locked, 1);
+    EXPECT(lock.tail == &b);
+    arch_mcs_unlock(&lock, &b);
+    EXPECT(lock.tail == NULL);
+}
+
+TEST(lock, rwlock_readers_share_writers_exclude) {
+    rwlock_t lock = RWLOCK_INIT;
+
+    arch_read_lock(&lock);
+    EXPECT(arch_read_trylock(&lock));
+    EXPECT_EQ(lock.cnt, 2);
+    EXPECT(!arch_write_trylock(&lock));
+    arch_read_unlock(&lock);
+    arch_read_unlock(&lock);
+
+    arch_write_lock(&lock);
+    EXPECT_EQ(lock.cnt, RWLOCK_WRITER);
+    EXPECT(!arch_read_trylock(&lock));
+    EXPECT(!arch_write_trylock(&lock));
+    arch_write_unlock(&lock);
+    EXPECT_EQ(lock.cnt, 0);
+}
+
+// a writer waiting keeps new readers out, and gets in once the old ones leave
+TEST(lock, rwlock_waiting_writer_blocks_readers) {
+    rwlock_t lock = RWLOCK_INIT;
+
+    arch_read_lock(&lock);
+    __atomic_fetch_or(&lock.cnt, RWLOCK_WRITER_WAIT, __ATOMIC_RELAXED);
+    EXPECT(!arch_read_trylock(&lock));
+    EXPECT(!arch_write_trylock(&lock));
+    arch_read_unlock(&lock);
+
+    EXPECT(arch_write_trylock(&lock));
+    EXPECT_EQ(lock.cnt, RWLOCK_WRITER);
+    arch_write_unlock(&lock);
+    EXPECT(arch_read_trylock(&lock));
+    arch_read_unlock(&lock);
+}
+
+// a read that overlaps a write, even one that has finished, is retried
+TEST(lock, seqcount_reader_retries_across_a_write) {
+    seqlock_t sl = SEQLOCK_INIT;
+
+    uint32_t seq = read_seqbegin(&sl);
+    EXPECT(!read_seqretry(&sl, seq));
+
+    write_seqcount_begin(&sl.seq);
+    EXPECT_EQ(sl.seq.sequence & 1, 1);
+    EXPECT(read_seqretry(&sl, seq));
+    write_seqcount_end(&sl.seq);
+    EXPECT(read_seqretry(&sl, seq));
+
+    seq = read_seqbegin(&sl);
+    EXPECT_EQ(seq, 2);
+    EXPECT(!read_seqretry(&sl, seq));
+}
+
+// uncontended lock plus unlock, the floor every lock in the kernel pays
+BENCH(lock, uncontended) {
+    enum { N = 1000000 };
+    spinlock_t ticket = SPINLOCK_INIT;
+    mcs_lock_t mcs = MCS_LOCK_INIT;
+    rwlock_t rw = RWLOCK_INIT;
+    uint64_t start;
+
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < N; i++) {
+        arch_spin_lock(&ticket);
+        arch_spin_unlock(&ticket);
+    }
+    bench_record("ticket", N, bench_now_ns() - start, 0);
+
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < N; i++) {
+        mcs_node_t node;
+        arch_mcs_lock(&mcs, &node);
+        arch_mcs_unlock(&mcs, &node);
+    }
+    bench_record("mcs", N, bench_now_ns() - start, 0);
+
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < N; i++) {
+        arch_read_lock(&rw);
+        arch_read_unlock(&rw);
+    }
+    bench_record("rwlock_read", N, bench_now_ns() - start, 0);
+
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < N; i++) {
+        arch_write_lock(&rw);
+        arch_write_unlock(&rw);
+    }
+    bench_record("rwlock_write", N, bench_now_ns() - start, 0);
+}
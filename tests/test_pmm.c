@@ -0,0 +1,156 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: test_pmm.c
+    Description: Unit tests and benchmarks for the physical memory manager.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "tests/includes/harness.h"
+
+// pulled in whole so the tests can fill in the static Limine memmap request
+#include "mm/pmm.c"
+
+// the harness is single threaded, the kernel's versions are in locks.c
+uint64_t pmm_lock(void) {
+    return 0;
+}
+
+void pmm_unlock(uint64_t flags) {
+    (void)flags;
+}
+
+#define FAKE_PHYS_BASE 0x100000
+#define FAKE_RAM_SIZE  0x400000
+
+// stands in for physical RAM, reached through a fake HHDM offset
+static unsigned char fake_ram[FAKE_RAM_SIZE] __attribute__((aligned(4096)));
+
+static struct limine_memmap_entry fake_entries[] = {
+    { FAKE_PHYS_BASE,            0x100000, LIMINE_MEMMAP_USABLE },
+    { FAKE_PHYS_BASE + 0x100000, 0x080000, LIMINE_MEMMAP_RESERVED },
+    // unaligned on both ends, pmm_init must only hand out whole pages inside it
+    { FAKE_PHYS_BASE + 0x180800, 0x0FF000, LIMINE_MEMMAP_USABLE },
+    { FAKE_PHYS_BASE + 0x300000, 0x100000, LIMINE_MEMMAP_BOOTLOADER_RECLAIMABLE },
+};
+static struct limine_memmap_entry *fake_entry_list[] = {
+    &fake_entries[0], &fake_entries[1], &fake_entries[2], &fake_entries[3],
+};
+static struct limine_memmap_response fake_memmap = { 0, 4, fake_entry_list };
+static struct limine_hhdm_response fake_hhdm = { 0, 0 };
+
+// 256 pages from the first entry, 254 from the ragged one
+#define FAKE_USABLE_PAGES (256 + 254)
+
+static void fake_boot(void) {
+    fake_hhdm.offset = (uint64_t)fake_ram - FAKE_PHYS_BASE;
+    memmap_request.response = &fake_memmap;
+    hhdm_request.response = &fake_hhdm;
+
+    free_mem_head = NULL;
+    pmm_total_pages = 0;
+    pmm_free_pages = 0;
+    pmm_init();
+}
+
+static bool in_usable(uint64_t phys) {
+    for (size_t i = 0; i < sizeof(fake_entries) / sizeof(fake_entries[0]); i++) {
+        struct limine_memmap_entry *e = &fake_entries[i];
+        if (e->type == LIMINE_MEMMAP_USABLE && phys >= e->base && phys + PAGE_SIZE <= e->base + e->length)
+            return true;
+    }
+    return false;
+}
+
+TEST(pmm, init_counts_usable_pages) {
+    fake_boot();
+    EXPECT_EQ(pmm_get_total_pages(), FAKE_USABLE_PAGES);
+    EXPECT_EQ(pmm_get_free_pages(), FAKE_USABLE_PAGES);
+    EXPECT_EQ(pmm_get_used_pages(), 0);
+}
+
+TEST(pmm, palloc_pfree_roundtrip) {
+    static uint64_t pages[FAKE_USABLE_PAGES];
+
+    fake_boot();
+    for (size_t i = 0; i < FAKE_USABLE_PAGES; i++) {
+        pages[i] = palloc();
+        EXPECT(pages[i] != 0);
+        EXPECT_EQ(pages[i] % PAGE_SIZE, 0);
+        EXPECT(in_usable(pages[i]));
+    }
+    EXPECT_EQ(palloc(), 0);
+    EXPECT_EQ(pmm_get_free_pages(), 0);
+
+    // no page may be handed out twice
+    uint32_t duplicates = 0;
+    for (size_t i = 0; i < FAKE_USABLE_PAGES; i++)
+        for (size_t j = i + 1; j < FAKE_USABLE_PAGES; j++)
+            duplicates += pages[i] == pages[j];
+    EXPECT_EQ(duplicates, 0);
+
+    for (size_t i = 0; i < FAKE_USABLE_PAGES; i++) pfree(pages[i]);
+    EXPECT_EQ(pmm_get_free_pages(), FAKE_USABLE_PAGES);
+    EXPECT(palloc() != 0);
+}
+
+BENCH(pmm, palloc_churn) {
+    static uint64_t held[64];
+    uint64_t rounds = 20000;
+
+    fake_boot();
+
+    uint64_t start = bench_now_ns();
+    for (uint64_t r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < 64; i++) held[i] = palloc();
+        for (size_t i = 0; i < 64; i++) pfree(held[64 - 1 - i]);
+    }
+    bench_record("palloc_pfree_batch64", rounds * 64, bench_now_ns() - start, 0);
+
+    // random single-page churn over a working set, closer to what page tables do
+    static uint64_t live[256];
+    memset(live, 0, sizeof(live));
+    uint64_t ops = 1000000;
+
+    start = bench_now_ns();
+    for (uint64_t i = 0; i < ops; i++) {
+        uint32_t s = (uint32_t)(i * 2654435761u) % 256;
+        if (live[s]) {
+            pfree(live[s]);
+            live[s] = 0;
+        } else {
+            live[s] = palloc();
+        }
+    }
+    bench_record("palloc_pfree_random", ops, bench_now_ns() - start, 0);
+}
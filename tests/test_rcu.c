@@ -0,0 +1,129 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: test_rcu.c
+    Description: RCU list helper tests for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "tests/includes/harness.h"
+#include "kernel/system/includes/rcu.h"
+
+// Grace periods need the scheduler, so only the list helpers are tested
+// here, with the reader's view checked by walking the list by hand
+
+typedef struct {
+    uint32_t id;
+    rcu_list_node_t node;
+} rcu_item_t;
+
+static uint32_t rcu_collect(rcu_list_t *list, uint32_t *ids, uint32_t max) {
+    rcu_item_t *item;
+    uint32_t n = 0;
+
+    rcu_list_for_each_entry(item, list, node) {
+        if (n < max)
+            ids[n] = item->id;
+        n++;
+    }
+    return n;
+}
+
+TEST(rcu, list_add_head_and_behind) {
+    rcu_list_t list = RCU_LIST_INIT;
+    rcu_item_t a = { .id = 1 }, b = { .id = 2 }, c = { .id = 3 };
+    uint32_t ids[4];
+
+    EXPECT(rcu_list_empty(&list));
+    EXPECT_EQ(rcu_collect(&list, ids, 4), 0);
+
+    rcu_list_add_head(&list, &a.node);
+    rcu_list_add_head(&list, &b.node);
+    rcu_list_add_behind(&b.node, &c.node);
+    EXPECT(!rcu_list_empty(&list));
+    EXPECT_EQ(rcu_collect(&list, ids, 4), 3);
+    EXPECT_EQ(ids[0], 2);
+    EXPECT_EQ(ids[1], 3);
+    EXPECT_EQ(ids[2], 1);
+    EXPECT(a.node.pprev == &c.node.next);
+    EXPECT(b.node.pprev == &list.first);
+}
+
+// a reader standing on a removed node still gets to the rest of the list
+TEST(rcu, list_del_keeps_readers_on_track) {
+    rcu_list_t list = RCU_LIST_INIT;
+    rcu_item_t a = { .id = 1 }, b = { .id = 2 }, c = { .id = 3 };
+    uint32_t ids[4];
+
+    rcu_list_add_head(&list, &c.node);
+    rcu_list_add_head(&list, &b.node);
+    rcu_list_add_head(&list, &a.node);
+
+    rcu_list_node_t *reader = rcu_dereference(list.first);
+    reader = rcu_dereference(reader->next);
+    EXPECT(reader == &b.node);
+
+    rcu_list_del(&b.node);
+    EXPECT(rcu_list_unhashed(&b.node));
+    EXPECT(rcu_dereference(reader->next) == &c.node);
+    EXPECT_EQ(rcu_collect(&list, ids, 4), 2);
+    EXPECT_EQ(ids[0], 1);
+    EXPECT_EQ(ids[1], 3);
+    EXPECT(c.node.pprev == &a.node.next);
+
+    rcu_list_del(&a.node);
+    rcu_list_del(&c.node);
+    EXPECT(rcu_list_empty(&list));
+}
+
+TEST(rcu, list_replace) {
+    rcu_list_t list = RCU_LIST_INIT;
+    rcu_item_t a = { .id = 1 }, b = { .id = 2 }, c = { .id = 3 }, d = { .id = 4 };
+    uint32_t ids[4];
+
+    rcu_list_add_head(&list, &c.node);
+    rcu_list_add_head(&list, &b.node);
+    rcu_list_add_head(&list, &a.node);
+
+    rcu_list_replace(&b.node, &d.node);
+    EXPECT(rcu_list_unhashed(&b.node));
+    EXPECT(b.node.next == &c.node);
+    EXPECT_EQ(rcu_collect(&list, ids, 4), 3);
+    EXPECT_EQ(ids[0], 1);
+    EXPECT_EQ(ids[1], 4);
+    EXPECT_EQ(ids[2], 3);
+
+    rcu_list_replace(&a.node, &b.node);
+    EXPECT(list.first == &b.node);
+    EXPECT(d.node.pprev == &b.node.next);
+}
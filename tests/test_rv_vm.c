@@ -0,0 +1,180 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: test_rv_vm.c
+    Description: Unit tests and benchmarks for the RV32I interpreter.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "tests/includes/harness.h"
+
+// the VM reports decode errors through rv_vm_panic, count them instead of aborting
+static uint32_t vm_panics;
+#define rv_vm_panic(...) (vm_panics++)
+#define RV_VM_IMPLEMENTATION
+#include "drivers/emul/rv_vm.h/rv_vm.h"
+
+#define VM_MEM_SIZE 0x1000
+
+typedef struct {
+    RvVm vm;
+    uint8_t mem[VM_MEM_SIZE];
+    uint32_t syscalls;
+} test_vm_t;
+
+static int vm_read(RvVm *vm, uint32_t at, void *data, size_t size) {
+    test_vm_t *t = (test_vm_t *)vm;
+    if (at >= VM_MEM_SIZE || size > VM_MEM_SIZE - at) return -RV_VM_ERR_COUNT;
+    memcpy(data, t->mem + at, size);
+    return 0;
+}
+
+static int vm_write(RvVm *vm, uint32_t at, uint32_t value, size_t size) {
+    test_vm_t *t = (test_vm_t *)vm;
+    if (at >= VM_MEM_SIZE || size > VM_MEM_SIZE - at) return -RV_VM_ERR_COUNT;
+    memcpy(t->mem + at, &value, size);
+    return 0;
+}
+
+// a positive return stops run_vm()
+static int vm_syscall(RvVm *vm) {
+    ((test_vm_t *)vm)->syscalls++;
+    return 1;
+}
+
+static int vm_breakpoint(RvVm *vm) {
+    (void)vm;
+    return 2;
+}
+
+static void vm_load(test_vm_t *t, const uint32_t *code, size_t words) {
+    memset(t, 0, sizeof(*t));
+    memcpy(t->mem, code, words * sizeof(uint32_t));
+    t->vm.read = vm_read;
+    t->vm.write32 = vm_write;
+    t->vm.on_syscall = vm_syscall;
+    t->vm.on_breakpoint = vm_breakpoint;
+}
+
+static int run_vm(test_vm_t *t, uint64_t *steps) {
+    int e;
+    uint64_t n = 0;
+
+    do {
+        e = rv_vm_step(&t->vm);
+        n++;
+    } while (e == 0);
+    if (steps) *steps = n;
+    return e;
+}
+
+// x3 = 1 + 2 + ... + x2, spilled to and reloaded from memory every iteration
+static const uint32_t sum_loop[] = {
+    0x00108093, // addi x1, x1, 1
+    0x001181b3, // add  x3, x3, x1
+    0x00322023, // sw   x3, 0(x4)
+    0x00022283, // lw   x5, 0(x4)
+    0xfe2098e3, // bne  x1, x2, -16
+    0x00000073, // ecall
+};
+
+#define SUM_LOOP_DATA 0x800
+
+TEST(rv_vm, sum_loop) {
+    static test_vm_t t;
+    uint64_t steps;
+
+    vm_load(&t, sum_loop, sizeof(sum_loop) / sizeof(sum_loop[0]));
+    t.vm.regs[2] = 100;
+    t.vm.regs[4] = SUM_LOOP_DATA;
+
+    EXPECT_EQ(run_vm(&t, &steps), 1);
+    EXPECT_EQ(t.syscalls, 1);
+    EXPECT_EQ(steps, 100 * 5 + 1);
+    EXPECT_EQ(t.vm.regs[1], 100);
+    EXPECT_EQ(t.vm.regs[3], 5050);
+    EXPECT_EQ(t.vm.regs[5], 5050);
+    EXPECT_EQ(*(uint32_t *)(t.mem + SUM_LOOP_DATA), 5050);
+    EXPECT_EQ(t.vm.ip, sizeof(sum_loop));
+}
+
+TEST(rv_vm, jal_lui_shift) {
+    static const uint32_t code[] = {
+        0x008000ef, // jal  x1, +8
+        0x06300313, // addi x6, x0, 99
+        0x123453b7, // lui  x7, 0x12345
+        0x00439393, // slli x7, x7, 4
+        0x00000073, // ecall
+    };
+    static test_vm_t t;
+
+    vm_load(&t, code, sizeof(code) / sizeof(code[0]));
+    EXPECT_EQ(run_vm(&t, NULL), 1);
+    EXPECT_EQ(t.vm.regs[1], 4);
+    EXPECT_EQ(t.vm.regs[6], 0);
+    EXPECT_EQ(t.vm.regs[7], 0x23450000);
+}
+
+TEST(rv_vm, faults) {
+    static const uint32_t compressed[] = { 0x00000001 };
+    static const uint32_t bad_opcode[] = { 0x0000000b }; // custom-0
+    static const uint32_t wild_load[] = { 0xfff02283 }; // lw x5, -1(x0)
+    static const uint32_t ebreak[] = { 0x00100073 };
+    static test_vm_t t;
+
+    vm_load(&t, compressed, 1);
+    EXPECT_EQ(rv_vm_step(&t.vm), -RV_VM_ERR_NON32_BIT);
+    vm_load(&t, bad_opcode, 1);
+    EXPECT_EQ(rv_vm_step(&t.vm), -RV_VM_ERR_UNSUP_OPCODE);
+    vm_load(&t, wild_load, 1);
+    EXPECT_EQ(rv_vm_step(&t.vm), -RV_VM_ERR_COUNT);
+    vm_load(&t, ebreak, 1);
+    EXPECT_EQ(rv_vm_step(&t.vm), 2);
+    EXPECT_EQ(vm_panics, 0);
+}
+
+BENCH(rv_vm, throughput) {
+    static test_vm_t t;
+    uint64_t steps;
+
+    vm_load(&t, sum_loop, sizeof(sum_loop) / sizeof(sum_loop[0]));
+    t.vm.regs[2] = 2000000;
+    t.vm.regs[4] = SUM_LOOP_DATA;
+
+    uint64_t start = bench_now_ns();
+    run_vm(&t, &steps);
+    uint64_t ns = bench_now_ns() - start;
+
+    EXPECT_EQ(t.vm.regs[1], 2000000);
+    bench_record("instructions", steps, ns, 0);
+}
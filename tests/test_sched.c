@@ -0,0 +1,153 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: test_sched.c
+    Description: Scheduler run queue and context switch tests for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "tests/includes/harness.h"
+#include "kernel/sched/includes/sched.h"
+#include "kernel/sched/includes/runqueue.h"
+
+#define CO_STACK_SIZE 0x4000
+
+static task_t tasks[8];
+
+static void tasks_reset(void) {
+    memset(tasks, 0, sizeof(tasks));
+    for (uint32_t i = 0; i < 8; i++) {
+        tasks[i].tid = i;
+        tasks[i].pinned = SCHED_ANY_CPU;
+    }
+}
+
+TEST(sched, runqueue_is_fifo) {
+    runqueue_t rq;
+
+    tasks_reset();
+    runqueue_init(&rq);
+    EXPECT(runqueue_pop(&rq) == NULL);
+    for (uint32_t i = 0; i < 8; i++)
+        runqueue_push(&rq, &tasks[i]);
+    EXPECT_EQ(rq.nr_queued, 8);
+
+    for (uint32_t i = 0; i < 8; i++)
+        EXPECT(runqueue_pop(&rq) == &tasks[i]);
+    EXPECT(runqueue_pop(&rq) == NULL);
+    EXPECT_EQ(rq.nr_queued, 0);
+    EXPECT_EQ(rq.enqueued, 8);
+    EXPECT(rq.head == NULL && rq.tail == NULL);
+}
+
+TEST(sched, runqueue_remove_keeps_links) {
+    runqueue_t rq;
+
+    tasks_reset();
+    runqueue_init(&rq);
+    for (uint32_t i = 0; i < 5; i++)
+        runqueue_push(&rq, &tasks[i]);
+
+    runqueue_remove(&rq, &tasks[2]);    // middle
+    runqueue_remove(&rq, &tasks[0]);    // head
+    runqueue_remove(&rq, &tasks[4]);    // tail
+    EXPECT_EQ(rq.nr_queued, 2);
+    EXPECT(rq.head == &tasks[1] && rq.tail == &tasks[3]);
+    EXPECT(tasks[1].rq_next == &tasks[3] && tasks[3].rq_prev == &tasks[1]);
+
+    // a removed task can go straight back on
+    runqueue_push(&rq, &tasks[2]);
+    EXPECT(runqueue_pop(&rq) == &tasks[1]);
+    EXPECT(runqueue_pop(&rq) == &tasks[3]);
+    EXPECT(runqueue_pop(&rq) == &tasks[2]);
+    EXPECT(runqueue_pop(&rq) == NULL);
+}
+
+TEST(sched, steal_takes_newest_and_honours_pinning) {
+    runqueue_t rq;
+
+    tasks_reset();
+    runqueue_init(&rq);
+    tasks[1].pinned = 2;
+    tasks[2].pinned = 1;
+    for (uint32_t i = 0; i < 3; i++)
+        runqueue_push(&rq, &tasks[i]);
+
+    EXPECT(runqueue_steal(&rq, 2) == &tasks[1]);   // tasks[2] is pinned to 1
+    EXPECT(runqueue_steal(&rq, 3) == &tasks[0]);
+    EXPECT(runqueue_steal(&rq, 3) == NULL);
+    EXPECT_EQ(rq.stolen, 2);
+    EXPECT_EQ(rq.nr_queued, 1);
+    EXPECT(runqueue_pop(&rq) == &tasks[2]);
+}
+
+// a coroutine on its own stack, bounced to and from with context_switch()
+static uint64_t main_rsp, co_rsp;
+static volatile uint64_t co_runs;
+static uint64_t co_stack[CO_STACK_SIZE / 8] __attribute__((aligned(16)));
+
+static void co_entry(void) {
+    // the stack has to look like a call left it, or SSE spills fault
+    if ((uint64_t)__builtin_frame_address(0) & 0xF)
+        co_runs = UINT64_MAX / 2;
+
+    for (;;) {
+        co_runs++;
+        context_switch(&co_rsp, main_rsp);
+    }
+}
+
+TEST(sched, context_switch_round_trips) {
+    register uint64_t kept __asm__("rbx") = 0x1234567890ABCDEFull;
+
+    co_runs = 0;
+    co_rsp = context_stack_init((uint8_t *)co_stack + sizeof(co_stack), co_entry);
+    for (uint32_t i = 0; i < 100; i++)
+        context_switch(&main_rsp, co_rsp);
+    __asm__ volatile("" : "+r"(kept));
+
+    EXPECT_EQ(co_runs, 100);
+    EXPECT_EQ(kept, 0x1234567890ABCDEFull);
+}
+
+BENCH(sched, context_switch_ping_pong) {
+    enum { N = 1000000 };
+
+    co_runs = 0;
+    co_rsp = context_stack_init((uint8_t *)co_stack + sizeof(co_stack), co_entry);
+    uint64_t start = bench_now_ns();
+    for (uint32_t i = 0; i < N; i++)
+        context_switch(&main_rsp, co_rsp);
+    // two switches per round trip
+    bench_record("context_switch", 2 * N, bench_now_ns() - start, 0);
+}
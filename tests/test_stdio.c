@@ -0,0 +1,119 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: test_stdio.c
+    Description: Unit tests and benchmarks for the klibc formatter.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "tests/includes/harness.h"
+
+#define EXPECT_FMT(expected, ...)                                               \
+    do {                                                                         \
+        char _buf[128];                                                          \
+        int _n = snprintf(_buf, sizeof(_buf), __VA_ARGS__);                      \
+        EXPECT_STR_EQ(_buf, expected);                                           \
+        EXPECT_EQ(_n, strlen(expected));                                         \
+    } while (0)
+
+TEST(stdio, integers) {
+    EXPECT_FMT("0", "%d", 0);
+    EXPECT_FMT("-42", "%d", -42);
+    EXPECT_FMT("-2147483648", "%d", (int)0x80000000);
+    EXPECT_FMT("18446744073709551615", "%lu", (unsigned long)-1);
+    EXPECT_FMT("-9223372036854775808", "%lld", (long long)0x8000000000000000ull);
+    EXPECT_FMT("255", "%hhu", 0x1FF);
+    EXPECT_FMT("deadbeef DEADBEEF", "%x %X", 0xDEADBEEF, 0xDEADBEEF);
+    EXPECT_FMT("0x1f 017", "%#x %#o", 31, 15);
+    EXPECT_FMT("0x1000", "%p", (void *)0x1000);
+}
+
+TEST(stdio, width_precision_flags) {
+    EXPECT_FMT("   42", "%5d", 42);
+    EXPECT_FMT("42   |", "%-5d|", 42);
+    EXPECT_FMT("00042", "%05d", 42);
+    EXPECT_FMT("+42  42", "%+d % d", 42, 42);
+    EXPECT_FMT("  007", "%5.3d", 7);
+    EXPECT_FMT("   ab", "%*s", 5, "ab");
+    EXPECT_FMT("abc", "%.3s", "abcdef");
+    EXPECT_FMT("%", "%%");
+    EXPECT_FMT("x", "%c", 'x');
+    EXPECT_FMT("(null)", "%s", (char *)NULL);
+}
+
+TEST(stdio, floats) {
+    EXPECT_FMT("3.141593", "%f", 3.14159265);
+    EXPECT_FMT("-0.50", "%.2f", -0.5);
+    EXPECT_FMT("  1.5", "%5.1f", 1.5);
+    EXPECT_FMT("1", "%.0f", 1.0);
+}
+
+TEST(stdio, truncation) {
+    char buf[8];
+
+    int n = snprintf(buf, sizeof(buf), "%s", "hello world");
+    EXPECT_EQ(n, 11);
+    EXPECT_STR_EQ(buf, "hello w");
+
+    n = snprintf(NULL, 0, "%d", 123456);
+    EXPECT_EQ(n, 6);
+
+    // longer than the engine's internal buffer, exercises the flush path
+    char big[600];
+    char pad[520];
+    memset(pad, 'q', sizeof(pad) - 1);
+    pad[sizeof(pad) - 1] = '\0';
+    n = snprintf(big, sizeof(big), "<%s|%300d>", pad, 1);
+    EXPECT_EQ(n, 1 + 519 + 1 + 300 + 1);
+    EXPECT_EQ(strlen(big), sizeof(big) - 1);
+}
+
+BENCH(stdio, snprintf) {
+    char buf[128];
+    uint64_t iters = 200000;
+
+    uint64_t start = bench_now_ns();
+    for (uint64_t i = 0; i < iters; i++) {
+        int n = snprintf(buf, sizeof(buf), "[%5lu.%03lu] %s: %d %x %p\n",
+                         i, i % 1000, "log", (int)i, (unsigned)i, (void *)buf);
+        BENCH_KEEP(n);
+    }
+    bench_record("snprintf_log_line", iters, bench_now_ns() - start, 0);
+
+    start = bench_now_ns();
+    for (uint64_t i = 0; i < iters; i++) {
+        int n = snprintf(buf, sizeof(buf), "%lu", i * 0x9E3779B97F4A7C15ull);
+        BENCH_KEEP(n);
+    }
+    bench_record("snprintf_u64", iters, bench_now_ns() - start, 0);
+}
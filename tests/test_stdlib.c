@@ -0,0 +1,293 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: test_stdlib.c
+    Description: Unit tests and benchmarks for klibc/stdlib.c.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "tests/includes/harness.h"
+#include <sort.h>
+
+// reference conversion by repeated division
+static size_t ref_utoa(uint64_t v, char *out, uint32_t base) {
+    char tmp[65];
+    size_t n = 0;
+
+    do {
+        tmp[n++] = "0123456789abcdefghijklmnopqrstuvwxyz"[v % base];
+        v /= base;
+    } while (v);
+    for (size_t i = 0; i < n; i++) out[i] = tmp[n - 1 - i];
+    out[n] = '\0';
+    return n;
+}
+
+TEST(stdlib, utoa64_matches_reference) {
+    static const uint32_t bases[] = { 2, 8, 10, 16, 36 };
+    char got[66], want[66];
+
+    for (uint32_t i = 0; i < 20000; i++) {
+        // mix full-width values with short ones so every digit count shows up
+        uint64_t v = test_rand() >> (test_rand() % 64);
+        for (size_t b = 0; b < sizeof(bases) / sizeof(bases[0]); b++) {
+            size_t n = utoa64(v, got, bases[b]);
+            EXPECT_EQ(n, ref_utoa(v, want, bases[b]));
+            EXPECT_STR_EQ(got, want);
+        }
+    }
+
+    for (uint64_t p = 1; p && p <= 10000000000000000000ull; p *= 10) {
+        for (int d = -1; d <= 1; d++) {
+            utoa64(p + d, got, 10);
+            ref_utoa(p + d, want, 10);
+            EXPECT_STR_EQ(got, want);
+        }
+    }
+}
+
+TEST(stdlib, itoa_signed) {
+    char buf[66];
+
+    EXPECT_STR_EQ(itoa(0, buf, 10), "0");
+    EXPECT_STR_EQ(itoa(-1, buf, 10), "-1");
+    EXPECT_STR_EQ(itoa(-INT64_MAX - 1, buf, 10), "-9223372036854775808");
+    EXPECT_STR_EQ(itoa(INT64_MAX, buf, 10), "9223372036854775807");
+    EXPECT_STR_EQ(itoa(-1, buf, 16), "ffffffffffffffff");
+}
+
+TEST(stdlib, strtol_atoi) {
+    char *end;
+
+    EXPECT_EQ(atoi("  -123xyz"), (uint64_t)-123);
+    EXPECT_EQ(strtol("0x1F", &end, 16), 31);
+    EXPECT_EQ(*end, '\0');
+    EXPECT_EQ(strtol("777", NULL, 8), 511);
+}
+
+static int cmp_int(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+TEST(stdlib, bsearch) {
+    int v[257];
+
+    for (size_t i = 0; i < 257; i++) v[i] = (int)(i * 3);
+
+    for (int key = -1; key < 257 * 3; key++) {
+        int *hit = bsearch(&key, v, 257, sizeof(int), cmp_int);
+        if (key >= 0 && key % 3 == 0) {
+            EXPECT(hit == &v[key / 3]);
+        } else {
+            EXPECT(hit == NULL);
+        }
+    }
+}
+
+BENCH(stdlib, utoa64) {
+    char buf[66];
+    uint64_t iters = 1000000;
+
+    uint64_t start = bench_now_ns();
+    for (uint64_t i = 0; i < iters; i++) {
+        size_t n = utoa64(i * 0x9E3779B97F4A7C15ull, buf, 10);
+        BENCH_KEEP(n);
+    }
+    bench_record("utoa64_dec_20digit", iters, bench_now_ns() - start, 0);
+
+    start = bench_now_ns();
+    for (uint64_t i = 0; i < iters; i++) {
+        size_t n = utoa64(i, buf, 10);
+        BENCH_KEEP(n);
+    }
+    bench_record("utoa64_dec_small", iters, bench_now_ns() - start, 0);
+
+    start = bench_now_ns();
+    for (uint64_t i = 0; i < iters; i++) {
+        size_t n = utoa64(i * 0x9E3779B97F4A7C15ull, buf, 16);
+        BENCH_KEEP(n);
+    }
+    bench_record("utoa64_hex", iters, bench_now_ns() - start, 0);
+}
+
+static uint64_t compares;
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    compares++;
+    return (x > y) - (x < y);
+}
+
+// odd-sized element, forces the byte-wise swap path
+typedef struct {
+    uint8_t key[3];
+    uint8_t tag[4];
+} rec7_t;
+
+static int cmp_rec7(const void *a, const void *b) {
+    return memcmp(((const rec7_t *)a)->key, ((const rec7_t *)b)->key, 3);
+}
+
+typedef enum {
+    FILL_RANDOM,
+    FILL_SORTED,
+    FILL_REVERSED,
+    FILL_EQUAL,
+    FILL_ORGAN_PIPE,
+    FILL_FEW_KEYS,
+    FILL_COUNT
+} fill_t;
+
+static void fill_keys(uint64_t *v, size_t n, fill_t how) {
+    for (size_t i = 0; i < n; i++) {
+        switch (how) {
+        case FILL_RANDOM:     v[i] = test_rand(); break;
+        case FILL_SORTED:     v[i] = i; break;
+        case FILL_REVERSED:   v[i] = n - i; break;
+        case FILL_EQUAL:      v[i] = 7; break;
+        case FILL_ORGAN_PIPE: v[i] = i < n / 2 ? i : n - i; break;
+        default:              v[i] = test_rand() % 4; break;
+        }
+    }
+}
+
+static uint64_t key_sum(const uint64_t *v, size_t n) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; i++) sum += v[i] * 0x9E3779B97F4A7C15ull ^ v[i];
+    return sum;
+}
+
+TEST(stdlib, qsort_patterns) {
+    static uint64_t v[5000];
+    static const size_t sizes[] = { 0, 1, 2, 3, 16, 17, 100, 1000, 5000 };
+
+    for (int how = 0; how < FILL_COUNT; how++) {
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            size_t n = sizes[s];
+            fill_keys(v, n, how);
+            uint64_t sum = key_sum(v, n);
+
+            compares = 0;
+            qsort(v, n, sizeof(uint64_t), cmp_u64);
+
+            for (size_t i = 1; i < n; i++) EXPECT(v[i - 1] <= v[i]);
+            EXPECT_EQ(key_sum(v, n), sum);
+            // introsort bound, the old quicksort went quadratic on sorted input
+            if (n > 1) EXPECT(compares <= 4 * n * (sort_log2(n) + 1));
+        }
+    }
+}
+
+TEST(stdlib, qsort_element_sizes) {
+    static rec7_t recs[700];
+    static uint32_t words[701];
+
+    for (size_t i = 0; i < 700; i++) {
+        uint32_t k = (uint32_t)test_rand() % 5000;
+        recs[i].key[0] = k >> 16;
+        recs[i].key[1] = k >> 8;
+        recs[i].key[2] = k;
+        memcpy(recs[i].tag, &k, 4);
+    }
+    qsort(recs, 700, sizeof(rec7_t), cmp_rec7);
+    for (size_t i = 0; i < 700; i++) {
+        uint32_t k;
+        memcpy(&k, recs[i].tag, 4);
+        EXPECT_EQ((uint32_t)(recs[i].key[0] << 16 | recs[i].key[1] << 8 | recs[i].key[2]), k);
+        if (i) EXPECT(cmp_rec7(&recs[i - 1], &recs[i]) <= 0);
+    }
+
+    // 4-byte elements at an address that is not 8 byte aligned
+    for (size_t i = 0; i < 700; i++) words[1 + i] = (uint32_t)test_rand();
+    qsort(words + 1, 700, sizeof(uint32_t), cmp_int);
+    for (size_t i = 2; i < 701; i++) EXPECT((int)words[i - 1] <= (int)words[i]);
+}
+
+TEST(stdlib, qsort_u64_and_sort_define) {
+    static uint64_t a[3000], b[3000];
+
+    for (int how = 0; how < FILL_COUNT; how++) {
+        fill_keys(a, 3000, how);
+        memcpy(b, a, sizeof(a));
+        qsort_u64(a, 3000);
+        qsort(b, 3000, sizeof(uint64_t), cmp_u64);
+        EXPECT(memcmp(a, b, sizeof(a)) == 0);
+    }
+}
+
+typedef struct {
+    uint64_t base;
+    uint32_t id;
+} fake_region_t;
+
+#define REGION_LESS(a, b) ((a)->base < (b)->base)
+SORT_DEFINE(sort_regions, fake_region_t *, REGION_LESS)
+
+TEST(stdlib, sort_define_pointers) {
+    static fake_region_t regions[200];
+    static fake_region_t *list[200];
+
+    for (uint32_t i = 0; i < 200; i++) {
+        regions[i].base = (test_rand() % 1000) << 12;
+        regions[i].id = i;
+        list[i] = &regions[i];
+    }
+    sort_regions(list, 200);
+    for (size_t i = 1; i < 200; i++) EXPECT(list[i - 1]->base <= list[i]->base);
+
+    // a zero depth budget goes straight to the heapsort fallback
+    for (uint32_t i = 0; i < 200; i++) list[i] = &regions[199 - i];
+    sort_regions_loop(list, 200, 0);
+    for (size_t i = 1; i < 200; i++) EXPECT(list[i - 1]->base <= list[i]->base);
+}
+
+BENCH(stdlib, qsort) {
+    static uint64_t v[100000];
+    static const char *names[FILL_COUNT] = {
+        "qsort_u64_100k_random", "qsort_u64_100k_sorted", "qsort_u64_100k_reversed",
+        "qsort_u64_100k_equal", "qsort_u64_100k_organ_pipe", "qsort_u64_100k_few_keys",
+    };
+
+    for (int how = 0; how < FILL_COUNT; how++) {
+        fill_keys(v, 100000, how);
+        uint64_t start = bench_now_ns();
+        qsort(v, 100000, sizeof(uint64_t), cmp_u64);
+        bench_record(names[how], 100000, bench_now_ns() - start, 0);
+    }
+
+    fill_keys(v, 100000, FILL_RANDOM);
+    uint64_t start = bench_now_ns();
+    qsort_u64(v, 100000);
+    bench_record("qsort_u64_inline_100k_random", 100000, bench_now_ns() - start, 0);
+}
@@ -0,0 +1,227 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: test_string.c
+    Description: Unit tests and benchmarks for klibc/string.c.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "tests/includes/harness.h"
+
+// reference versions, deliberately the dumbest possible loops
+
+static size_t ref_strlen(const char *s) {
+    size_t n = 0;
+    while (s[n]) n++;
+    return n;
+}
+
+static const void *ref_memchr(const void *p, int c, size_t n) {
+    const uint8_t *b = p;
+    for (size_t i = 0; i < n; i++)
+        if (b[i] == (uint8_t)c) return b + i;
+    return NULL;
+}
+
+static const char *ref_strstr(const char *h, const char *n) {
+    size_t nl = ref_strlen(n);
+    for (; *h; h++)
+        if (strncmp(h, n, nl) == 0) return h;
+    return nl ? NULL : h;
+}
+
+static int sign(int v) {
+    return (v > 0) - (v < 0);
+}
+
+TEST(string, strlen_every_alignment) {
+    // the string ends right before an unmapped page, so any overread faults
+    for (size_t len = 0; len < 200; len++) {
+        char *s = host_guarded_alloc(len + 1);
+        memset(s, 'a', len);
+        s[len] = '\0';
+        EXPECT_EQ(strlen(s), len);
+    }
+}
+
+TEST(string, strchr_and_memchr) {
+    char *buf = host_guarded_alloc(257);
+
+    for (size_t i = 0; i < 256; i++) buf[i] = (char)(i % 250) + 1;
+    buf[256] = '\0';
+
+    EXPECT(strchr(buf, 0) == buf + 256);
+    EXPECT(strchr(buf, 1) == buf);
+    EXPECT(strchr(buf, 250) == buf + 249);
+    EXPECT(strchr(buf, 255) == NULL);
+
+    for (int c = 0; c < 256; c++)
+        for (size_t n = 0; n <= 257; n += 13)
+            EXPECT(memchr(buf, c, n) == ref_memchr(buf, c, n));
+
+    EXPECT(memrchr(buf, 1, 256) == buf + 250);
+    EXPECT(memrchr(buf, 1, 250) == buf);
+    EXPECT(memrchr(buf, 255, 256) == NULL);
+}
+
+TEST(string, compare) {
+    char a[300], b[300];
+
+    for (size_t i = 0; i < sizeof(a); i++) a[i] = b[i] = 'A' + (i % 26);
+    a[299] = b[299] = '\0';
+
+    EXPECT_EQ(strcmp(a, b), 0);
+    EXPECT_EQ(memcmp(a, b, sizeof(a)), 0);
+
+    for (size_t i = 0; i < 299; i += 7) {
+        b[i] = (char)0xF0;
+        EXPECT(strcmp(a, b) < 0);
+        EXPECT(strncmp(a, b, i) == 0);
+        EXPECT(strncmp(a, b, i + 1) < 0);
+        EXPECT(memcmp(b, a, 299) > 0);
+        EXPECT(sign(memcmp(a, b, i + 1)) == -1);
+        b[i] = a[i];
+    }
+
+    EXPECT(strcmp("abc", "abcd") < 0);
+    EXPECT(strcmp("abcd", "abc") > 0);
+    EXPECT(strncmp("abcx", "abcy", 3) == 0);
+}
+
+TEST(string, strstr_matches_reference) {
+    static const char *haystacks[] = {
+        "", "a", "aaaaaaaaab", "abababababac", "the quick brown fox jumps over the lazy dog",
+        "GCAGAGAGGCAGAGAGCAGAGAG", "aabaabaaabaabaaab",
+    };
+    static const char *needles[] = {
+        "", "a", "b", "ab", "aab", "abac", "lazy dog", "GAGAG", "aaab", "zzz", "aabaaab",
+    };
+
+    for (size_t i = 0; i < sizeof(haystacks) / sizeof(haystacks[0]); i++)
+        for (size_t j = 0; j < sizeof(needles) / sizeof(needles[0]); j++)
+            EXPECT(strstr(haystacks[i], needles[j]) == ref_strstr(haystacks[i], needles[j]));
+}
+
+TEST(string, copy_move_set) {
+    uint8_t src[512], dst[512];
+
+    for (size_t i = 0; i < sizeof(src); i++) src[i] = (uint8_t)test_rand();
+
+    for (size_t n = 0; n < 300; n += 11) {
+        memset(dst, 0xCC, sizeof(dst));
+        memcpy(dst + 3, src, n);
+        EXPECT(memcmp(dst + 3, src, n) == 0);
+        EXPECT_EQ(dst[3 + n], 0xCC);
+    }
+
+    memcpy(dst, src, sizeof(src));
+    memmove(dst + 5, dst, 200);
+    EXPECT(memcmp(dst + 5, src, 200) == 0);
+    memcpy(dst, src, sizeof(src));
+    memmove(dst, dst + 5, 200);
+    EXPECT(memcmp(dst, src + 5, 200) == 0);
+
+    memset(dst, 0x5A, 100);
+    EXPECT_EQ(memcmp_const(dst, 0x5A, 100), 0);
+}
+
+static void bench_memcpy_size(const char *metric, size_t size, uint64_t iters) {
+    uint8_t *src = malloc(size), *dst = malloc(size);
+
+    memset(src, 0xA5, size);
+    uint64_t start = bench_now_ns();
+    for (uint64_t i = 0; i < iters; i++) {
+        memcpy(dst, src, size);
+        BENCH_KEEP(dst);
+    }
+    bench_record(metric, iters, bench_now_ns() - start, size * iters);
+    free(src);
+    free(dst);
+}
+
+BENCH(string, memcpy) {
+    bench_memcpy_size("memcpy_16", 16, 2000000);
+    bench_memcpy_size("memcpy_64", 64, 1000000);
+    bench_memcpy_size("memcpy_256", 256, 500000);
+    bench_memcpy_size("memcpy_4096", 4096, 50000);
+    bench_memcpy_size("memcpy_65536", 65536, 2000);
+}
+
+BENCH(string, memset) {
+    static uint8_t buf[4096];
+    uint64_t iters = 50000;
+
+    uint64_t start = bench_now_ns();
+    for (uint64_t i = 0; i < iters; i++) {
+        memset(buf, (int)i, sizeof(buf));
+        BENCH_KEEP(buf);
+    }
+    bench_record("memset_4096", iters, bench_now_ns() - start, sizeof(buf) * iters);
+}
+
+BENCH(string, strlen_strcmp) {
+    static char a[1024], b[1024];
+    uint64_t iters = 200000;
+
+    memset(a, 'x', sizeof(a) - 1);
+    memset(b, 'x', sizeof(b) - 1);
+
+    uint64_t start = bench_now_ns();
+    for (uint64_t i = 0; i < iters; i++) {
+        size_t n = strlen(a);
+        BENCH_KEEP(n);
+    }
+    bench_record("strlen_1023", iters, bench_now_ns() - start, (sizeof(a) - 1) * iters);
+
+    start = bench_now_ns();
+    for (uint64_t i = 0; i < iters; i++) {
+        int r = strcmp(a, b);
+        BENCH_KEEP(r);
+    }
+    bench_record("strcmp_1023", iters, bench_now_ns() - start, (sizeof(a) - 1) * iters);
+}
+
+BENCH(string, strstr) {
+    static char hay[8192];
+    const char *needle = "aaaaaaaaaaaaaaab";
+    uint64_t iters = 2000;
+
+    memset(hay, 'a', sizeof(hay) - 1);
+
+    uint64_t start = bench_now_ns();
+    for (uint64_t i = 0; i < iters; i++) {
+        char *r = strstr(hay, needle);
+        BENCH_KEEP(r);
+    }
+    bench_record("strstr_worst_8k", iters, bench_now_ns() - start, (sizeof(hay) - 1) * iters);
+}
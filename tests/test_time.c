@@ -0,0 +1,113 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: test_time.c
+    Description: Unit tests and benchmarks for the fixed-point clock conversions.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "tests/includes/harness.h"
+#include "kernel/time/includes/time.h"
+
+// exact ticks * to / from, the value clock_scale_apply() approximates
+static uint64_t exact(uint64_t ticks, uint64_t from_hz, uint64_t to_hz) {
+    unsigned __int128 p = (unsigned __int128)ticks * to_hz;
+    uint64_t q = 0;
+
+    // long division by shift-and-subtract, the host build has no libgcc
+    for (int bit = 127; bit >= 0; bit--) {
+        if ((p >> bit) / from_hz) {
+            unsigned __int128 sub = (unsigned __int128)from_hz << bit;
+            if (p >= sub) {
+                p -= sub;
+                q |= 1ull << bit;
+            }
+        }
+    }
+    return q;
+}
+
+TEST(time, clock_scale_accuracy) {
+    static const uint64_t freqs[] = {
+        14318180, 19200000, 24000000, 100000000, 1000000000, 1193182,
+        2399987000, 3000000000ull, 3792001000ull, 5800000000ull,
+    };
+    static const uint64_t units[] = { 1000, 1000000, 1000000000 };
+
+    for (size_t f = 0; f < sizeof(freqs) / sizeof(freqs[0]); f++) {
+        for (size_t u = 0; u < sizeof(units) / sizeof(units[0]); u++) {
+            clock_scale_t s = clock_scale_make(freqs[f], units[u]);
+            EXPECT(s.mult != 0);
+
+            // a day of ticks, and a random spread below it
+            uint64_t day = freqs[f] * 86400;
+            for (int i = 0; i < 200; i++) {
+                uint64_t ticks = i ? test_rand() % day : day;
+                uint64_t want = exact(ticks, freqs[f], units[u]);
+                uint64_t got = clock_scale_apply(s, ticks);
+                uint64_t err = got > want ? got - want : want - got;
+                // within one unit plus a part in 2^30 of the value
+                EXPECT(err <= 1 + (want >> 30));
+            }
+        }
+    }
+
+    // and the other way, microseconds into TSC cycles for delays
+    clock_scale_t to_tsc = clock_scale_make(1000000, 3000000000ull);
+    EXPECT_EQ(clock_scale_apply(to_tsc, 10), 30000);
+    EXPECT_EQ(clock_scale_apply(to_tsc, 4000000000u), 12000000000000ull);
+
+    clock_scale_t none = clock_scale_make(0, 1000);
+    EXPECT_EQ(clock_scale_apply(none, 12345), 0);
+}
+
+BENCH(time, clock_scale_apply) {
+    clock_scale_t s = clock_scale_make(2399987000ull, 1000000000);
+    uint64_t iters = 10000000;
+    uint64_t acc = 0;
+
+    uint64_t start = bench_now_ns();
+    for (uint64_t i = 0; i < iters; i++) {
+        acc += clock_scale_apply(s, i * 7919);
+        BENCH_KEEP(acc);
+    }
+    bench_record("tsc_to_ns_mul_shift", iters, bench_now_ns() - start, 0);
+
+    volatile uint64_t hz = 2399987000ull;
+    start = bench_now_ns();
+    for (uint64_t i = 0; i < iters; i++) {
+        acc += (i * 7919) * 1000 / hz;
+        BENCH_KEEP(acc);
+    }
+    bench_record("tsc_to_ms_divide", iters, bench_now_ns() - start, 0);
+}
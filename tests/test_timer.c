@@ -0,0 +1,248 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: test_timer.c
+    Description: Kernel timer module tests for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "tests/includes/harness.h"
+#include "kernel/time/includes/timer.h"
+
+static timer_wheel_t wheel;
+
+typedef struct {
+    ktimer_t timer;
+    uint64_t fired_at;      // tick it ran on, 0 if it never ran
+    uint32_t runs;
+} probe_t;
+
+static void probe_fire(void *arg) {
+    probe_t *p = arg;
+    p->fired_at = wheel.clk - 1;    // the wheel moved past the tick it is running
+    p->runs++;
+}
+
+static void probe_arm(probe_t *p, uint64_t expires) {
+    memset(p, 0, sizeof(*p));
+    p->timer.fn = probe_fire;
+    p->timer.arg = p;
+    p->timer.expires = expires;
+    timer_wheel_add(&wheel, &p->timer);
+}
+
+TEST(timer, fires_on_its_tick_at_every_level) {
+    static const uint64_t deltas[] = {
+        0, 1, 2, 255, 256, 257, 1000, 16383, 16384, 16385, 100000,
+        (1 << 20) - 1, 1 << 20, (1 << 20) + 77, 5000000, 1 << 24,
+    };
+    enum { N = sizeof(deltas) / sizeof(deltas[0]) };
+    static probe_t probes[N];
+    uint64_t start = 123456;    // not aligned to any level
+
+    timer_wheel_init(&wheel, start);
+    for (size_t i = 0; i < N; i++)
+        probe_arm(&probes[i], start + deltas[i]);
+    EXPECT_EQ(wheel.stats.pending, N);
+
+    timer_wheel_advance(&wheel, start + (1 << 24));
+    for (size_t i = 0; i < N; i++) {
+        EXPECT_EQ(probes[i].runs, 1);
+        EXPECT_EQ(probes[i].fired_at, start + deltas[i]);
+    }
+    EXPECT_EQ(wheel.stats.pending, 0);
+    EXPECT_EQ(wheel.stats.expired, N);
+    EXPECT_EQ(wheel.stats.max_late_ticks, 0);
+}
+
+TEST(timer, random_adds_and_cancels) {
+    enum { N = 3000, SPAN = 1 << 18 };
+    static probe_t probes[N];
+    static bool cancelled[N];
+
+    test_srand(35);
+    timer_wheel_init(&wheel, 0);
+    for (size_t i = 0; i < N; i++) {
+        probe_arm(&probes[i], test_rand() % SPAN);
+        cancelled[i] = false;
+    }
+
+    // cancel a third of them part way through, some already fired
+    timer_wheel_advance(&wheel, SPAN / 4);
+    for (size_t i = 0; i < N; i += 3) {
+        bool pending = timer_pending(&probes[i].timer);
+        EXPECT_EQ(timer_wheel_del(&probes[i].timer), pending);
+        EXPECT_EQ(pending, probes[i].runs == 0);
+        cancelled[i] = pending;
+    }
+
+    timer_wheel_advance(&wheel, SPAN);
+    for (size_t i = 0; i < N; i++) {
+        if (cancelled[i]) {
+            EXPECT_EQ(probes[i].runs, 0);
+        } else {
+            EXPECT_EQ(probes[i].runs, 1);
+            EXPECT_EQ(probes[i].fired_at, probes[i].timer.expires);
+        }
+    }
+    EXPECT_EQ(wheel.stats.pending, 0);
+}
+
+TEST(timer, late_and_overdue_timers) {
+    probe_t overdue, late;
+
+    timer_wheel_init(&wheel, 1000);
+    probe_arm(&overdue, 10);        // already in the past, runs on the next tick
+    timer_wheel_advance(&wheel, 1000);
+    EXPECT_EQ(overdue.runs, 1);
+    EXPECT_EQ(overdue.fired_at, 1000);
+
+    // the wheel was not advanced for a while, the timer runs on catching up
+    probe_arm(&late, 1005);
+    timer_wheel_advance(&wheel, 1100);
+    EXPECT_EQ(late.runs, 1);
+    EXPECT_EQ(late.fired_at, 1005);
+
+    // deadlines past TIMER_MAX_TICKS still land in the top level
+    probe_t far;
+    probe_arm(&far, wheel.clk + TIMER_MAX_TICKS + 1000);
+    EXPECT(timer_pending(&far.timer));
+    EXPECT(timer_wheel_del(&far.timer));
+    EXPECT(!timer_wheel_del(&far.timer));
+}
+
+static probe_t rearm_probe;
+static probe_t victim_probe;
+
+// re-queues itself twice and cancels a timer waiting in the same slot
+static void rearm_fire(void *arg) {
+    probe_t *p = arg;
+    p->runs++;
+    timer_wheel_del(&victim_probe.timer);
+    if (p->runs < 3) {
+        p->timer.expires = wheel.clk + 300;
+        timer_wheel_add(&wheel, &p->timer);
+    }
+}
+
+TEST(timer, callbacks_can_requeue_and_cancel) {
+    timer_wheel_init(&wheel, 0);
+    probe_arm(&victim_probe, 50);
+    probe_arm(&rearm_probe, 50);    // pushed in front of the victim
+    rearm_probe.timer.fn = rearm_fire;
+
+    timer_wheel_advance(&wheel, 2000);
+    EXPECT_EQ(rearm_probe.runs, 3);
+    EXPECT_EQ(victim_probe.runs, 0);
+    EXPECT_EQ(wheel.stats.pending, 0);
+}
+
+TEST(timer, next_expiry_matches_brute_force) {
+    enum { N = 400 };
+    static probe_t probes[N];
+
+    test_srand(36);
+    timer_wheel_init(&wheel, 777);
+    EXPECT_EQ(timer_wheel_next(&wheel), TIMER_NONE);
+
+    for (size_t i = 0; i < N; i++) {
+        // mostly near, some in each upper level, a few beyond the top
+        uint64_t span = 1ull << (4 + test_rand() % 30);
+        probe_arm(&probes[i], wheel.clk + test_rand() % span);
+    }
+
+    // step from one expiry to the next, checking against a full scan each time
+    for (int steps = 0; steps < N; steps++) {
+        uint64_t want = TIMER_NONE;
+        for (size_t i = 0; i < N; i++) {
+            if (timer_pending(&probes[i].timer) && probes[i].timer.expires < want)
+                want = probes[i].timer.expires;
+        }
+        uint64_t got = timer_wheel_next(&wheel);
+        EXPECT_EQ(got, want);
+        if (got == TIMER_NONE || got > wheel.clk + (1 << 22))
+            break;
+        timer_wheel_advance(&wheel, got);
+    }
+
+    // cancelling everything leaves nothing to wake up for
+    for (size_t i = 0; i < N; i++)
+        timer_wheel_del(&probes[i].timer);
+    EXPECT_EQ(timer_wheel_next(&wheel), TIMER_NONE);
+}
+
+TEST(timer, idle_wheel_skips_ahead) {
+    probe_t p;
+
+    timer_wheel_init(&wheel, 0);
+    timer_wheel_advance(&wheel, 1ull << 40);    // would take hours tick by tick
+    EXPECT_EQ(wheel.clk, (1ull << 40) + 1);
+
+    probe_arm(&p, wheel.clk + 5);
+    timer_wheel_advance(&wheel, wheel.clk + 10);
+    EXPECT_EQ(p.runs, 1);
+    EXPECT_EQ(p.fired_at, p.timer.expires);
+}
+
+static void nop_fire(void *arg) {
+    (void)arg;
+}
+
+BENCH(timer, add_cancel_run) {
+    enum { N = 100000 };
+    static ktimer_t timers[N];
+    uint64_t start;
+
+    timer_wheel_init(&wheel, 0);
+    test_srand(1);
+    for (size_t i = 0; i < N; i++) {
+        timers[i].fn = nop_fire;
+        timers[i].pprev = NULL;
+        timers[i].expires = test_rand() % (1 << 20);
+    }
+
+    start = bench_now_ns();
+    for (size_t i = 0; i < N; i++)
+        timer_wheel_add(&wheel, &timers[i]);
+    bench_record("timer_add", N, bench_now_ns() - start, 0);
+
+    start = bench_now_ns();
+    for (size_t i = 0; i < N; i += 2)
+        timer_wheel_del(&timers[i]);
+    bench_record("timer_cancel", N / 2, bench_now_ns() - start, 0);
+
+    // a million ticks with 50000 timers spread over them
+    start = bench_now_ns();
+    timer_wheel_advance(&wheel, 1 << 20);
+    bench_record("timer_tick", 1 << 20, bench_now_ns() - start, 0);
+}
@@ -0,0 +1,152 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: test_tlsf.c
+    Description: Unit tests and benchmarks for the TLSF heap allocator.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "tests/includes/harness.h"
+#include "mm/heapalloc/tlsf.h"
+
+// each case gets its own pool so kernel_tlsf (klibc malloc) stays untouched
+#define ARENA_SIZE 0x200000
+static unsigned char arena[ARENA_SIZE] __attribute__((aligned(16)));
+
+#define SLOTS 512
+
+TEST(tlsf, malloc_free_integrity) {
+    tlsf_t t = tlsf_create_with_pool(arena, ARENA_SIZE);
+    void *ptr[SLOTS] = { 0 };
+    size_t len[SLOTS] = { 0 };
+
+    EXPECT(t != NULL);
+
+    for (uint32_t round = 0; round < 20000; round++) {
+        uint32_t i = test_rand() % SLOTS;
+
+        if (ptr[i]) {
+            // the fill pattern catches blocks that were handed out twice
+            EXPECT(memcmp_const(ptr[i], (uint8_t)i, len[i]) == 0);
+            tlsf_free(t, ptr[i]);
+            ptr[i] = NULL;
+        } else {
+            len[i] = 1 + test_rand() % 2048;
+            ptr[i] = tlsf_malloc(t, len[i]);
+            EXPECT(ptr[i] != NULL);
+            if (!ptr[i]) continue;
+            EXPECT_EQ((uintptr_t)ptr[i] % tlsf_align_size(), 0);
+            EXPECT(tlsf_block_size(ptr[i]) >= len[i]);
+            memset(ptr[i], (uint8_t)i, len[i]);
+        }
+    }
+    EXPECT_EQ(tlsf_check(t), 0);
+
+    for (uint32_t i = 0; i < SLOTS; i++) tlsf_free(t, ptr[i]);
+    EXPECT_EQ(tlsf_check(t), 0);
+
+    // with everything freed the pool must have coalesced back into one block
+    void *all = tlsf_malloc(t, ARENA_SIZE / 2);
+    EXPECT(all != NULL);
+    tlsf_free(t, all);
+}
+
+TEST(tlsf, memalign_realloc) {
+    tlsf_t t = tlsf_create_with_pool(arena, ARENA_SIZE);
+
+    for (size_t align = 8; align <= 4096; align <<= 1) {
+        void *p = tlsf_memalign(t, align, 100);
+        EXPECT(p != NULL);
+        EXPECT_EQ((uintptr_t)p % align, 0);
+        tlsf_free(t, p);
+    }
+
+    uint8_t *p = tlsf_malloc(t, 64);
+    for (int i = 0; i < 64; i++) p[i] = (uint8_t)i;
+    p = tlsf_realloc(t, p, 100000);
+    EXPECT(p != NULL);
+    for (int i = 0; i < 64; i++) EXPECT_EQ(p[i], i);
+    tlsf_free(t, p);
+
+    EXPECT(tlsf_malloc(t, ARENA_SIZE * 2) == NULL);
+    EXPECT_EQ(tlsf_check(t), 0);
+}
+
+// random malloc/free mix over SLOTS live pointers with sizes in [min, max]
+static void bench_mix(const char *metric, size_t min, size_t max, uint64_t ops) {
+    tlsf_t t = tlsf_create_with_pool(arena, ARENA_SIZE);
+    static void *ptr[SLOTS];
+    uint32_t *slot = malloc(ops * sizeof(uint32_t));
+    uint32_t *size = malloc(ops * sizeof(uint32_t));
+
+    memset(ptr, 0, sizeof(ptr));
+    // draw the random numbers up front so the timed loop is only the allocator
+    for (uint64_t i = 0; i < ops; i++) {
+        slot[i] = test_rand() % SLOTS;
+        size[i] = min + test_rand() % (max - min + 1);
+    }
+
+    uint64_t start = bench_now_ns();
+    for (uint64_t i = 0; i < ops; i++) {
+        uint32_t s = slot[i];
+        if (ptr[s]) {
+            tlsf_free(t, ptr[s]);
+            ptr[s] = NULL;
+        } else {
+            ptr[s] = tlsf_malloc(t, size[i]);
+        }
+    }
+    bench_record(metric, ops, bench_now_ns() - start, 0);
+
+    free(slot);
+    free(size);
+}
+
+BENCH(tlsf, malloc_free_mix) {
+    bench_mix("mix_small_16_128", 16, 128, 200000);
+    bench_mix("mix_medium_128_2048", 128, 2048, 200000);
+    bench_mix("mix_large_2k_32k", 2048, 32768, 100000);
+}
+
+BENCH(tlsf, lifo_pairs) {
+    tlsf_t t = tlsf_create_with_pool(arena, ARENA_SIZE);
+    uint64_t iters = 500000;
+
+    uint64_t start = bench_now_ns();
+    for (uint64_t i = 0; i < iters; i++) {
+        void *p = tlsf_malloc(t, 64);
+        BENCH_KEEP(p);
+        tlsf_free(t, p);
+    }
+    bench_record("malloc_free_64_pair", iters, bench_now_ns() - start, 0);
+}
@@ -0,0 +1,147 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: test_vdso.c
+    Description: vDSO time page tests for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "tests/includes/harness.h"
+#include "user/lib/includes/time.h"
+
+// the host kernel shares the x86_64 numbers for SYS_clock_gettime and
+// SYS_gettimeofday, so the fallback path runs a real syscall here
+
+static vdso_time_t page;
+
+// 1 ns per TSC tick makes the expected values easy to bound
+static void page_fill_tsc(uint64_t mono_base, uint64_t realtime_offset) {
+    memset(&page, 0, sizeof(page));
+    page.version = VDSO_TIME_VERSION;
+    page.clock_mode = VDSO_CLOCK_TSC;
+    page.mult = 1ull << 20;
+    page.shift = 20;
+    page.tsc_base = vdso_rdtsc();
+    page.mono_base_ns = mono_base;
+    page.realtime_offset_ns = realtime_offset;
+}
+
+static uint64_t ts_ns(const struct timespec *ts) {
+    return (uint64_t)ts->tv_sec * 1000000000 + ts->tv_nsec;
+}
+
+TEST(vdso, monotonic_follows_the_tsc) {
+    struct timespec ts;
+    page_fill_tsc(7000000000ull, 0);
+
+    uint64_t before = vdso_rdtsc() - page.tsc_base;
+    EXPECT_EQ(vdso_clock_gettime(&page, CLOCK_MONOTONIC, &ts), 0);
+    uint64_t after = vdso_rdtsc() - page.tsc_base;
+
+    uint64_t ns = ts_ns(&ts);
+    EXPECT(ns >= page.mono_base_ns + before);
+    EXPECT(ns <= page.mono_base_ns + after);
+    EXPECT(ts.tv_nsec < 1000000000);
+    EXPECT(ts.tv_sec >= 7);
+}
+
+TEST(vdso, realtime_adds_the_offset) {
+    struct timespec mono, real;
+    struct timeval tv;
+    uint64_t offset = 1760000000ull * 1000000000ull;
+    page_fill_tsc(0, offset);
+
+    EXPECT_EQ(vdso_clock_gettime(&page, CLOCK_MONOTONIC, &mono), 0);
+    EXPECT_EQ(vdso_clock_gettime(&page, CLOCK_REALTIME, &real), 0);
+    EXPECT_EQ(vdso_gettimeofday(&page, &tv), 0);
+
+    EXPECT(ts_ns(&real) - ts_ns(&mono) >= offset);
+    EXPECT(ts_ns(&real) - ts_ns(&mono) < offset + 1000000000ull);
+    EXPECT(tv.tv_sec >= real.tv_sec);
+    EXPECT(tv.tv_usec < 1000000);
+}
+
+TEST(vdso, mult_and_shift_scale_ticks) {
+    uint64_t ns = 0;
+    memset(&page, 0, sizeof(page));
+    page.clock_mode = VDSO_CLOCK_TSC;
+    page.shift = 32;
+    page.mult = 1ull << 30;             // 0.25 ns per tick
+    page.tsc_base = vdso_rdtsc() - 4000000000ull;
+
+    EXPECT(vdso_read_ns(&page, &ns, NULL));
+    EXPECT(ns >= 1000000000ull);
+    EXPECT(ns < 2000000000ull);         // the next few cycles cannot add a second
+}
+
+TEST(vdso, no_clock_falls_back_to_the_syscall) {
+    struct timespec ts;
+    uint64_t ns = 0;
+    memset(&page, 0, sizeof(page));
+    page.clock_mode = VDSO_CLOCK_NONE;
+
+    EXPECT(!vdso_read_ns(&page, &ns, NULL));
+    uint64_t before = host_clock_ns();
+    EXPECT_EQ(vdso_clock_gettime(&page, CLOCK_MONOTONIC, &ts), 0);
+    uint64_t after = host_clock_ns();
+    EXPECT(ts_ns(&ts) >= before);
+    EXPECT(ts_ns(&ts) <= after);
+}
+
+TEST(vdso, rejects_unknown_clocks) {
+    struct timespec ts;
+    page_fill_tsc(0, 0);
+    EXPECT_EQ(vdso_clock_gettime(&page, 42, &ts), -1);
+}
+
+BENCH(vdso, clock_gettime_page_vs_syscall) {
+    enum { N = 200000 };
+    struct timespec ts;
+    uint64_t start;
+
+    page_fill_tsc(0, 0);
+    start = bench_now_ns();
+    for (size_t i = 0; i < N; i++) {
+        vdso_clock_gettime(&page, CLOCK_MONOTONIC, &ts);
+        BENCH_KEEP(ts.tv_nsec);
+    }
+    bench_record("clock_gettime_vdso", N, bench_now_ns() - start, 0);
+
+    page.clock_mode = VDSO_CLOCK_NONE;
+    start = bench_now_ns();
+    for (size_t i = 0; i < N; i++) {
+        vdso_clock_gettime(&page, CLOCK_MONOTONIC, &ts);
+        BENCH_KEEP(ts.tv_nsec);
+    }
+    bench_record("clock_gettime_syscall", N, bench_now_ns() - start, 0);
+}
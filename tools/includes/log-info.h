@@ -93,7 +93,8 @@ static inline const char* get_status_color(result_t status) {
     }
 }
 
-void log_to_terminal(result_t status, const char *from, const char *file, int line, const char *fmt, ...);
+void log_to_terminal(result_t status, const char *from, const char *file, int line, const char *fmt, ...)
+    __attribute__((format(printf, 5, 6)));
 
 #define LOG_INFO(fmt, ...)  log_to_terminal(Info, __func__, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
 #define LOG_WARN(fmt, ...)  log_to_terminal(Warn, __func__, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
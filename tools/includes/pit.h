@@ -46,6 +46,8 @@
 #include "math.h"
 
 #define PIT_CHANNEL0_PORT 0x40
+#define PIT_CHANNEL2_PORT 0x42
+#define PIT_GATE_PORT     0x61      // bit 0 gates channel 2, bit 1 drives the speaker
 #define PIT_CMD_PORT      0x43
 #define PIT_FREQ          1193182u  // PIT input frequency in Hz
 
@@ -55,4 +57,9 @@ void pit_delay_us_limited(uint32_t micros);
 void pit_delay_us(uint32_t micros);
 uint8_t pit_get_is_legit();
 
+// channel 2 as a free running 16-bit down counter, left alone by the delays
+// and calibration on channel 0
+void pit_channel2_start(void);
+uint16_t pit_read_channel2(void);
+
 #endif // PIT_H
\ No newline at end of file
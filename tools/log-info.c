@@ -44,64 +44,21 @@ const char* result_str[ResultCount] = {
     [Fatal] = "FATAL: ",
 };
 
-static inline char* strcpy_advance(char *dest, const char *src) {
-    while (*src) *dest++ = *src++;
-    return dest;
-}
-
 void log_to_terminal(result_t status, const char *from, const char *file, int line, const char *fmt, ...) {
-    __attribute__((format(printf, 5, 6))); // <<<vvv this too!
     if (!global_flanterm) return;
     if (!from) from = "<unknown>";  //added these so the kernel doesnt eat shit if this fails
     if (!file) file = "<unknown>";
     if (!fmt) return;  
 
     char message[1024];
-    char *ptr = message;
+    size_t len;
     
     // get timestamp
-    uint64_t ms = get_time_ms();
+    uint64_t ms = ktime_ns() / 1000000;
     uint32_t secs = ms / 1000;
     uint32_t msecs = ms % 1000;
     
-    *ptr++ = '[';
-    if (secs < 10) { *ptr++ = ' '; *ptr++ = ' '; }
-    else if (secs < 100) { *ptr++ = ' '; }
-    
-    char sec_str[16];
-    itoa(secs, sec_str, 10);
-    ptr = strcpy_advance(ptr, sec_str);
-    
-    *ptr++ = '.';
-    if (msecs < 100) *ptr++ = '0';
-    if (msecs < 10) *ptr++ = '0';
-    
-    char ms_str[16];
-    itoa(msecs, ms_str, 10);
-    ptr = strcpy_advance(ptr, ms_str);
-    
-    *ptr++ = ']';
-    *ptr++ = ' ';
-    
-    const char *color = get_status_color(status);
-    ptr = strcpy_advance(ptr, color);
-    
-    // add status prefix (WARN: or FATAL:)
-    const char *status_str = result_str[status];
-    ptr = strcpy_advance(ptr, status_str);
-    
-    // reset color after status prefix if it was colored
-    if (status != Info) {
-        ptr = strcpy_advance(ptr, COLOR_RESET);
-    }
-    
-    ptr = strcpy_advance(ptr, COLOR_DIM);
-    *ptr++ = '[';
-    ptr = strcpy_advance(ptr, from);
-    ptr = strcpy_advance(ptr, " in ");
-    
     // extract just the filename from the full path
-    const char *filename = file;
     const char *last_slash = file;
     while (*file) {
         if (*file == '/' || *file == '\\') {
@@ -109,65 +66,23 @@ void log_to_terminal(result_t status, const char *from, const char *file, int li
         }
         file++;
     }
-    ptr = strcpy_advance(ptr, last_slash);
-    
-    *ptr++ = ':';
-    
-    // add line number
-    char line_str[16];
-    itoa(line, line_str, 10);
-    ptr = strcpy_advance(ptr, line_str);
-    
-    *ptr++ = ']';
-    ptr = strcpy_advance(ptr, COLOR_RESET);
-    *ptr++ = ' ';
+
+    // header: [  s.mmm] <color>PREFIX: <reset><dim>[func in file:line]<reset>
+    len = snprintf(message, sizeof(message), "[%3u.%03u] %s%s%s" COLOR_DIM "[%s in %s:%d]" COLOR_RESET " ",
+                   secs, msecs, get_status_color(status), result_str[status],
+                   status != Info ? COLOR_RESET : "", from, last_slash, line);
+    if (len >= sizeof(message))
+        len = sizeof(message) - 1;
     
     // process the format string and arguments
     va_list args;
     va_start(args, fmt);
-    
-    while (*fmt) {
-        if (*fmt == '%') {
-            fmt++;
-            if (*fmt == 'd' || *fmt == 'i') {
-                int val = va_arg(args, int);
-                char num[16];
-                itoa(val, num, 10);
-                ptr = strcpy_advance(ptr, num);
-            } else if (*fmt == 'u') {
-                unsigned int val = va_arg(args, unsigned int);
-                char num[16];
-                itoa((int)val, num, 10);
-                ptr = strcpy_advance(ptr, num);
-            } else if (*fmt == 's') {
-                char *str = va_arg(args, char*);
-                if (str) {
-                    ptr = strcpy_advance(ptr, str);
-                }
-            } else if (*fmt == 'p' || *fmt == 'x') {
-                unsigned long val = va_arg(args, unsigned long);
-                *ptr++ = '0';
-                *ptr++ = 'x';
-                char hex[20];
-                itoa((int)val, hex, 16);
-                ptr = strcpy_advance(ptr, hex);
-            } else if (*fmt == '%') {
-                *ptr++ = '%';
-            } else {
-                // unknown format specifier, just copy it
-                *ptr++ = '%';
-                *ptr++ = *fmt;
-            }
-        } else {
-            *ptr++ = *fmt;
-        }
-        if (*fmt) fmt++;
-    }
-    
+    len += vsnprintf(message + len, sizeof(message) - len, fmt, args);
     va_end(args);
-    *ptr = '\0';
+    if (len >= sizeof(message))
+        len = sizeof(message) - 1;
     
-    flanterm_write(global_flanterm, message, ptr - message);
+    flanterm_write(global_flanterm, message, len);
 }
 
 void printcol(const char *color, const char *text) {
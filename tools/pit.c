@@ -54,6 +54,21 @@ uint16_t pit_read_counter() {
     return ((uint16_t)hi << 8) | lo;
 }
 
+void pit_channel2_start(void) {
+    outb(PIT_GATE_PORT, (inb(PIT_GATE_PORT) & ~0x02) | 0x01);  // gate on, speaker off
+    outb(PIT_CMD_PORT, 0xB4);       // channel 2, lo/hi, mode 2 (rate generator)
+    outb(PIT_CHANNEL2_PORT, 0);     // reload of 0 means 65536
+    outb(PIT_CHANNEL2_PORT, 0);
+}
+
+uint16_t pit_read_channel2(void) {
+    uint8_t lo, hi;
+    outb(PIT_CMD_PORT, 0x80);      // latch counter 2
+    lo = inb(PIT_CHANNEL2_PORT);
+    hi = inb(PIT_CHANNEL2_PORT);
+    return ((uint16_t)hi << 8) | lo;
+}
+
 // Initialize PIT channel 0 in one-shot mode with a reload value
 void pit_start_one_shot(uint16_t reload) {
     outb(PIT_CMD_PORT, 0x34);       // channel 0, lo/hi, mode 2 (one-shot)
@@ -12,6 +12,11 @@
 #define SERIAL_COM1  0x3F8          // COM1
 
 
+// 16550A and later have a 16 byte transmit FIFO, the original 8250 has none
+#define SERIAL_FIFO_SIZE 16
+
+static size_t serial_tx_burst = 1;
+
 void serial_init(void) {
     outb(SERIAL_COM1 + 1, 0x00);    // disable interrupts
     outb(SERIAL_COM1 + 3, 0x80);    // enable DLAB
@@ -20,6 +25,9 @@ void serial_init(void) {
     outb(SERIAL_COM1 + 3, 0x03);    
     outb(SERIAL_COM1 + 2, 0xC7);    // enable FIFO
     outb(SERIAL_COM1 + 4, 0x0B);    // IRQs enabled, RTS/DSR set
+
+    // IIR bits 6-7 both read back as 1 only if the FIFO really got enabled
+    serial_tx_burst = ((inb(SERIAL_COM1 + 2) & 0xC0) == 0xC0) ? SERIAL_FIFO_SIZE : 1;
 }
 
 // wait for transmitter to be empty
@@ -32,161 +40,42 @@ void putc(char c) {
     outb(SERIAL_COM1, (uint8_t)c);
 }
 
-void serial_write(const char *msg) {
-    for (size_t i = 0; i < strlen(msg); i++) {
-        if (msg[i] == '\n') putc('\r');
-        putc(msg[i]);
-    }
-}
-
-// Made by Yazin Tantawi
-static void serial_print_hex(uint64_t num, int width) {
-    char hex[] = "0123456789abcdef";
-    char buffer[17]; // max 16 hex digits + null
-    int i = 0;
-    
-    if (num == 0) {
-        putc('0');
-        return;
-    }
-    
-    while (num > 0 && i < 16) {
-        buffer[i++] = hex[num & 0xF];
-        num >>= 4;
-    }
-    
-    while (i < width) {
-        buffer[i++] = '0';
-    }
-    
-    while (i > 0) {
-        putc(buffer[--i]);
+// Push n bytes out, turning \n into \r\n. THRE means the whole FIFO drained,
+// so we only poll the line status register once per FIFO-full of bytes.
+static void serial_sink(void *ctx, const char *s, size_t n) {
+    (void)ctx;
+    size_t room = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        size_t need = (s[i] == '\n') ? 2 : 1;
+        if (room < need) {
+            serial_wait_tx();
+            room = serial_tx_burst;
+        }
+        if (s[i] == '\n') {
+            outb(SERIAL_COM1, '\r');
+            room--;
+            if (!room) {
+                serial_wait_tx();
+                room = serial_tx_burst;
+            }
+        }
+        outb(SERIAL_COM1, (uint8_t)s[i]);
+        room--;
     }
 }
 
-
-static void serial_print_dec(int64_t num) {
-    if (num < 0) {
-        putc('-');
-        num = -num;
-    }
-    
-    if (num == 0) {
-        putc('0');
-        return;
-    }
-    
-    char buffer[20];
-    int i = 0;
-    
-    while (num > 0) {
-        buffer[i++] = '0' + (num % 10);
-        num /= 10;
-    }
-    
-    while (i > 0) {
-        putc(buffer[--i]);
-    }
+void serial_write(const char *msg) {
+    serial_sink(NULL, msg, strlen(msg));
 }
 
-
 void serial_printf(const char *fmt, ...) {
     va_list args;
     va_start(args, fmt);
-    
-    for (const char *p = fmt; *p; p++) {
-        if (*p == '%' && *(p + 1)) {
-            p++;
-            
-            // handle length modifiers: l, ll, L
-            int is_long = 0;
-            int is_longlong = 0;
-            if (*p == 'l') {
-                p++;
-                if (*p == 'l') {
-                    is_longlong = 1;
-                    p++;
-                } else {
-                    is_long = 1;
-                }
-            } else if (*p == 'L') {
-                is_longlong = 1;
-                p++;
-            }
-            
-            switch (*p) {
-                case 'd':  
-                case 'i':
-                    serial_print_dec(va_arg(args, int));
-                    break;
-                    
-                case 'u':  
-                    serial_print_dec(va_arg(args, unsigned int));
-                    break;
-                    
-                case 'x': 
-                    if (is_longlong) {
-                        uint64_t val = va_arg(args, uint64_t);
-                        serial_write("0x");
-                        serial_print_hex(val, 16);
-                    } else if (is_long) {
-                        long val = va_arg(args, long);
-                        if (val != 0) serial_write("0x");
-                        serial_print_hex((uint64_t)val, 16);
-                    } else {
-                        unsigned int val = va_arg(args, unsigned int);
-                        if (val != 0) serial_write("0x");
-                        serial_print_hex(val, 0);
-                    }
-                    break;
-                    
-                case 'X': 
-                    if (is_longlong) {
-                        uint64_t val = va_arg(args, uint64_t);                        
-                        serial_write("0x");                        
-                        serial_print_hex(val, 16);
-                    } else if (is_long) {
-                        long val = va_arg(args, long);
-                        serial_print_hex((uint64_t)val, 16);
-                    } else {
-                        unsigned int val = va_arg(args, unsigned int);
-                        serial_print_hex(val, 0);
-                    }
-                    break;
-                    
-                case 'p':  
-                    serial_write("0x");
-                    serial_print_hex(va_arg(args, uint64_t), 0);
-                    break;
-                    
-                case 's': 
-                    serial_write(va_arg(args, const char*));
-                    break;
-                    
-                case 'c': 
-                    putc((char)va_arg(args, int));
-                    break;
-                    
-                case '%': 
-                    putc('%');
-                    break;
-                    
-                default:
-                    putc('%');
-                    putc(*p);
-                    break;
-            }
-        } else {
-            if (*p == '\n') putc('\r');
-            putc(*p);
-        }
-    }
-    
+    vcbprintf(serial_sink, NULL, fmt, args);
     va_end(args);
 }
 
-//End code attribution
-
 
 static char buf[1024];
 
@@ -197,8 +86,10 @@ int printk(const char *fmt, ...)
     int i;
 
     va_start(args, fmt);
-    i = vsprintf(buf, fmt, args);
+    i = vsnprintf(buf, sizeof(buf), fmt, args);
     va_end(args);
+    if (i >= (int)sizeof(buf))
+        i = sizeof(buf) - 1;
     
     #ifdef HAVE_TTY_WRITE
     tty_write(0, buf, i);
@@ -207,4 +98,4 @@ int printk(const char *fmt, ...)
     #endif
     
     return i;
-}
\ No newline at end of file
+}
@@ -0,0 +1,85 @@
+/*
+    Copyright (C) 2026 Aspen Software Foundation
+
+    Module: time.c
+    Description: User-space clock functions for the VNiX Operating System.
+    Author: Aspen Software Foundation
+
+    All components of the VNiX Operating System, except where otherwise noted, 
+    are copyright of the Aspen Software Foundation (and the corresponding author(s)) and licensed under GPLv2 or later.
+    For more information on the Gnu Public License Version 2, please refer to the LICENSE file
+    or to the link provided here: https://www.gnu.org/licenses/old-licenses/gpl-2.0.en.html
+
+ * THIS OPERATING SYSTEM IS PROVIDED "AS IS" AND "AS AVAILABLE" UNDER 
+ * THE GNU GENERAL PUBLIC LICENSE VERSION 2, WITHOUT
+ * WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, TITLE, AND NON-INFRINGEMENT.
+ * 
+ * TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL
+ * THE AUTHORS, COPYRIGHT HOLDERS, OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE), ARISING IN ANY WAY OUT OF THE USE OF THIS OPERATING SYSTEM,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * THE ENTIRE RISK AS TO THE QUALITY AND PERFORMANCE OF THE OPERATING SYSTEM IS
+ * WITH YOU. SHOULD THE OPERATING SYSTEM PROVE DEFECTIVE, YOU ASSUME THE COST OF
+ * ALL NECESSARY SERVICING, REPAIR, OR CORRECTION.
+ *
+ * YOU SHOULD HAVE RECEIVED A COPY OF THE GNU GENERAL PUBLIC LICENSE
+ * ALONG WITH THIS OPERATING SYSTEM; IF NOT, WRITE TO THE FREE SOFTWARE
+ * FOUNDATION, INC., 51 FRANKLIN STREET, FIFTH FLOOR, BOSTON,
+ * MA 02110-1301, USA.
+*/
+
+#include "includes/time.h"
+#include "kernel/system/includes/syscalls.h"
+
+static inline int64_t time_syscall2(int64_t n, int64_t a, int64_t b) {
+    int64_t ret;
+    __asm__ volatile("syscall"
+                     : "=a"(ret)
+                     : "a"(n), "D"(a), "S"(b)
+                     : "rcx", "r11", "memory");
+    return ret;
+}
+
+int vdso_clock_gettime(const volatile vdso_time_t *vt, clockid_t clock_id, struct timespec *ts) {
+    uint64_t ns, offset;
+
+    if (clock_id != CLOCK_MONOTONIC && clock_id != CLOCK_REALTIME)
+        return -1;
+    if (!vdso_read_ns(vt, &ns, &offset))
+        return time_syscall2(SYS_clock_gettime, clock_id, (int64_t)ts) == 0 ? 0 : -1;
+
+    if (clock_id == CLOCK_REALTIME)
+        ns += offset;
+    ts->tv_sec = ns / 1000000000;
+    ts->tv_nsec = ns % 1000000000;
+    return 0;
+}
+
+int vdso_gettimeofday(const volatile vdso_time_t *vt, struct timeval *tv) {
+    uint64_t ns, offset;
+
+    if (!vdso_read_ns(vt, &ns, &offset))
+        return time_syscall2(SYS_gettimeofday, (int64_t)tv, 0) == 0 ? 0 : -1;
+
+    ns += offset;
+    tv->tv_sec = ns / 1000000000;
+    tv->tv_usec = (ns % 1000000000) / 1000;
+    return 0;
+}
+
+int clock_gettime(clockid_t clock_id, struct timespec *ts) {
+    return vdso_clock_gettime((const volatile vdso_time_t *)VDSO_TIME_ADDR, clock_id, ts);
+}
+
+int gettimeofday(struct timeval *tv, void *tz) {
+    (void)tz;
+    return vdso_gettimeofday((const volatile vdso_time_t *)VDSO_TIME_ADDR, tv);
+}